@@ -0,0 +1,785 @@
+/*
+Copyright (C) 2015 Matthew Meno
+
+This file is part of ATmega A7105.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+(1) Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer. 
+
+(2) Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in
+the documentation and/or other materials provided with the
+distribution.  
+
+(3)The name of the author may not be used to
+endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <a7105.h>
+#include "a7105_emulator.h"
+
+//Emulated radios, pin change callbacks and the virtual clock
+struct A7105_Emu* _A7105_EMU_RADIOS[A7105_EMU_MAX_RADIOS];
+byte _A7105_EMU_NUM_RADIOS = 0;
+
+struct _A7105_Emu_Pin_Callback
+{
+  int pin;
+  void (*callback)();
+  byte pending;
+};
+struct _A7105_Emu_Pin_Callback _A7105_EMU_CALLBACKS[A7105_EMU_MAX_PINS];
+
+uint64_t _A7105_EMU_NOW_NS = 0;
+int _A7105_EMU_RANGE = 0; //0 for everyone hears everyone (see A7105_Emu_Set_Range())
+byte _A7105_EMU_INTERRUPTS = true; //false between noInterrupts() and interrupts()
+byte _A7105_EMU_IN_ISR = false;
+byte _A7105_EMU_IN_ADVANCE = false; //stops packet delivery from recursing through an ISR's micros()
+int _A7105_EMU_INTERRUPT_PIN = -1; //pin of the callback being run
+uint32_t _A7105_EMU_SPI_CLOCK = A7105_SPI_CLOCK;
+unsigned long _A7105_EMU_NOISE = 1; //xorshift state for A7105_HAL_Noise()
+
+/*
+  Internal use only, 32-bit xorshift (the same sequence on every host so
+  runs with the same seed repeat).
+*/
+static unsigned long _A7105_Emu_Xorshift(unsigned long* state)
+{
+  uint32_t x = (uint32_t)*state;
+  if (x == 0)
+    x = 1;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return x;
+}
+
+static struct A7105_Emu* _A7105_Emu_Find_CS(int pin)
+{
+  for (byte x = 0; x < _A7105_EMU_NUM_RADIOS; x++)
+    if (_A7105_EMU_RADIOS[x]->cs_pin == pin)
+      return _A7105_EMU_RADIOS[x];
+  return NULL;
+}
+
+static struct A7105_Emu* _A7105_Emu_Find_WTR(int pin)
+{
+  for (byte x = 0; x < _A7105_EMU_NUM_RADIOS; x++)
+    if (_A7105_EMU_RADIOS[x]->wtr_pin == pin)
+      return _A7105_EMU_RADIOS[x];
+  return NULL;
+}
+
+static struct A7105_Emu* _A7105_Emu_Selected()
+{
+  for (byte x = 0; x < _A7105_EMU_NUM_RADIOS; x++)
+    if (_A7105_EMU_RADIOS[x]->selected)
+      return _A7105_EMU_RADIOS[x];
+  return NULL;
+}
+
+/*
+  Internal use only, runs the pin change callbacks that are waiting (unless
+  interrupts are off or we're already in one, like the AVR would).
+*/
+static void _A7105_Emu_Run_Interrupts()
+{
+  if (!_A7105_EMU_INTERRUPTS || _A7105_EMU_IN_ISR)
+    return;
+
+  for (byte x = 0; x < A7105_EMU_MAX_PINS; x++)
+  {
+    struct _A7105_Emu_Pin_Callback* cb = &(_A7105_EMU_CALLBACKS[x]);
+    if (!cb->pending)
+      continue;
+
+    cb->pending = false;
+    if (cb->callback == NULL)
+      continue;
+
+    _A7105_EMU_IN_ISR = true;
+    _A7105_EMU_INTERRUPT_PIN = cb->pin;
+    cb->callback();
+    _A7105_EMU_INTERRUPT_PIN = -1;
+    _A7105_EMU_IN_ISR = false;
+  }
+}
+
+//Flags the callback attached to 'pin' (if any) to run
+static void _A7105_Emu_Pin_Falling(int pin)
+{
+  if (pin <= 0)
+    return;
+
+  for (byte x = 0; x < A7105_EMU_MAX_PINS; x++)
+  {
+    if (_A7105_EMU_CALLBACKS[x].callback != NULL && _A7105_EMU_CALLBACKS[x].pin == pin)
+      _A7105_EMU_CALLBACKS[x].pending = true;
+  }
+}
+
+/*
+  Internal use only, works out GIO1 from its function (0Bh) and the radio state.
+  Only the functions the driver uses are modelled: WTR, TMEO (while sending) / 
+  carrier detect (while receiving a packet), everything else reads low.
+*/
+static void _A7105_Emu_Update_GIO1(struct A7105_Emu* emu)
+{
+  byte level = LOW;
+  switch (emu->regs[A7105_0B_GPIO1_PIN])
+  {
+    case A7105_GPIO_WTR:
+      level = emu->wtr;
+      break;
+    case A7105_GPIO_TMEO:
+      level = emu->tx_active || emu->rx_source != NULL;
+      break;
+  }
+
+  byte falling = (emu->gio1 && !level);
+  emu->gio1 = level;
+  if (falling && emu->three_wire)
+    _A7105_Emu_Pin_Falling(emu->gio1_pin);
+}
+
+static void _A7105_Emu_Set_WTR(struct A7105_Emu* emu, byte level)
+{
+  byte falling = (emu->wtr && !level);
+  emu->wtr = level;
+
+  if (falling)
+    _A7105_Emu_Pin_Falling(emu->wtr_pin);
+  _A7105_Emu_Update_GIO1(emu);
+}
+
+static byte _A7105_Emu_Channel(struct A7105_Emu* emu)
+{
+  return emu->regs[A7105_0F_PLL_I];
+}
+
+static byte _A7105_Emu_Same_ID(struct A7105_Emu* a, struct A7105_Emu* b)
+{
+  return memcmp(a->id, b->id, A7105_EMU_ID_BYTES) == 0;
+}
+
+static byte _A7105_Emu_In_Range(struct A7105_Emu* a, struct A7105_Emu* b)
+{
+  if (_A7105_EMU_RANGE == 0)
+    return true;
+  long dx = a->pos_x - b->pos_x;
+  long dy = a->pos_y - b->pos_y;
+  return dx * dx + dy * dy <= (long)_A7105_EMU_RANGE * _A7105_EMU_RANGE;
+}
+
+/*
+  Internal use only, the FIFO window a TX sends or an RX fills (PSA in 04h to
+  FEP in 03h, see A7105_SetFIFOSegment()).
+*/
+static byte _A7105_Emu_FIFO_Start(struct A7105_Emu* emu)
+{
+  return emu->regs[A7105_04_FIFO_II] & 0x3F;
+}
+
+static byte _A7105_Emu_FIFO_Length(struct A7105_Emu* emu)
+{
+  byte start = _A7105_Emu_FIFO_Start(emu);
+  byte end = emu->regs[A7105_03_FIFO_I] & 0x3F;
+  return (end >= start) ? (byte)(end - start + 1) : 0;
+}
+
+uint64_t A7105_Emu_Airtime_Ns(struct A7105_Emu* emu, byte len)
+{
+  //500Kbps / (DR + 1), see A7105_DataRate
+  uint64_t ns_per_bit = 2000ULL * ((uint64_t)emu->regs[A7105_0E_DATA_RATE] + 1);
+  uint64_t coded_bytes = len;
+  if (emu->regs[A7105_1F_CODE_I] & CRC_ENABLE_MASK)
+    coded_bytes += A7105_EMU_CRC_BYTES;
+
+  //FEC is a (7,4) Hamming code on the payload and CRC
+  uint64_t bits = coded_bytes * 8;
+  if (emu->regs[A7105_1F_CODE_I] & FEC_ENABLE_MASK)
+    bits = (bits * 7 + 3) / 4;
+
+  bits += (A7105_EMU_PREAMBLE_BYTES + A7105_EMU_ID_BYTES) * 8;
+  return bits * ns_per_bit;
+}
+
+//Ends a reception, good or bad (we drop back to standby like the chip does)
+static void _A7105_Emu_Finish_RX(struct A7105_Emu* emu, byte corrupted)
+{
+  struct A7105_Emu* source = emu->rx_source;
+  emu->rx_source = NULL;
+  emu->state = A7105_STANDBY;
+
+  byte len = _A7105_Emu_FIFO_Length(emu);
+  byte start = _A7105_Emu_FIFO_Start(emu);
+  byte copy = (source->tx_len < len) ? source->tx_len : len;
+  memcpy(emu->fifo + start, source->tx_data, copy);
+
+  //A length mismatch means the CRC lands in the wrong place
+  emu->crc_error = corrupted || emu->rx_corrupted || source->tx_len != len;
+  emu->stat_rx_packets++;
+  if (emu->crc_error)
+    emu->stat_rx_errors++;
+
+  _A7105_Emu_Set_WTR(emu, LOW);
+}
+
+//Ends a transmission, delivering it to everyone that was listening
+static void _A7105_Emu_Finish_TX(struct A7105_Emu* emu)
+{
+  emu->tx_active = false;
+  emu->state = A7105_STANDBY;
+  _A7105_Emu_Set_WTR(emu, LOW);
+
+  for (byte x = 0; x < _A7105_EMU_NUM_RADIOS; x++)
+  {
+    struct A7105_Emu* other = _A7105_EMU_RADIOS[x];
+    if (other->rx_source == emu)
+      _A7105_Emu_Finish_RX(other, emu->tx_corrupted);
+  }
+}
+
+static void _A7105_Emu_Start_TX(struct A7105_Emu* emu)
+{
+  byte channel = _A7105_Emu_Channel(emu);
+
+  emu->state = A7105_TX;
+  emu->tx_active = true;
+  emu->tx_corrupted = false;
+  emu->tx_channel = channel;
+  emu->tx_len = _A7105_Emu_FIFO_Length(emu);
+  memcpy(emu->tx_data, emu->fifo + _A7105_Emu_FIFO_Start(emu), emu->tx_len);
+
+  uint64_t airtime = A7105_Emu_Airtime_Ns(emu, emu->tx_len);
+  emu->tx_end_ns = _A7105_EMU_NOW_NS + airtime;
+  emu->stat_tx_packets++;
+  emu->stat_tx_airtime_ns += airtime;
+  _A7105_Emu_Set_WTR(emu, HIGH);
+
+  for (byte x = 0; x < _A7105_EMU_NUM_RADIOS; x++)
+  {
+    struct A7105_Emu* other = _A7105_EMU_RADIOS[x];
+    if (other == emu)
+      continue;
+
+    //Anyone else on the air on this channel and we both lose
+    if (other->tx_active && other->tx_channel == channel && _A7105_EMU_RANGE == 0)
+    {
+      if (!other->tx_corrupted)
+        other->stat_collisions++;
+      if (!emu->tx_corrupted)
+        emu->stat_collisions++;
+      other->tx_corrupted = true;
+      emu->tx_corrupted = true;
+    }
+
+    if (!_A7105_Emu_In_Range(emu, other))
+      continue;
+
+    //With a range, only the packets being received in range of us lose
+    if (_A7105_EMU_RANGE != 0 && other->rx_source != NULL && other->rx_source->tx_channel == channel)
+    {
+      if (!other->rx_corrupted)
+        other->rx_source->stat_collisions++;
+      other->rx_corrupted = true;
+    }
+
+    //Radios listening for our ID lock on (if they aren't already receiving something)
+    if (other->state == A7105_RX && other->rx_source == NULL &&
+        _A7105_Emu_Channel(other) == channel && _A7105_Emu_Same_ID(emu, other))
+    {
+      other->rx_source = emu;
+      other->rx_corrupted = false;
+      _A7105_Emu_Set_WTR(other, HIGH);
+    }
+  }
+
+  //(and packets we start over someone else in range of the receiver)
+  for (byte x = 0; x < _A7105_EMU_NUM_RADIOS && _A7105_EMU_RANGE != 0; x++)
+  {
+    struct A7105_Emu* other = _A7105_EMU_RADIOS[x];
+    if (other->rx_source != emu)
+      continue;
+    for (byte y = 0; y < _A7105_EMU_NUM_RADIOS; y++)
+    {
+      struct A7105_Emu* sender = _A7105_EMU_RADIOS[y];
+      if (sender != emu && sender != other && sender->tx_active && 
+          sender->tx_channel == channel && _A7105_Emu_In_Range(sender, other))
+        other->rx_corrupted = true;
+    }
+    if (other->rx_corrupted)
+      emu->stat_collisions++;
+  }
+}
+
+static void _A7105_Emu_Reset_Chip(struct A7105_Emu* emu)
+{
+  if (emu->tx_active)
+  {
+    emu->tx_corrupted = true;
+    _A7105_Emu_Finish_TX(emu);
+  }
+  if (emu->rx_source != NULL)
+    _A7105_Emu_Finish_RX(emu, true);
+
+  memset(emu->regs, 0, sizeof(emu->regs));
+  memset(emu->id, 0, sizeof(emu->id));
+  _A7105_Emu_Update_GIO1(emu);
+  emu->fifo_wptr = 0;
+  emu->fifo_rptr = 0;
+  emu->id_ptr = 0;
+  emu->crc_error = false;
+  emu->state = A7105_STANDBY;
+}
+
+static void _A7105_Emu_Strobe(struct A7105_Emu* emu, byte strobe)
+{
+  emu->stat_strobes++;
+
+  switch (strobe)
+  {
+    case A7105_RST_WRPTR:
+      emu->fifo_wptr = _A7105_Emu_FIFO_Start(emu);
+      return;
+    case A7105_RST_RDPTR:
+      emu->fifo_rptr = _A7105_Emu_FIFO_Start(emu);
+      return;
+  }
+
+  //Any mode change stops whatever we were sending/receiving
+  if (emu->tx_active && strobe != A7105_TX)
+  {
+    emu->tx_corrupted = true;
+    _A7105_Emu_Finish_TX(emu);
+  }
+  if (emu->rx_source != NULL)
+    _A7105_Emu_Finish_RX(emu, true);
+
+  if (strobe == A7105_TX)
+  {
+    //Re-strobing TX restarts the packet
+    if (emu->tx_active)
+    {
+      emu->tx_corrupted = true;
+      _A7105_Emu_Finish_TX(emu);
+    }
+    _A7105_Emu_Start_TX(emu);
+  }
+  else
+    emu->state = strobe;
+}
+
+static byte _A7105_Emu_Read_Reg(struct A7105_Emu* emu, byte addr)
+{
+  switch (addr)
+  {
+    case A7105_00_MODE:
+    {
+      byte mode = 0;
+      if (emu->state == A7105_TX || emu->state == A7105_RX)
+        mode |= 0x01; //TRER, TX/RX in progress
+      if (emu->crc_error && (emu->regs[A7105_1F_CODE_I] & CRC_ENABLE_MASK))
+        mode |= CRC_CHECK_MASK;
+      if (emu->crc_error && (emu->regs[A7105_1F_CODE_I] & FEC_ENABLE_MASK))
+        mode |= FEC_CHECK_MASK;
+      return mode;
+    }
+    case A7105_02_CALC:
+      return 0x00; //calibration finishes instantly
+    case A7105_05_FIFO_DATA:
+      return emu->fifo[(emu->fifo_rptr++) % A7105_EMU_FIFO_SIZE];
+    case A7105_06_ID_DATA:
+      return emu->id[(emu->id_ptr++) % A7105_EMU_ID_BYTES];
+    case A7105_1D_RSSI_THOLD:
+    {
+      //Only measured while listening, otherwise the last reading is held
+      if (emu->state == A7105_RX)
+      {
+        byte rssi = A7105_EMU_RSSI_NOISE;
+        for (byte x = 0; x < _A7105_EMU_NUM_RADIOS; x++)
+        {
+          struct A7105_Emu* other = _A7105_EMU_RADIOS[x];
+          if (other != emu && other->tx_active && other->tx_channel == _A7105_Emu_Channel(emu) &&
+              _A7105_Emu_In_Range(emu, other))
+            rssi = A7105_EMU_RSSI_SIGNAL;
+        }
+        emu->regs[A7105_1D_RSSI_THOLD] = rssi;
+      }
+      return emu->regs[A7105_1D_RSSI_THOLD];
+    }
+    case A7105_22_IF_CALIB_I:
+    case A7105_24_VCO_CURCAL:
+      return emu->regs[addr] & ~0x10; //never fails
+    case A7105_25_VCO_SBCAL_I:
+      return emu->regs[addr] & ~0x80;
+  }
+
+  return (addr < A7105_EMU_NUM_REGISTERS) ? emu->regs[addr] : 0x00;
+}
+
+static void _A7105_Emu_Write_Reg(struct A7105_Emu* emu, byte addr, byte data)
+{
+  switch (addr)
+  {
+    case A7105_00_MODE:
+      _A7105_Emu_Reset_Chip(emu); //any write resets the chip
+      return;
+    case A7105_05_FIFO_DATA:
+      emu->fifo[(emu->fifo_wptr++) % A7105_EMU_FIFO_SIZE] = data;
+      return;
+    case A7105_06_ID_DATA:
+      emu->id[(emu->id_ptr++) % A7105_EMU_ID_BYTES] = data;
+      return;
+  }
+
+  if (addr < A7105_EMU_NUM_REGISTERS)
+    emu->regs[addr] = data;
+  if (addr == A7105_0B_GPIO1_PIN)
+    _A7105_Emu_Update_GIO1(emu);
+}
+
+byte A7105_Emu_Add_Radio(struct A7105_Emu* emu, int cs_pin, int wtr_pin)
+{
+  if (_A7105_EMU_NUM_RADIOS == A7105_EMU_MAX_RADIOS)
+    return false;
+
+  memset(emu, 0, sizeof(struct A7105_Emu));
+  emu->cs_pin = cs_pin;
+  emu->wtr_pin = wtr_pin;
+  _A7105_Emu_Reset_Chip(emu);
+
+  _A7105_EMU_RADIOS[_A7105_EMU_NUM_RADIOS++] = emu;
+  return true;
+}
+
+void A7105_Emu_Wire_3Wire(struct A7105_Emu* emu, int gio1_pin)
+{
+  emu->three_wire = true;
+  emu->gio1_pin = gio1_pin;
+}
+
+void A7105_Emu_Set_Max_SPI_Clock(struct A7105_Emu* emu, uint32_t clock)
+{
+  emu->max_spi_clock = clock;
+}
+
+void A7105_Emu_Set_Position(struct A7105_Emu* emu, int x, int y)
+{
+  emu->pos_x = x;
+  emu->pos_y = y;
+}
+
+void A7105_Emu_Set_Range(int range)
+{
+  _A7105_EMU_RANGE = range;
+}
+
+void A7105_Emu_Reset()
+{
+  _A7105_EMU_NUM_RADIOS = 0;
+  _A7105_EMU_RANGE = 0;
+  memset(_A7105_EMU_CALLBACKS, 0, sizeof(_A7105_EMU_CALLBACKS));
+  _A7105_EMU_NOW_NS = 0;
+  _A7105_EMU_INTERRUPTS = true;
+}
+
+void A7105_Emu_Reset_Stats()
+{
+  for (byte x = 0; x < _A7105_EMU_NUM_RADIOS; x++)
+  {
+    struct A7105_Emu* emu = _A7105_EMU_RADIOS[x];
+    emu->stat_spi_transactions = 0;
+    emu->stat_spi_bytes = 0;
+    emu->stat_strobes = 0;
+    emu->stat_tx_packets = 0;
+    emu->stat_tx_airtime_ns = 0;
+    emu->stat_rx_packets = 0;
+    emu->stat_rx_errors = 0;
+    emu->stat_collisions = 0;
+  }
+}
+
+uint64_t A7105_Emu_Now_Ns()
+{
+  return _A7105_EMU_NOW_NS;
+}
+
+void A7105_Emu_Advance_Ns(uint64_t ns)
+{
+  uint64_t target = _A7105_EMU_NOW_NS + ns;
+
+  //Finish the packets that end before 'target' in order (an ISR calling
+  //micros() only moves the clock, the outer call delivers)
+  if (!_A7105_EMU_IN_ADVANCE)
+  {
+    _A7105_EMU_IN_ADVANCE = true;
+    while (true)
+    {
+      struct A7105_Emu* next = NULL;
+      for (byte x = 0; x < _A7105_EMU_NUM_RADIOS; x++)
+      {
+        struct A7105_Emu* emu = _A7105_EMU_RADIOS[x];
+        if (emu->tx_active && emu->tx_end_ns <= target &&
+            (next == NULL || emu->tx_end_ns < next->tx_end_ns))
+          next = emu;
+      }
+      if (next == NULL)
+        break;
+
+      if (next->tx_end_ns > _A7105_EMU_NOW_NS)
+        _A7105_EMU_NOW_NS = next->tx_end_ns;
+      _A7105_Emu_Finish_TX(next);
+      _A7105_Emu_Run_Interrupts();
+
+      //The ISRs may have used up time too
+      if (_A7105_EMU_NOW_NS > target)
+        target = _A7105_EMU_NOW_NS;
+    }
+    _A7105_EMU_IN_ADVANCE = false;
+  }
+
+  if (target > _A7105_EMU_NOW_NS)
+    _A7105_EMU_NOW_NS = target;
+  _A7105_Emu_Run_Interrupts();
+}
+
+void A7105_Emu_Advance_Us(unsigned long us)
+{
+  A7105_Emu_Advance_Ns((uint64_t)us * 1000);
+}
+
+void A7105_Emu_Seed(unsigned long seed)
+{
+  _A7105_EMU_NOISE = seed ? seed : 1;
+}
+
+void _A7105_Emu_Pin_Write(int pin, int level)
+{
+  struct A7105_Emu* emu = _A7105_Emu_Find_CS(pin);
+  if (emu == NULL)
+    return;
+
+  //Chip select going low starts a new command
+  if (level == LOW && !emu->selected)
+  {
+    emu->selected = true;
+    emu->command_valid = false;
+    emu->stat_spi_transactions++;
+  }
+  else if (level != LOW)
+    emu->selected = false;
+}
+
+int _A7105_Emu_Pin_Read(int pin)
+{
+  struct A7105_Emu* emu = _A7105_Emu_Find_WTR(pin);
+  if (emu != NULL)
+    return emu->wtr;
+
+  for (byte x = 0; x < _A7105_EMU_NUM_RADIOS; x++)
+    if (_A7105_EMU_RADIOS[x]->three_wire && _A7105_EMU_RADIOS[x]->gio1_pin == pin)
+      return _A7105_EMU_RADIOS[x]->gio1;
+  return LOW;
+}
+
+byte _A7105_Emu_SPI_Transfer(byte out, uint32_t clock)
+{
+  A7105_Emu_Advance_Ns(8000000000ULL / (clock ? clock : 1));
+
+  struct A7105_Emu* emu = _A7105_Emu_Selected();
+  if (emu == NULL)
+    return 0xFF; //nobody driving MISO
+
+  emu->stat_spi_bytes++;
+
+  //First byte is a strobe (bit 7) or a register address (bit 6 set to read)
+  if (!emu->command_valid)
+  {
+    emu->command_valid = true;
+    emu->command = out;
+    if (out & 0x80)
+      _A7105_Emu_Strobe(emu, out & 0xF0);
+    else if ((out & 0x3F) == A7105_06_ID_DATA)
+      emu->id_ptr = 0;
+    return 0x00;
+  }
+
+  if (emu->command & 0x80)
+    return 0x00;
+
+  //Control registers don't auto-increment, the FIFO and ID keep streaming
+  byte addr = emu->command & 0x3F;
+  if (emu->command & 0x40)
+  {
+    byte in = _A7105_Emu_Read_Reg(emu, addr);
+
+    //MISO is GIO1 in 4-wire mode, wired 3-wire it's SDIO (which the radio only
+    //drives when GIO1 isn't doing it)
+    byte four_wire = (emu->regs[A7105_0B_GPIO1_PIN] == A7105_ENABLE_4WIRE);
+    if (four_wire == emu->three_wire)
+      return 0xFF;
+
+    //Too fast for the wiring, we sample each bit a clock late
+    if (emu->max_spi_clock && clock > emu->max_spi_clock)
+      return in >> 1;
+    return in;
+  }
+
+  _A7105_Emu_Write_Reg(emu, addr, out);
+  return 0x00;
+}
+
+void _A7105_Emu_Attach_Interrupt(int pin, void (*callback)())
+{
+  byte free_slot = A7105_EMU_MAX_PINS;
+  for (byte x = 0; x < A7105_EMU_MAX_PINS; x++)
+  {
+    if (_A7105_EMU_CALLBACKS[x].callback != NULL && _A7105_EMU_CALLBACKS[x].pin == pin)
+      free_slot = x;
+    else if (free_slot == A7105_EMU_MAX_PINS && _A7105_EMU_CALLBACKS[x].callback == NULL)
+      free_slot = x;
+  }
+  if (free_slot == A7105_EMU_MAX_PINS)
+    return;
+
+  _A7105_EMU_CALLBACKS[free_slot].pin = pin;
+  _A7105_EMU_CALLBACKS[free_slot].callback = callback;
+  _A7105_EMU_CALLBACKS[free_slot].pending = false;
+}
+
+void _A7105_Emu_Detach_Interrupt(int pin)
+{
+  for (byte x = 0; x < A7105_EMU_MAX_PINS; x++)
+    if (_A7105_EMU_CALLBACKS[x].pin == pin)
+      memset(&(_A7105_EMU_CALLBACKS[x]), 0, sizeof(struct _A7105_Emu_Pin_Callback));
+}
+
+/*
+  A7105 HAL backend (A7105_HAL_EMULATOR, see a7105_hal.h)
+*/
+
+void A7105_HAL_SPI_Begin()
+{
+}
+
+void A7105_HAL_SPI_Begin_Transaction(uint32_t clock)
+{
+  _A7105_EMU_SPI_CLOCK = clock;
+}
+
+void A7105_HAL_SPI_End_Transaction()
+{
+}
+
+byte A7105_HAL_SPI_Transfer(byte out)
+{
+  return _A7105_Emu_SPI_Transfer(out, _A7105_EMU_SPI_CLOCK);
+}
+
+void A7105_HAL_SPI_Transfer_Block(const byte* tx_buffer, byte fill, byte* rx_buffer, byte len)
+{
+  for (byte i = 0; i < len; i++)
+  {
+    byte in = A7105_HAL_SPI_Transfer(tx_buffer ? tx_buffer[i] : fill);
+    if (rx_buffer)
+      rx_buffer[i] = in;
+  }
+}
+
+void A7105_HAL_Pin_Output(int pin)
+{
+  (void)pin;
+}
+
+void A7105_HAL_Pin_Input(int pin)
+{
+  (void)pin;
+}
+
+void A7105_HAL_Pin_Write(int pin, byte level)
+{
+  _A7105_Emu_Pin_Write(pin, level);
+}
+
+byte A7105_HAL_Pin_Read(int pin)
+{
+  A7105_Emu_Advance_Ns(A7105_EMU_POLL_NS);
+  return _A7105_Emu_Pin_Read(pin);
+}
+
+unsigned long A7105_HAL_Millis()
+{
+  A7105_Emu_Advance_Ns(A7105_EMU_POLL_NS);
+  return (unsigned long)(_A7105_EMU_NOW_NS / 1000000ULL);
+}
+
+unsigned long A7105_HAL_Micros()
+{
+  A7105_Emu_Advance_Ns(A7105_EMU_POLL_NS);
+  return (unsigned long)(_A7105_EMU_NOW_NS / 1000ULL);
+}
+
+void A7105_HAL_Delay_Us(unsigned long us)
+{
+  A7105_Emu_Advance_Us(us);
+}
+
+void A7105_HAL_Yield()
+{
+  A7105_Emu_Advance_Ns(A7105_EMU_POLL_NS);
+}
+
+void A7105_HAL_Attach_Falling(int pin, void (*callback)())
+{
+  _A7105_Emu_Attach_Interrupt(pin, callback);
+}
+
+void A7105_HAL_Detach(int pin)
+{
+  _A7105_Emu_Detach_Interrupt(pin);
+}
+
+int A7105_HAL_Interrupt_Pin()
+{
+  return _A7105_EMU_INTERRUPT_PIN;
+}
+
+byte A7105_HAL_Lock()
+{
+  byte state = _A7105_EMU_INTERRUPTS;
+  _A7105_EMU_INTERRUPTS = false;
+  return state;
+}
+
+void A7105_HAL_Unlock(byte state)
+{
+  _A7105_EMU_INTERRUPTS = state;
+  _A7105_Emu_Run_Interrupts();
+}
+
+int A7105_HAL_Noise()
+{
+  A7105_Emu_Advance_Us(100); //one ADC conversion
+  return (int)_A7105_Emu_Xorshift(&_A7105_EMU_NOISE);
+}
@@ -0,0 +1,231 @@
+/*
+Copyright (C) 2015 Matthew Meno
+
+This file is part of ATmega A7105.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+(1) Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer. 
+
+(2) Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in
+the documentation and/or other materials provided with the
+distribution.  
+
+(3)The name of the author may not be used to
+endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _A7105_EMULATOR_H_
+#define _A7105_EMULATOR_H_
+
+#include <stdint.h>
+#include <a7105_hal.h>
+
+/*
+  Host-native A7105 emulator.
+
+  This is a HAL backend (build with A7105_HAL_EMULATOR, see a7105_hal.h) that
+  stands in for the radios so the a7105 and a7105_mesh code can be compiled and
+  run on Linux. Each emulated radio has the register map, strobe states, FIFO 
+  pointers, ID and CRC/FEC flags of an A7105 behind a virtual SPI bus: chip 
+  select pins written through the HAL select a radio, SPI transfers talk to 
+  whichever radio is selected and the WTR pin of each radio raises the callback
+  the driver attached to it.
+
+  Everything runs on a virtual clock (see A7105_Emu_Now_Ns()). SPI bytes cost
+  their time at the clock passed to A7105_HAL_SPI_Begin_Transaction(), delays
+  jump ahead and every clock read, pin read or yield costs A7105_EMU_POLL_NS so
+  busy-wait loops make progress. Packets take their real
+  airtime (preamble, ID, payload, CRC and FEC expansion at the data rate in 0Eh)
+  so the counters below can be used for repeatable airtime, SPI transaction and
+  latency benchmarks.
+
+  Modelling notes/limits:
+    * All radios share one "air". A radio in RX on the same channel (0Fh) with
+      the same ID hears a packet if it was listening when the packet started.
+      Packets that overlap on a channel are corrupted (CRC/FEC flags set), there
+      is no capture effect or path loss.
+    * Unless A7105_Emu_Set_Range() is used: then radios only hear (and sense) the
+      ones within range, and a packet is only corrupted for the receivers that
+      are in range of something else sending over it (hidden nodes collide).
+    * WTR (whatever GIO2 is set to) goes high while sending, or once a packet's
+      ID is matched in RX, and falls when the packet is done. Leaving TX/RX early
+      drops it too (and flags the packet as bad).
+    * Radios are wired for 4-wire SPI (MISO on GIO1) unless A7105_Emu_Wire_3Wire()
+      is used. Reads only come back if 0Bh matches the wiring. GIO1 can be WTR or
+      TMEO/carrier detect (high while sending or receiving a packet).
+    * SPI works at any clock unless A7105_Emu_Set_Max_SPI_Clock() says otherwise.
+    * RSSI (1Dh) reads A7105_EMU_RSSI_SIGNAL while anyone is sending on the 
+      channel and A7105_EMU_RSSI_NOISE otherwise (lower is stronger, like the chip).
+    * Auto-calibration finishes instantly and never fails. PLL/TX settling times,
+      FIFO extension mode (FPF on GIO2) and direct mode aren't emulated.
+    * All nodes share one CPU, callers should charge their own processing time 
+      with A7105_Emu_Advance_Us().
+*/
+
+//Most radios the emulator can host at once
+#define A7105_EMU_MAX_RADIOS 32
+#define A7105_EMU_MAX_PINS (2*A7105_EMU_MAX_RADIOS) //pin change callbacks (WTR and GIO1 for each radio)
+
+//Virtual time each millis()/micros() call costs (so polling loops terminate)
+#define A7105_EMU_POLL_NS 1000
+
+//RSSI readings (1Dh) with and without a signal on the channel
+#define A7105_EMU_RSSI_SIGNAL 0x30
+#define A7105_EMU_RSSI_NOISE 0x90
+
+//On-air framing (4 byte preamble, 4 byte ID, 2 byte CRC if enabled)
+#define A7105_EMU_PREAMBLE_BYTES 4
+#define A7105_EMU_ID_BYTES 4
+#define A7105_EMU_CRC_BYTES 2
+
+#define A7105_EMU_NUM_REGISTERS 0x33
+#define A7105_EMU_FIFO_SIZE 64
+
+struct A7105_Emu
+{
+  int cs_pin;
+  int wtr_pin;
+  int gio1_pin; //only wired up with 3-wire SPI (see A7105_Emu_Wire_3Wire())
+  byte three_wire;
+  uint32_t max_spi_clock; //reads garble above this SPI clock, 0 for none (see A7105_Emu_Set_Max_SPI_Clock())
+
+  //Chip state
+  byte regs[A7105_EMU_NUM_REGISTERS];
+  byte id[A7105_EMU_ID_BYTES];
+  byte fifo[A7105_EMU_FIFO_SIZE];
+  byte fifo_wptr;
+  byte fifo_rptr;
+  byte id_ptr;
+  byte state; //A7105_State strobe value (A7105_STANDBY, A7105_RX, ...)
+  byte crc_error; //last received packet failed CRC/FEC
+  int pos_x; //where the radio is (see A7105_Emu_Set_Range())
+  int pos_y;
+  byte wtr;
+  byte gio1;
+
+  //SPI transaction in progress (command is the first byte after chip select)
+  byte selected;
+  byte command;
+  byte command_valid;
+
+  //The packet we're sending (while tx_active)
+  byte tx_active;
+  byte tx_corrupted;
+  byte tx_channel;
+  byte tx_len;
+  byte tx_data[A7105_EMU_FIFO_SIZE];
+  uint64_t tx_end_ns;
+
+  //The radio we're receiving from (NULL if we haven't locked onto a packet)
+  struct A7105_Emu* rx_source;
+  byte rx_corrupted; //someone else in range sent over it (A7105_Emu_Set_Range() only)
+
+  //Counters for benchmarks (see A7105_Emu_Reset_Stats())
+  unsigned long stat_spi_transactions; //chip select windows
+  unsigned long stat_spi_bytes; //bytes clocked, including command bytes
+  unsigned long stat_strobes;
+  unsigned long stat_tx_packets;
+  uint64_t stat_tx_airtime_ns;
+  unsigned long stat_rx_packets; //packets delivered to the FIFO (good or bad)
+  unsigned long stat_rx_errors; //delivered with the CRC/FEC flags set
+  unsigned long stat_collisions; //packets we sent that overlapped someone else's
+                                 //(with A7105_Emu_Set_Range(): receptions of ours someone else corrupted)
+};
+
+/*
+  A7105_Emu_Add_Radio:
+    * emu: The emulated radio (must stay put while the emulator runs)
+    * cs_pin: The pin the driver will use as chip select for this radio
+    * wtr_pin: The pin the driver will watch for WTR (-1 if none)
+
+    Side-Effects/Notes: The radio starts out reset (all registers zero, standby).
+
+    Returns:
+      * true on success, false if A7105_EMU_MAX_RADIOS radios were already added
+*/
+byte A7105_Emu_Add_Radio(struct A7105_Emu* emu, int cs_pin, int wtr_pin);
+
+/*
+  A7105_Emu_Wire_3Wire:
+    * emu: A radio added with A7105_Emu_Add_Radio()
+    * gio1_pin: The pin GIO1 is wired to (-1 if none)
+
+    Wires 'emu' for 3-wire SPI (MISO tied to SDIO, see A7105_3WIRE_SPI in a7105.h)
+    so GIO1 is free to drive 'gio1_pin'.
+*/
+void A7105_Emu_Wire_3Wire(struct A7105_Emu* emu, int gio1_pin);
+
+/*
+  A7105_Emu_Set_Max_SPI_Clock:
+    * emu: A radio added with A7105_Emu_Add_Radio()
+    * clock: Fastest SPI clock (Hz) the wiring to 'emu' handles, 0 for no limit (the default)
+
+    Models a flaky harness for A7105_Train_SPI_Clock(): above 'clock' MISO is 
+    sampled a bit late, so every byte read comes back shifted right by one.
+*/
+void A7105_Emu_Set_Max_SPI_Clock(struct A7105_Emu* emu, uint32_t clock);
+
+/*
+  A7105_Emu_Set_Position:
+    * emu: A radio added with A7105_Emu_Add_Radio()
+    * x, y: Where it is (any units, the same ones A7105_Emu_Set_Range() uses)
+*/
+void A7105_Emu_Set_Position(struct A7105_Emu* emu, int x, int y);
+
+/*
+  A7105_Emu_Set_Range:
+    * range: How far (straight line, see A7105_Emu_Set_Position()) a radio can be 
+             heard, 0 for everyone hears everyone (the default)
+
+    Turns the shared air into a multi-hop one for exercising the mesh's repeating
+    and routing. Radios out of range of each other can't hear or carrier sense 
+    each other, so they collide at the receivers between them.
+*/
+void A7105_Emu_Set_Range(int range);
+
+//Removes every radio and pin change callback and resets the clock (for running
+//several benchmarks in one process)
+void A7105_Emu_Reset();
+
+//Zeroes the stat_* counters of every radio
+void A7105_Emu_Reset_Stats();
+
+//The virtual clock
+uint64_t A7105_Emu_Now_Ns();
+
+//Moves the virtual clock ahead (delivering packets and WTR edges that are due)
+void A7105_Emu_Advance_Ns(uint64_t ns);
+void A7105_Emu_Advance_Us(unsigned long us);
+
+//Airtime (nanoseconds) of a 'len' byte packet with 'emu's current data rate/CRC/FEC settings
+uint64_t A7105_Emu_Airtime_Ns(struct A7105_Emu* emu, byte len);
+
+//Seeds the noise A7105_HAL_Noise() returns (and so A7105_Mesh_Get_Random_Seed()) so runs repeat
+void A7105_Emu_Seed(unsigned long seed);
+
+//Internal use only, the HAL backend calls these
+void _A7105_Emu_Pin_Write(int pin, int level);
+int _A7105_Emu_Pin_Read(int pin);
+byte _A7105_Emu_SPI_Transfer(byte out, uint32_t clock);
+void _A7105_Emu_Attach_Interrupt(int pin, void (*callback)());
+void _A7105_Emu_Detach_Interrupt(int pin);
+
+#endif
@@ -0,0 +1,19 @@
+#!/bin/bash
+# Builds the host-native emulator, the mesh simulation (see a7105_emulator.h)
+# and the handled request table benchmark (handled_bench.cpp)
+# with the a7105/a7105_mesh libraries on the emulator HAL backend. Extra arguments
+# are passed to the compiler, e.g. ./build.sh -DA7105_MESH_STATS -DA7105_MESH_DISABLE_CSMA
+cd "$(dirname "$0")"
+mkdir -p build
+${CXX:-g++} -std=gnu++98 -O2 -Wall -DA7105_HAL_EMULATOR -DA7105_MAX_RADIOS=16 "$@" \
+  -I. -I../libraries/a7105 -I../libraries/a7105_mesh \
+  a7105_emulator.cpp mesh_sim.cpp \
+  ../libraries/a7105/a7105.cpp ../libraries/a7105/a7105_hal_host.cpp \
+  ../libraries/a7105_mesh/a7105_mesh.cpp \
+  -o build/mesh_sim
+${CXX:-g++} -std=gnu++98 -O2 -Wall -DA7105_HAL_EMULATOR "$@" \
+  -I. -I../libraries/a7105 -I../libraries/a7105_mesh \
+  a7105_emulator.cpp handled_bench.cpp \
+  ../libraries/a7105/a7105.cpp ../libraries/a7105/a7105_hal_host.cpp \
+  ../libraries/a7105_mesh/a7105_mesh.cpp \
+  -o build/handled_bench
@@ -0,0 +1,316 @@
+/*
+Copyright (C) 2015 Matthew Meno
+
+This file is part of ATmega A7105.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+(1) Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer. 
+
+(2) Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in
+the documentation and/or other materials provided with the
+distribution.  
+
+(3)The name of the author may not be used to
+endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <a7105.h>
+#include <a7105_mesh.h>
+#include <a7105_mesh_packet.h>
+
+/*
+  Compares the mesh's handled request table (duplicate suppression, see 
+  A7105_MESH_HANDLED_SENDERS) against the linear handled packet cache it replaced,
+  with more and more nodes sending requests to one receiver.
+
+  Each step a random sender makes a new request (next sequence number, random
+  request type). The receiver hears it with BENCH_HEAR_PCT chance, and up to
+  BENCH_REPEATS repeats of it (each with the same chance) from 1 to 
+  REPEAT_DELAY steps later (BENCH_REPEAT_DELAY, then BENCH_SLOW_REPEAT_DELAY for
+  busy requesters whose repeats come back after more of their requests). Every packet heard goes through the same calls
+  A7105_Mesh_Update() makes: expire the cache, check if it's been handled and
+  handle it if it hasn't. Two things can go wrong:
+    * False drop:      the first copy of a request we hear is taken for one we've
+                       handled (stale entry from the last time around the sequence numbers)
+    * Missed duplicate: a repeat of a request we handled is handled again (its entry
+                       was pushed out or expired early)
+
+  Usage: handled_bench [steps] [seed]
+
+  Output is one comma delimited line per structure, sender count and repeat delay:
+    NAME_SENDERS,REPEAT_DELAY,LOOKUP_NS,FALSE_DROPS_PER_10K,MISSED_DUPS_PER_10K,RAM_BYTES
+    * LINEAR8:   the old cache as it shipped (8 entries)
+    * LINEARN:   the old cache grown to one entry per sender (what notes/mesh.markdown suggested)
+    * HASHED:    the handled request table (A7105_MESH_HANDLED_SENDERS senders in this build)
+                 with v1 headers (4 bit sequence numbers)
+    * HASHED_V2: the same with v2 headers (8 bit sequence numbers)
+  LOOKUP_NS is the host time per "have we handled this?" check, it's only good for 
+  comparing the structures to each other.
+*/
+
+#define BENCH_MAX_SENDERS 255
+#define BENCH_HEAR_PCT 80
+#define BENCH_REPEATS 2
+#define BENCH_REPEAT_DELAY 6 //steps
+#define BENCH_SLOW_REPEAT_DELAY 12 //steps
+#define BENCH_LOOKUPS 1000000
+
+//////// The linear handled packet cache (as it was before the handled request table) ////////
+
+#define LINEAR_OP 0
+#define LINEAR_SEQ 1
+#define LINEAR_UNIQUE_ID 2
+#define LINEAR_SEQ_EXPIRE 3 //was A7105_MESH_HANDLED_PACKET_CACHE_SEQ_EXPIRE
+
+struct Linear_Cache
+{
+  int length;
+  byte entries[BENCH_MAX_SENDERS][4];
+  byte last_index;
+};
+
+void linear_handling(struct Linear_Cache* cache, byte* packet)
+{
+  cache->entries[cache->last_index][LINEAR_OP] = packet[A7105_MESH_PACKET_TYPE];
+  cache->entries[cache->last_index][LINEAR_SEQ] = _A7105_Mesh_Get_Packet_Seq(packet);
+  cache->entries[cache->last_index][LINEAR_UNIQUE_ID] = packet[A7105_MESH_PACKET_UNIQUE_ID];
+  cache->entries[cache->last_index][LINEAR_UNIQUE_ID+1] = packet[A7105_MESH_PACKET_UNIQUE_ID+1];
+  cache->last_index = (cache->last_index + 1) % cache->length;
+}
+
+void linear_update(struct Linear_Cache* cache, byte* packet)
+{
+  byte seq = _A7105_Mesh_Get_Packet_Seq(packet);
+  for (int x = 0; x < cache->length; x++)
+  {
+    if (cache->entries[x][LINEAR_UNIQUE_ID] == packet[A7105_MESH_PACKET_UNIQUE_ID] &&
+        cache->entries[x][LINEAR_UNIQUE_ID+1] == packet[A7105_MESH_PACKET_UNIQUE_ID+1])
+      for (int y = 1; y <= LINEAR_SEQ_EXPIRE; y++)
+        if (((seq + (byte)y) % 16) == cache->entries[x][LINEAR_SEQ])
+        {
+          memset(cache->entries[x], 0, 4);
+          break;
+        }
+  }
+}
+
+byte linear_is_handled(struct Linear_Cache* cache, byte* packet)
+{
+  byte seq = _A7105_Mesh_Get_Packet_Seq(packet);
+  for (int x = 0; x < cache->length; x++)
+  {
+    if (cache->entries[x][LINEAR_OP] == packet[A7105_MESH_PACKET_TYPE] &&
+        cache->entries[x][LINEAR_SEQ] == seq &&
+        cache->entries[x][LINEAR_UNIQUE_ID] == packet[A7105_MESH_PACKET_UNIQUE_ID] &&
+        cache->entries[x][LINEAR_UNIQUE_ID+1] == packet[A7105_MESH_PACKET_UNIQUE_ID+1])
+      return true;
+  }
+  return false;
+}
+
+//////// The structures under test ////////
+
+enum Bench_Kind { LINEAR8, LINEARN, HASHED, HASHED_V2 };
+
+struct Bench_Target
+{
+  enum Bench_Kind kind;
+  struct Linear_Cache linear;
+  struct A7105_Mesh node;
+};
+
+void target_reset(struct Bench_Target* target, enum Bench_Kind kind, int senders)
+{
+  memset(target, 0, sizeof(struct Bench_Target));
+  target->kind = kind;
+  target->linear.length = (kind == LINEAR8) ? 8 : senders;
+}
+
+byte target_is_handled(struct Bench_Target* target, byte* packet)
+{
+  if (target->kind >= HASHED)
+    return _A7105_Mesh_Is_Handled_Request(&(target->node), packet);
+  return linear_is_handled(&(target->linear), packet);
+}
+
+//What A7105_Mesh_Update() and the request handlers do with a packet, returns true if it got handled
+byte target_receive(struct Bench_Target* target, byte* packet)
+{
+  if (target->kind >= HASHED)
+  {
+    memcpy(target->node.packet_cache, packet, A7105_MESH_PACKET_DATA_START);
+    _A7105_Mesh_Update_Handled_Packet_Cache(&(target->node));
+    if (_A7105_Mesh_Is_Handled_Request(&(target->node), packet))
+      return false;
+    _A7105_Mesh_Handling_Request(&(target->node), packet);
+    return true;
+  }
+
+  linear_update(&(target->linear), packet);
+  if (linear_is_handled(&(target->linear), packet))
+    return false;
+  linear_handling(&(target->linear), packet);
+  return true;
+}
+
+int target_ram(struct Bench_Target* target)
+{
+  if (target->kind >= HASHED)
+    return sizeof(target->node.handled_senders) + sizeof(target->node.handled_clock);
+  return target->linear.length * 4 + 1;
+}
+
+//////// Traffic ////////
+
+struct Bench_Sender
+{
+  uint16_t unique_id;
+  byte seq;
+};
+
+struct Bench_Delivery
+{
+  unsigned long step;
+  unsigned long request; //which request this is a copy of
+  byte packet[A7105_MESH_PACKET_DATA_START];
+};
+
+#define BENCH_MAX_PENDING (BENCH_REPEATS * (BENCH_SLOW_REPEAT_DELAY + 1) + 1)
+
+static const byte REQUEST_TYPES[] = {
+  A7105_MESH_PKT_PING,
+  A7105_MESH_PKT_GET_NUM_REGISTERS,
+  A7105_MESH_PKT_GET_REGISTER_NAME,
+  A7105_MESH_PKT_GET_REGISTER,
+  A7105_MESH_PKT_SET_REGISTER,
+};
+
+struct Bench_Sender SENDERS[BENCH_MAX_SENDERS];
+struct Bench_Delivery PENDING[BENCH_MAX_PENDING];
+byte* HANDLED; //per request, set once the receiver has handled it
+byte LOOKUP_PACKETS[1024][A7105_MESH_PACKET_DATA_START];
+
+void run(enum Bench_Kind kind, const char* name, int senders, int repeat_delay, unsigned long steps, unsigned long seed)
+{
+  static struct Bench_Target target;
+  target_reset(&target, kind, senders);
+
+  srandom(seed);
+  for (int x = 0; x < senders; x++)
+  {
+    SENDERS[x].unique_id = (uint16_t)(random() & 0xFFFF);
+    SENDERS[x].seq = (byte)(random() % 256);
+  }
+  memset(HANDLED, 0, steps);
+  int num_pending = 0;
+
+  unsigned long heard = 0, false_drops = 0, missed_dups = 0;
+  for (unsigned long step = 0; step < steps; step++)
+  {
+    //A new request, heard now (maybe) and repeated later
+    struct Bench_Sender* sender = &(SENDERS[random() % senders]);
+    sender->seq++;
+    byte packet[A7105_MESH_PACKET_DATA_START];
+    memset(packet, 0, sizeof(packet));
+    packet[A7105_MESH_PACKET_TYPE] = REQUEST_TYPES[random() % sizeof(REQUEST_TYPES)];
+    if (kind == HASHED_V2)
+    {
+      _A7105_Mesh_Set_Packet_Seq(packet, sender->seq);
+      packet[A7105_MESH_PACKET_FLAGS] = A7105_MESH_PACKET_V2 << 4;
+    }
+    else
+    {
+      _A7105_Mesh_Set_Packet_Seq(packet, sender->seq & 0x0F);
+      packet[A7105_MESH_PACKET_FLAGS] = A7105_MESH_PACKET_V1 << 4;
+    }
+    packet[A7105_MESH_PACKET_UNIQUE_ID] = sender->unique_id >> 8;
+    packet[A7105_MESH_PACKET_UNIQUE_ID+1] = sender->unique_id & 0xFF;
+    memcpy(LOOKUP_PACKETS[step % 1024], packet, sizeof(packet));
+
+    for (int r = 0; r <= BENCH_REPEATS; r++)
+    {
+      if ((random() % 100) >= BENCH_HEAR_PCT)
+        continue;
+      struct Bench_Delivery* delivery = &(PENDING[num_pending++]);
+      delivery->step = step + ((r == 0) ? 0 : 1 + random() % repeat_delay);
+      delivery->request = step;
+      memcpy(delivery->packet, packet, sizeof(packet));
+    }
+
+    //Hear everything that's due (in the order it was sent)
+    for (int x = 0; x < num_pending;)
+    {
+      struct Bench_Delivery* delivery = &(PENDING[x]);
+      if (delivery->step != step)
+      {
+        x++;
+        continue;
+      }
+
+      heard++;
+      byte handled = target_receive(&target, delivery->packet);
+      if (handled && HANDLED[delivery->request])
+        missed_dups++;
+      else if (!handled && !HANDLED[delivery->request])
+        false_drops++;
+      HANDLED[delivery->request] |= handled;
+
+      PENDING[x] = PENDING[--num_pending];
+    }
+  }
+
+  //Time the lookups on the last requests
+  struct timespec start, end;
+  volatile byte sink = 0;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (unsigned long x = 0; x < BENCH_LOOKUPS; x++)
+    sink += target_is_handled(&target, LOOKUP_PACKETS[x % 1024]);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double ns = ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / BENCH_LOOKUPS;
+
+  printf("%s_%d,%d,%.1f,%lu,%lu,%d\n", name, senders, repeat_delay, ns,
+         (false_drops * 10000UL) / heard, (missed_dups * 10000UL) / heard, target_ram(&target));
+}
+
+int main(int argc, char** argv)
+{
+  unsigned long steps = (argc > 1) ? strtoul(argv[1], NULL, 10) : 200000;
+  unsigned long seed = (argc > 2) ? strtoul(argv[2], NULL, 10) : 1;
+  HANDLED = (byte*)malloc(steps);
+
+  static const int SENDER_COUNTS[] = { 1, 2, 4, 8, 16, 32, 64, 255 };
+  static const int REPEAT_DELAYS[] = { BENCH_REPEAT_DELAY, BENCH_SLOW_REPEAT_DELAY };
+  for (unsigned int y = 0; y < sizeof(REPEAT_DELAYS) / sizeof(int); y++)
+    for (unsigned int x = 0; x < sizeof(SENDER_COUNTS) / sizeof(int); x++)
+    {
+      run(LINEAR8, "LINEAR8", SENDER_COUNTS[x], REPEAT_DELAYS[y], steps, seed);
+      run(LINEARN, "LINEARN", SENDER_COUNTS[x], REPEAT_DELAYS[y], steps, seed);
+      run(HASHED, "HASHED", SENDER_COUNTS[x], REPEAT_DELAYS[y], steps, seed);
+      run(HASHED_V2, "HASHED_V2", SENDER_COUNTS[x], REPEAT_DELAYS[y], steps, seed);
+    }
+  free(HANDLED);
+  return 0;
+}
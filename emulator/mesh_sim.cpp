@@ -0,0 +1,362 @@
+/*
+Copyright (C) 2015 Matthew Meno
+
+This file is part of ATmega A7105.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+(1) Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer. 
+
+(2) Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in
+the documentation and/or other materials provided with the
+distribution.  
+
+(3)The name of the author may not be used to
+endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <a7105.h>
+#include <a7105_mesh.h>
+#include "a7105_emulator.h"
+
+/*
+  Runs a handful of mesh nodes against the emulated radios and reports the
+  airtime, SPI traffic and request latency it took. Each node joins (with its
+  own node ID so the run doesn't depend on how name conflicts shake out), then
+  keeps asking random other nodes for their register count (or with -r, one of
+  the next few nodes for their register's value) until the time is up.
+  The virtual clock makes every run with the same arguments identical, so the
+  numbers can be compared across changes to the libraries.
+
+  Usage: mesh_sim [nodes] [seconds] [seed] [-v] [-s hz] [-g cols] [-i ms] [-r]
+    * nodes:   mesh nodes to run (2 to SIM_MAX_NODES, default 5)
+    * seconds: virtual seconds to run the requests for (default 30)
+    * seed:    emulator noise seed (default 1)
+    * -v:      pass the libraries' Serial output (A7105_MESH_DEBUG) through
+    * -s hz:   every other node's SPI wiring garbles reads above 'hz' (see 
+               A7105_Emu_Set_Max_SPI_Clock()) to exercise the SPI clock training 
+               (build with -DA7105_SPI_TRAINING)
+    * -g cols: lay the nodes out in a grid 'cols' wide where each one only hears
+               its neighbors (not diagonals, see A7105_Emu_Set_Range()), so requests
+               take several hops. -g 1 is a chain.
+    * -i ms:   longest time between a node's requests (default 200, the shortest is a 
+               tenth of it), multi-hop meshes need a lighter load
+    * -r:      every node hosts one register ("nodeN" for node ID N) and GETs the
+               registers of the SIM_REGISTER_TARGETS nodes after it by name, instead 
+               of GET_NUM_REGISTERS (see A7105_MESH_LOCATE_REGISTERS)
+
+  Built with -DA7105_3WIRE_SPI the radios are wired for 3-wire SPI and GIO1 is
+  used as each node's TX done pin (see A7105_Set_TX_Done_Pin()).
+
+  Output is one comma delimited line per counter: NAME,VALUE
+    * SPI_CLOCK_MIN/SPI_CLOCK_MAX: slowest and fastest SPI clock the radios trained to
+    * REQUESTS/RESPONSES/TIMEOUTS: GET_NUM_REGISTERS (or GET_REGISTER) requests made 
+                       and how they ended
+    * LATENCY_AVG_US/LATENCY_MAX_US: request to response time
+    * AIRTIME_MS:      time on the air summed over all the nodes
+    * AIRTIME_PER_RESPONSE_US: AIRTIME_MS per completed request
+    * CHANNEL_UTIL_PCT: AIRTIME_MS as a percentage of the run
+    * SPI_TRANSACTIONS/SPI_BYTES: chip select windows and bytes, all nodes
+    * SPI_PER_RESPONSE: SPI_TRANSACTIONS per completed request
+    * RX_PACKETS/RX_ERRORS: packets delivered to radios and how many failed CRC/FEC
+    * COLLISIONS:      packets that overlapped another on the air
+    * RX_REJECTS/RX_REJECT_BYTES(_PER_SEC): frames dropped from their header and the FIFO 
+                       bytes that weren't read for them (A7105_MESH_STATS builds only)
+*/
+
+#define SIM_MAX_NODES 16
+#define SIM_CS_PIN_BASE 20 //node N uses pins 20+2N (chip select) and 21+2N (WTR)
+#define SIM_GIO1_PIN_BASE 100 //and 100+N (GIO1, A7105_3WIRE_SPI builds only)
+#define SIM_LOOP_US 50 //CPU time charged for each A7105_Mesh_Update() pass
+#define SIM_JOIN_TIMEOUT 20000 //milliseconds
+#define SIM_REQUEST_MAX_INTERVAL 200 //default milliseconds between a node's requests (see -i)
+#define SIM_REGISTER_TARGETS 3 //nodes whose registers each node asks for with -r
+#define RADIO_IDS 0xdb042679
+
+struct Sim_Node
+{
+  struct A7105_Emu emu;
+  struct A7105_Mesh mesh;
+  byte joined;
+  byte busy;
+  struct A7105_Mesh_Register reg; //the register we host (-r)
+  struct A7105_Mesh_Register request_reg; //the one we're asking for (-r)
+  unsigned long next_request_time;
+  unsigned long request_start_us;
+};
+
+struct Sim_Node NODES[SIM_MAX_NODES];
+int num_nodes = 5;
+
+unsigned long requests = 0;
+unsigned long responses = 0;
+unsigned long timeouts = 0;
+uint64_t latency_total_us = 0;
+unsigned long latency_max_us = 0;
+
+void join_finished(struct A7105_Mesh* node, A7105_Mesh_Status status, void* context)
+{
+  struct Sim_Node* sim = (struct Sim_Node*)context;
+  sim->joined = (status == A7105_Mesh_STATUS_OK);
+}
+
+void request_finished(struct A7105_Mesh* node, A7105_Mesh_Status status, void* context)
+{
+  struct Sim_Node* sim = (struct Sim_Node*)context;
+  sim->busy = false;
+
+  if (status != A7105_Mesh_STATUS_OK)
+  {
+    timeouts++;
+    return;
+  }
+
+  unsigned long latency = micros() - sim->request_start_us;
+  responses++;
+  latency_total_us += latency;
+  if (latency > latency_max_us)
+    latency_max_us = latency;
+}
+
+//One pass of every node's main loop
+void update_nodes()
+{
+  for (int x = 0; x < num_nodes; x++)
+  {
+    A7105_Mesh_Update(&(NODES[x].mesh));
+    A7105_Emu_Advance_Us(SIM_LOOP_US);
+  }
+}
+
+void print_stat(const char* name, unsigned long long value)
+{
+  printf("%s,%llu\n", name, value);
+}
+
+int main(int argc, char** argv)
+{
+  unsigned long seconds = 30;
+  unsigned long seed = 1;
+  byte verbose = false;
+  uint32_t slow_spi_clock = 0;
+  int grid_columns = 0;
+  unsigned long request_interval = SIM_REQUEST_MAX_INTERVAL;
+  byte get_registers = false;
+
+  int positional = 0;
+  for (int x = 1; x < argc; x++)
+  {
+    if (strcmp(argv[x], "-v") == 0)
+      verbose = true;
+    else if (strcmp(argv[x], "-s") == 0 && x + 1 < argc)
+      slow_spi_clock = strtoul(argv[++x], NULL, 10);
+    else if (strcmp(argv[x], "-g") == 0 && x + 1 < argc)
+      grid_columns = atoi(argv[++x]);
+    else if (strcmp(argv[x], "-i") == 0 && x + 1 < argc)
+      request_interval = strtoul(argv[++x], NULL, 10);
+    else if (strcmp(argv[x], "-r") == 0)
+      get_registers = true;
+    else if (positional == 0 && ++positional)
+      num_nodes = atoi(argv[x]);
+    else if (positional == 1 && ++positional)
+      seconds = strtoul(argv[x], NULL, 10);
+    else if (positional == 2 && ++positional)
+      seed = strtoul(argv[x], NULL, 10);
+  }
+
+  if (num_nodes < 2 || num_nodes > SIM_MAX_NODES || num_nodes > A7105_MAX_RADIOS)
+  {
+    fprintf(stderr, "nodes must be 2-%d (and at most A7105_MAX_RADIOS, %d)\n", SIM_MAX_NODES, A7105_MAX_RADIOS);
+    return 1;
+  }
+
+  A7105_Emu_Seed(seed);
+  Serial.set_output(verbose);
+  if (grid_columns > 0)
+    A7105_Emu_Set_Range(1);
+
+  //Bring up the radios and meshes
+  for (int x = 0; x < num_nodes; x++)
+  {
+    struct Sim_Node* sim = &(NODES[x]);
+    A7105_Emu_Add_Radio(&(sim->emu), SIM_CS_PIN_BASE + 2*x, SIM_CS_PIN_BASE + 2*x + 1);
+#ifdef A7105_3WIRE_SPI
+    A7105_Emu_Wire_3Wire(&(sim->emu), SIM_GIO1_PIN_BASE + x);
+#endif
+    if (x & 1)
+      A7105_Emu_Set_Max_SPI_Clock(&(sim->emu), slow_spi_clock);
+    if (grid_columns > 0)
+      A7105_Emu_Set_Position(&(sim->emu), x % grid_columns, x / grid_columns);
+
+    A7105_Mesh_Status status = A7105_Mesh_Initialize(&(sim->mesh),
+                                                     SIM_CS_PIN_BASE + 2*x,
+                                                     SIM_CS_PIN_BASE + 2*x + 1,
+                                                     RADIO_IDS,
+                                                     A7105_DATA_RATE_125Kbps,
+                                                     0,
+                                                     A7105_TXPOWER_150mW,
+                                                     A0);
+    if (status != A7105_Mesh_STATUS_OK)
+    {
+      fprintf(stderr, "node %d failed to initialize (%d)\n", x, (int)status);
+      return 1;
+    }
+    A7105_Mesh_Set_Context(&(sim->mesh), sim);
+#ifdef A7105_3WIRE_SPI
+    A7105_Set_TX_Done_Pin(&(sim->mesh.radio), SIM_GIO1_PIN_BASE + x);
+#endif
+
+    if (get_registers)
+    {
+      char name[16]; //(room for "node" and any int)
+      snprintf(name, sizeof(name), "node%d", x + 1);
+      A7105_Mesh_Register_Initialize(&(sim->reg), NULL, NULL);
+      A7105_Mesh_Util_SetRegisterNameStr(&(sim->reg), name);
+      A7105_Mesh_Util_SetRegisterValueU32(&(sim->reg), (uint32_t)(x + 1));
+      A7105_Mesh_Set_Node_Registers(&(sim->mesh), &(sim->reg), 1);
+    }
+  }
+
+  //Join everyone at once
+  for (int x = 0; x < num_nodes; x++)
+    A7105_Mesh_Join(&(NODES[x].mesh), (byte)(x + 1), join_finished);
+
+  unsigned long start = millis();
+  int joined = 0;
+  while (joined < num_nodes && millis() - start < SIM_JOIN_TIMEOUT)
+  {
+    update_nodes();
+    joined = 0;
+    for (int x = 0; x < num_nodes; x++)
+      joined += NODES[x].joined;
+  }
+  print_stat("NODES", num_nodes);
+  print_stat("JOINED", joined);
+  print_stat("JOIN_MS", millis() - start);
+
+  uint32_t spi_clock_min = 0xFFFFFFFF, spi_clock_max = 0;
+  for (int x = 0; x < num_nodes; x++)
+  {
+    uint32_t clock = NODES[x].mesh.radio._SPI_CLOCK;
+    spi_clock_min = (clock < spi_clock_min) ? clock : spi_clock_min;
+    spi_clock_max = (clock > spi_clock_max) ? clock : spi_clock_max;
+  }
+  print_stat("SPI_CLOCK_MIN", spi_clock_min);
+  print_stat("SPI_CLOCK_MAX", spi_clock_max);
+
+  //Only count the requests
+  A7105_Emu_Reset_Stats();
+#ifdef A7105_MESH_STATS
+  for (int x = 0; x < num_nodes; x++)
+  {
+    NODES[x].mesh.stat_rx_rejects = 0;
+    NODES[x].mesh.stat_rx_reject_bytes = 0;
+  }
+#endif
+  start = millis();
+  while (millis() - start < seconds * 1000)
+  {
+    update_nodes();
+
+    for (int x = 0; x < num_nodes; x++)
+    {
+      struct Sim_Node* sim = &(NODES[x]);
+      if (sim->busy || millis() < sim->next_request_time)
+        continue;
+
+      //Ask someone else (node IDs are 1 to num_nodes)
+      byte target = (byte)random(1, num_nodes);
+      if (target >= x + 1)
+        target++;
+      if (get_registers)
+      {
+        //(one of the few nodes after us, so there are repeat customers)
+        int targets = (num_nodes - 1 < SIM_REGISTER_TARGETS) ? num_nodes - 1 : SIM_REGISTER_TARGETS;
+        target = (byte)((x + random(1, targets + 1)) % num_nodes + 1);
+      }
+
+      sim->request_start_us = micros();
+      A7105_Mesh_Status status;
+      if (get_registers)
+      {
+        char name[16]; //(room for "node" and any int)
+        snprintf(name, sizeof(name), "node%d", target);
+        A7105_Mesh_Register_Initialize(&(sim->request_reg), NULL, NULL);
+        A7105_Mesh_Util_SetRegisterNameStr(&(sim->request_reg), name);
+        status = A7105_Mesh_GetRegister(&(sim->mesh), &(sim->request_reg), request_finished);
+      }
+      else
+        status = A7105_Mesh_GetNumRegisters(&(sim->mesh), target, request_finished);
+      if (status == A7105_Mesh_STATUS_OK)
+      {
+        sim->busy = true;
+        requests++;
+      }
+      sim->next_request_time = millis() + random(request_interval / 10, request_interval);
+    }
+  }
+  unsigned long elapsed_ms = millis() - start;
+
+  uint64_t airtime_ns = 0;
+  unsigned long long spi_transactions = 0, spi_bytes = 0, rx_packets = 0, rx_errors = 0, collisions = 0;
+  for (int x = 0; x < num_nodes; x++)
+  {
+    struct A7105_Emu* emu = &(NODES[x].emu);
+    airtime_ns += emu->stat_tx_airtime_ns;
+    spi_transactions += emu->stat_spi_transactions;
+    spi_bytes += emu->stat_spi_bytes;
+    rx_packets += emu->stat_rx_packets;
+    rx_errors += emu->stat_rx_errors;
+    collisions += emu->stat_collisions;
+  }
+
+  print_stat("SECONDS", elapsed_ms / 1000);
+  print_stat("REQUESTS", requests);
+  print_stat("RESPONSES", responses);
+  print_stat("TIMEOUTS", timeouts);
+  print_stat("LATENCY_AVG_US", responses ? latency_total_us / responses : 0);
+  print_stat("LATENCY_MAX_US", latency_max_us);
+  print_stat("AIRTIME_MS", airtime_ns / 1000000ULL);
+  print_stat("AIRTIME_PER_RESPONSE_US", responses ? airtime_ns / 1000ULL / responses : 0);
+  print_stat("CHANNEL_UTIL_PCT", elapsed_ms ? (airtime_ns / 10000ULL) / elapsed_ms : 0);
+  print_stat("SPI_TRANSACTIONS", spi_transactions);
+  print_stat("SPI_BYTES", spi_bytes);
+  print_stat("SPI_PER_RESPONSE", responses ? spi_transactions / responses : 0);
+  print_stat("RX_PACKETS", rx_packets);
+  print_stat("RX_ERRORS", rx_errors);
+  print_stat("COLLISIONS", collisions);
+#ifdef A7105_MESH_STATS
+  unsigned long long rx_rejects = 0, rx_reject_bytes = 0;
+  for (int x = 0; x < num_nodes; x++)
+  {
+    rx_rejects += NODES[x].mesh.stat_rx_rejects;
+    rx_reject_bytes += NODES[x].mesh.stat_rx_reject_bytes;
+  }
+  print_stat("RX_REJECTS", rx_rejects);
+  print_stat("RX_REJECT_BYTES", rx_reject_bytes);
+  print_stat("RX_REJECT_BYTES_PER_SEC", elapsed_ms ? rx_reject_bytes * 1000 / elapsed_ms : 0);
+#endif
+
+  return 0;
+}
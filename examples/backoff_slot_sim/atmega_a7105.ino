@@ -0,0 +1,131 @@
+/*Copyright (C) 2015 Matthew Meno
+
+This file is part of ATmega A7105.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+(1) Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer. 
+
+(2) Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in
+the documentation and/or other materials provided with the
+distribution.  
+
+(3)The name of the author may not be used to
+endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "stdint.h"
+#include <SPI.h>
+#include <a7105.h> 
+#include <a7105_mesh.h> 
+
+
+/*
+  This sketch simulates (no radio needed) how often the mesh's random repeat delays put
+  two nodes on the air at the same time, with the delays rounded to whole milliseconds 
+  (how the mesh used to time them) vs. the microsecond clock it uses now (A7105_Mesh_Micros()).
+
+  Each round, SIM_NODES nodes that heard the same packet pick a repeat delay with 
+  _A7105_Mesh_Calculate_Random_Delay(). The first node to go wins the channel (the others 
+  hear it with carrier sense and back off) unless another node starts before it can be 
+  heard, that's a collision:
+    * Millisecond slots: Nodes that picked the same millisecond all see the millis() tick at
+                         about the same time, so they all go together.
+    * Microsecond slots: Nodes collide if they start within CCA_WINDOW_US of each other.
+
+  For each data rate it prints one comma delimited line per slot size: NAME,COLLISIONS
+  (the number of the SIM_ROUNDS rounds that ended in a collision, it takes a little while). 
+  Millisecond slots collide roughly 2.5 times as often and the gap gets bigger as the data
+  rate goes up (fewer milliseconds to spread the nodes over).
+
+  Hookup Guide:
+    Nothing but the serial port (115200 baud).
+*/
+
+#define SIM_NODES 8 //nodes competing to repeat the same packet
+#define SIM_ROUNDS 10000
+#define CCA_WINDOW_US 200 //time from sampling the channel to our preamble being on the air 
+                          //(A7105_RSSI_SETTLE_US plus SPI and TX settling)
+
+#define putstring(x) SerialPrint_P(PSTR(x))                             
+void SerialPrint_P(PGM_P str) {                                         
+  for (uint8_t c; (c = pgm_read_byte(str)); str++) Serial.write(c);     
+} 
+
+unsigned long DELAYS[SIM_NODES];
+
+void print_result(PGM_P name, PGM_P slots, unsigned long collisions)
+{
+  SerialPrint_P(name);
+  SerialPrint_P(slots);
+  putstring(",");
+  Serial.println(collisions);
+}
+
+void simulate(PGM_P name, A7105_DataRate data_rate)
+{
+  unsigned long ms_collisions = 0;
+  unsigned long us_collisions = 0;
+
+  for (int round = 0; round < SIM_ROUNDS; round++)
+  {
+    //Everybody picks a delay, find who goes first
+    byte first = 0;
+    for (byte x = 0; x < SIM_NODES; x++)
+    {
+      DELAYS[x] = _A7105_Mesh_Calculate_Random_Delay(data_rate);
+      if (DELAYS[x] < DELAYS[first])
+        first = x;
+    }
+
+    //Does anyone else go before they can hear the first node?
+    byte ms_collision = 0;
+    byte us_collision = 0;
+    for (byte x = 0; x < SIM_NODES; x++)
+    {
+      if (x == first)
+        continue;
+      if (DELAYS[x] / 1000 == DELAYS[first] / 1000)
+        ms_collision = 1;
+      if (DELAYS[x] - DELAYS[first] < CCA_WINDOW_US)
+        us_collision = 1;
+    }
+    ms_collisions += ms_collision;
+    us_collisions += us_collision;
+  }
+
+  print_result(name, PSTR("_MS_SLOTS"), ms_collisions);
+  print_result(name, PSTR("_US_SLOTS"), us_collisions);
+}
+
+void setup() {
+  Serial.begin(115200);
+  randomSeed(A7105_Mesh_Get_Random_Seed(31, 0));
+
+  simulate(PSTR("250KBPS"), A7105_DATA_RATE_250Kbps);
+  simulate(PSTR("125KBPS"), A7105_DATA_RATE_125Kbps);
+  simulate(PSTR("50KBPS"), A7105_DATA_RATE_50Kbps);
+  simulate(PSTR("10KBPS"), A7105_DATA_RATE_10Kbps);
+  putstring("DONE\r\n");
+}
+
+void loop() {
+}
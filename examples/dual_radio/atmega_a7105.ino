@@ -0,0 +1,245 @@
+/*Copyright (C) 2015 Matthew Meno
+
+This file is part of ATmega A7105.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+(1) Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer. 
+
+(2) Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in
+the documentation and/or other materials provided with the
+distribution.  
+
+(3)The name of the author may not be used to
+endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "stdint.h"
+#include <SPI.h>
+#include <a7105.h> 
+
+
+/*
+  This sketch measures what a second radio buys you. One radio (RADIO1) sends a short 
+  packet every TX_INTERVAL milliseconds and the sketch counts the packets it hears from
+  other nodes running the same sketch. It alternates between two modes every REPORT_INTERVAL:
+
+    * SINGLE: RADIO1 listens between its own TXs (it's deaf while transmitting and 
+              re-arming, like a normal single radio node)
+    * DUAL:   RADIO1 only transmits and RADIO2 is always listening
+
+  Load it on two or more nodes. At the end of each interval it prints one comma
+  delimited line per counter: NAME,VALUE
+    * MODE:       SINGLE or DUAL
+    * TX_PACKETS: packets we sent
+    * RX_PACKETS: packets we received from other nodes
+    * RX_ERRORS:  packets that failed the CRC check
+    * GAIN_PCT:   (DUAL intervals only) RX_PACKETS vs. the SINGLE interval before it
+
+  Each radio's WTR events are tracked separately by the a7105 library, so RADIO1's
+  TX finishing never looks like a packet arriving on RADIO2 (or vice versa).
+
+  Hookup Guide:
+    RADIO1 is wired like the serial_mesh_interface example (A7105 Pro Mini shield v0.2).
+    RADIO2 shares the SPI bus (SCK, MOSI, MISO) and uses:
+      CS:   Pin 9 (Arduino IDE pin) -------> scs (radio pin)
+      WTR:  Pin 10 (")              -------> gio2 (")
+    NOTE: The radios' GIO1 (MISO) lines don't go high-Z so they need tri-state buffers
+          (or diodes and a pull-down, see the note in A7105_Easy_Setup_Radio()). The
+          shield's buffer covers RADIO1.
+*/
+
+//Constants for the Pro Mini A7105 Radio Shield v0.2 (RADIO1) and the second radio
+#define RADIO1_SELECT_PIN 7
+#define RADIO1_WTR_PIN 8
+#define RADIO2_SELECT_PIN 9
+#define RADIO2_WTR_PIN 10
+#define RADIO_IDS 0xdb042679
+#define RADIO_CHANNEL 0
+
+#define PACKET_SIZE 16
+#define PACKET_MAGIC 0xD2 //First byte of our packets (so we only count this sketch's traffic)
+#define TX_INTERVAL 20 //average milliseconds between our packets (randomized so the nodes don't line up)
+#define REPORT_INTERVAL 10000
+
+#define putstring(x) SerialPrint_P(PSTR(x))                             
+void SerialPrint_P(PGM_P str) {                                         
+  for (uint8_t c; (c = pgm_read_byte(str)); str++) Serial.write(c);     
+} 
+
+struct A7105 RADIO1;
+struct A7105 RADIO2;
+
+byte NODE_ID;
+byte TX_BUFFER[PACKET_SIZE];
+byte RX_BUFFER[PACKET_SIZE];
+
+byte dual_mode = 0;
+byte tx_in_flight = 0;
+uint16_t tx_sequence = 0;
+unsigned long next_tx_time = 0;
+unsigned long last_report_time = 0;
+
+unsigned long tx_packets = 0;
+unsigned long rx_packets = 0;
+unsigned long rx_errors = 0;
+unsigned long single_rx_packets = 0; //RX_PACKETS from the last SINGLE interval
+
+void print_stat(PGM_P name, long value)
+{
+  SerialPrint_P(name);
+  putstring(",");
+  Serial.println(value);
+}
+
+//The radio we're currently receiving with
+struct A7105* listener()
+{
+  return dual_mode ? &RADIO2 : &RADIO1;
+}
+
+void check_rx()
+{
+  struct A7105* radio = listener();
+
+  //Skip the SPI bus entirely unless the WTR interrupt saw a packet
+  if (!(A7105_Get_Events(radio) & A7105_EVENT_RX_READY))
+    return;
+
+  A7105_Status_Code status = A7105_ReadData(radio, RX_BUFFER, PACKET_SIZE);
+  if (status == A7105_STATUS_OK)
+  {
+    //RADIO2 hears RADIO1's packets too, don't count ourselves
+    if (RX_BUFFER[0] == PACKET_MAGIC && RX_BUFFER[1] != NODE_ID)
+      rx_packets++;
+  }
+  else if (status == A7105_RX_DATA_INTEGRITY_ERROR)
+    rx_errors++;
+
+  A7105_Easy_Listen_For_Packets(radio, PACKET_SIZE);
+}
+
+void check_tx()
+{
+  //Once RADIO1 is done sending, it goes back to listening in SINGLE mode
+  if (tx_in_flight && (A7105_Get_Events(&RADIO1) & A7105_EVENT_TX_DONE))
+  {
+    tx_in_flight = 0;
+    if (!dual_mode)
+      A7105_Easy_Listen_For_Packets(&RADIO1, PACKET_SIZE);
+  }
+
+  if (tx_in_flight || millis() < next_tx_time)
+    return;
+
+  TX_BUFFER[0] = PACKET_MAGIC;
+  TX_BUFFER[1] = NODE_ID;
+  TX_BUFFER[2] = (byte)(tx_sequence >> 8);
+  TX_BUFFER[3] = (byte)(tx_sequence & 0xFF);
+  if (A7105_WriteData(&RADIO1, TX_BUFFER, PACKET_SIZE) == A7105_STATUS_OK)
+  {
+    tx_in_flight = 1;
+    tx_sequence++;
+    tx_packets++;
+  }
+  next_tx_time = millis() + random(TX_INTERVAL/2, TX_INTERVAL + TX_INTERVAL/2);
+}
+
+void set_mode(byte dual)
+{
+  //Let the last TX finish so RADIO1 is in a known state
+  while (tx_in_flight && !(A7105_Get_Events(&RADIO1) & A7105_EVENT_TX_DONE));
+  tx_in_flight = 0;
+
+  dual_mode = dual;
+  if (dual_mode)
+  {
+    A7105_Strobe(&RADIO1, A7105_STANDBY);
+    A7105_Easy_Listen_For_Packets(&RADIO2, PACKET_SIZE);
+  }
+  else
+  {
+    A7105_Strobe(&RADIO2, A7105_STANDBY);
+    A7105_Easy_Listen_For_Packets(&RADIO1, PACKET_SIZE);
+  }
+}
+
+void report()
+{
+  if (dual_mode)
+    putstring("MODE,DUAL\r\n");
+  else
+    putstring("MODE,SINGLE\r\n");
+  print_stat(PSTR("TX_PACKETS"), tx_packets);
+  print_stat(PSTR("RX_PACKETS"), rx_packets);
+  print_stat(PSTR("RX_ERRORS"), rx_errors);
+
+  if (dual_mode && single_rx_packets > 0)
+    print_stat(PSTR("GAIN_PCT"), (long)((rx_packets * 100UL) / single_rx_packets) - 100);
+  else if (!dual_mode)
+    single_rx_packets = rx_packets;
+  putstring("DONE\r\n");
+
+  tx_packets = 0;
+  rx_packets = 0;
+  rx_errors = 0;
+}
+
+void setup() {
+  Serial.begin(115200);
+
+  pinMode(MOSI,OUTPUT);
+  pinMode(MISO,INPUT);
+  pinMode(SCK,OUTPUT);
+
+  randomSeed(analogRead(A0) ^ micros());
+  NODE_ID = (byte)random(256);
+
+  //NOTE: Set up both radios before using either (they share the bus). RADIO2 gets
+  //its own calibration cache region right after RADIO1's.
+  A7105_Status_Code status = A7105_Easy_Setup_Radio(&RADIO1, RADIO1_SELECT_PIN, RADIO1_WTR_PIN, RADIO_IDS,
+                                                    A7105_DATA_RATE_250Kbps, RADIO_CHANNEL,
+                                                    A7105_TXPOWER_150mW, 1, 0);
+  putstring("INIT_RADIO1,");
+  Serial.println(status == A7105_STATUS_OK);
+
+  status = A7105_Easy_Setup_Radio(&RADIO2, RADIO2_SELECT_PIN, RADIO2_WTR_PIN, RADIO_IDS,
+                                  A7105_DATA_RATE_250Kbps, RADIO_CHANNEL,
+                                  A7105_TXPOWER_150mW, 1, 0,
+                                  A7105_CAL_EEPROM_ADDR + A7105_CAL_EEPROM_SIZE);
+  putstring("INIT_RADIO2,");
+  Serial.println(status == A7105_STATUS_OK);
+
+  set_mode(0);
+  last_report_time = millis();
+}
+
+void loop() {
+  check_rx();
+  check_tx();
+
+  if (millis() - last_report_time >= REPORT_INTERVAL)
+  {
+    report();
+    set_mode(!dual_mode);
+    last_report_time = millis();
+  }
+}
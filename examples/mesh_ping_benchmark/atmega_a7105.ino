@@ -0,0 +1,184 @@
+/*Copyright (C) 2015 Matthew Meno
+
+This file is part of ATmega A7105.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+(1) Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer. 
+
+(2) Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in
+the documentation and/or other materials provided with the
+distribution.  
+
+(3)The name of the author may not be used to
+endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "stdint.h"
+#include <SPI.h>
+#include <a7105.h> 
+#include <a7105_mesh.h> 
+
+/*
+  This sketch puts a PING-heavy load on the mesh and reports how much airtime it used and how
+  many frames were lost (mostly to collisions). Load it on a handful of nodes, let them run for 
+  a while and compare the numbers with A7105_MESH_FIXED_PACKET_SIZE commented/uncommented in 
+  a7105_mesh.h (every packet padded to 64 bytes vs. the smallest of 16/32/64 that fits) or 
+  A7105_MESH_DISABLE_CSMA commented/uncommented (carrier sense vs. sending blindly).
+
+  NOTE: A7105_MESH_STATS must be uncommented in a7105_mesh.h for this to build.
+
+  Every REPORT_INTERVAL milliseconds it prints one comma delimited line per counter: NAME,VALUE
+    * TX_PACKETS:   packets this node sent (PINGs, PONGs, repeats...)
+    * TX_FRAMES:    frames those took (long packets are sent as a first frame and a tail)
+    * TX_BYTES:     frame payload bytes sent
+    * AIRTIME_MS:   time on the air for all that, including preamble/ID/CRC and FEC
+    * RX_PACKETS:   whole packets received
+    * RX_ERRORS:    frames that failed CRC/FEC and long packets that lost their tail
+    * COLLISION_PCT: RX_ERRORS as a percentage of everything received
+    * TX_BACKOFFS:  times carrier sense found the channel busy and held a packet back
+    * PINGS:        PINGs that finished
+    * PONGS:        nodes that answered them (summed over all the PINGs)
+    * DELIVERY_PCT: PONGS as a percentage of what we'd get if every node we've ever 
+                    seen answered every PING
+
+  Hookup Guide:
+    Same as the register_host_test example (A7105 Pro Mini shield v0.2).
+*/
+
+#ifndef A7105_MESH_STATS
+#error "Uncomment A7105_MESH_STATS in a7105_mesh.h to use this sketch"
+#endif
+
+//Constants for the Pro Mini A7105 Radio Shield v0.2
+#define RADIO1_SELECT_PIN 7
+#define RADIO1_WTR_PIN 8
+#define RADIO_IDS 0xdb042679 //The ID filter for the current mesh 
+
+#define PING_MIN_INTERVAL 50 //milliseconds between our PINGs (randomized so the nodes don't line up)
+#define PING_MAX_INTERVAL 250
+#define REPORT_INTERVAL 10000
+
+//On-air overhead for each frame (4 byte preamble, 4 byte ID, 2 byte CRC)
+//and the FEC expansion (7/4) on the payload and CRC
+#define FRAME_HEADER_BITS 64
+#define FRAME_CRC_BYTES 2
+#define BITS_PER_MS 125 //A7105_DATA_RATE_125Kbps
+
+#define putstring(x) SerialPrint_P(PSTR(x))                             
+void SerialPrint_P(PGM_P str) {                                         
+  for (uint8_t c; (c = pgm_read_byte(str)); str++) Serial.write(c);     
+} 
+
+struct A7105_Mesh RADIO;
+
+unsigned long next_ping_time = 0;
+unsigned long last_report_time = 0;
+
+uint16_t pings = 0;
+unsigned long pongs = 0;
+byte most_nodes_seen = 0;
+
+//Count how many nodes answered (node->presence_table has a bit per node that PONGed)
+void ping_finished(struct A7105_Mesh* node, A7105_Mesh_Status status, void* context)
+{
+  if (status != A7105_Mesh_STATUS_OK)
+    return;
+
+  byte nodes_seen = 0;
+  for (int x = 0; x < 256; x++)
+    if (node->presence_table[x/8] & (byte)(1<<(x%8)))
+      nodes_seen++;
+
+  pings++;
+  pongs += nodes_seen;
+  if (nodes_seen > most_nodes_seen)
+    most_nodes_seen = nodes_seen;
+}
+
+void print_stat(PGM_P name, unsigned long value)
+{
+  SerialPrint_P(name);
+  putstring(",");
+  Serial.println(value);
+}
+
+void report()
+{
+  unsigned long air_bits = (unsigned long)RADIO.stat_tx_frames * FRAME_HEADER_BITS +
+                           ((RADIO.stat_tx_bytes + (unsigned long)RADIO.stat_tx_frames * FRAME_CRC_BYTES) * 8 * 7) / 4;
+  unsigned long rx_total = (unsigned long)RADIO.stat_rx_packets + RADIO.stat_rx_errors;
+
+  print_stat(PSTR("TX_PACKETS"), RADIO.stat_tx_packets);
+  print_stat(PSTR("TX_FRAMES"), RADIO.stat_tx_frames);
+  print_stat(PSTR("TX_BYTES"), RADIO.stat_tx_bytes);
+  print_stat(PSTR("AIRTIME_MS"), air_bits / BITS_PER_MS);
+  print_stat(PSTR("RX_PACKETS"), RADIO.stat_rx_packets);
+  print_stat(PSTR("RX_ERRORS"), RADIO.stat_rx_errors);
+  print_stat(PSTR("COLLISION_PCT"), rx_total ? (RADIO.stat_rx_errors * 100UL) / rx_total : 0);
+  print_stat(PSTR("TX_BACKOFFS"), RADIO.stat_tx_backoffs);
+  print_stat(PSTR("PINGS"), pings);
+  print_stat(PSTR("PONGS"), pongs);
+  print_stat(PSTR("DELIVERY_PCT"), most_nodes_seen ? (pongs * 100UL) / ((unsigned long)pings * most_nodes_seen) : 0);
+  putstring("DONE\r\n");
+}
+
+void setup() {
+  Serial.begin(115200);
+
+  pinMode(MOSI,OUTPUT);
+  pinMode(MISO,INPUT);
+  pinMode(SCK,OUTPUT);
+
+  A7105_Mesh_Status success = A7105_Mesh_Initialize(&(RADIO),
+                                                    RADIO1_SELECT_PIN,
+                                                    RADIO1_WTR_PIN,
+                                                    RADIO_IDS,
+                                                    A7105_DATA_RATE_125Kbps,
+                                                    0,
+                                                    A7105_TXPOWER_150mW,
+                                                    0);
+  putstring("INIT,");
+  Serial.println(success == A7105_Mesh_STATUS_OK);
+
+  A7105_Mesh_Status join_status = A7105_Mesh_Join(&(RADIO), NULL);
+  putstring("JOIN,");
+  Serial.println(join_status == A7105_Mesh_STATUS_OK);
+
+  last_report_time = millis();
+}
+
+void loop() {
+  //Let the RADIO have some time to push packets around
+  A7105_Mesh_Update(&(RADIO));
+
+  //Keep the PINGs coming (skipped if the last one is still waiting on PONGs)
+  if (millis() > next_ping_time)
+  {
+    A7105_Mesh_Ping(&(RADIO), ping_finished);
+    next_ping_time = millis() + random(PING_MIN_INTERVAL, PING_MAX_INTERVAL);
+  }
+
+  if (millis() - last_report_time > REPORT_INTERVAL)
+  {
+    report();
+    last_report_time = millis();
+  }
+}
@@ -940,7 +940,11 @@ int get_serial_cmd(byte uppercase)
   ASCII_BUFFER[index] = '\0'; //zero the buffer so we don't repeat commands
   unsigned long now = millis();
   
-  while(Serial.available() == 0 && millis()-now < SERIAL_READ_TIMEOUT){}
+  while(Serial.available() == 0 && millis()-now < SERIAL_READ_TIMEOUT)
+  {
+    //Keep the mesh going (i.e. re-arm RX after a TX) while we wait on the host
+    A7105_Mesh_Update(&(RADIO));
+  }
   
   if (Serial.available() > 0)
     while ( index < ASCII_BUFFER_SIZE - 1)
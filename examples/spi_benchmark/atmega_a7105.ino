@@ -0,0 +1,236 @@
+/*Copyright (C) 2015 Matthew Meno
+
+This file is part of ATmega A7105.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+(1) Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer. 
+
+(2) Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in
+the documentation and/or other materials provided with the
+distribution.  
+
+(3)The name of the author may not be used to
+endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "stdint.h"
+#include <SPI.h>
+#include <a7105.h> 
+#include <a7105_radio.h>
+
+
+/*
+  This sketch is a bench harness for timing the low-level SPI paths in the a7105 library.
+  It sets up a single radio and prints the number of CPU cycles spent in each of the
+  operations below (averaged over BENCH_ITERATIONS runs):
+
+    * FIFO_PER_BYTE: Reading a 64-byte packet out of the FIFO with 64 calls to A7105_ReadReg()
+                     (this is how A7105_ReadData() used to drain the FIFO)
+    * FIFO_BURST:    Reading a 64-byte packet with A7105_ReadBurst() (single chip-select window)
+    * REGS_PER_REG:  Reading the 4 calibration registers (22h-25h) with A7105_ReadReg()
+    * REGS_BLOCK:    Reading the same registers with A7105_ReadRegBlock()
+    * RX_REARM:      Re-arming RX with A7105_Easy_Listen_For_Packets() (what the mesh does after every TX/RX),
+                     followed by the number of register writes and strobes the shadow register cache skipped
+    * WRITE_REG_DIGITALWRITE/READ_REG_DIGITALWRITE: A register write/read with digitalWrite() for the 
+                     chip-select (how A7105_WriteReg()/A7105_ReadReg() used to work)
+    * WRITE_REG/READ_REG: A7105_WriteReg()/A7105_ReadReg() (port register resolved at runtime)
+    * WRITE_REG_TEMPLATE/READ_REG_TEMPLATE: The same through A7105Radio<> (port and bit resolved at compile time)
+
+  Output is one comma delimited line per test: NAME,CYCLES
+
+  Hookup Guide:
+    Same as the serial_mesh_interface example (A7105 Pro Mini shield v0.2), the 
+    WTR pin isn't used here.
+*/
+
+//Constants for the Pro Mini A7105 Radio Shield v0.2
+#define RADIO1_SELECT_PIN 7
+#define RADIO_IDS 0xdb042679
+
+#define BENCH_ITERATIONS 100
+
+#define putstring(x) SerialPrint_P(PSTR(x))                             
+void SerialPrint_P(PGM_P str) {                                         
+  for (uint8_t c; (c = pgm_read_byte(str)); str++) Serial.write(c);     
+} 
+
+A7105Radio<RADIO1_SELECT_PIN> RADIO;
+byte BUFFER[A7105_MAX_FIFO_SIZE];
+
+//Convert a total time (microseconds) over BENCH_ITERATIONS runs into 
+//the average CPU cycles per run
+unsigned long us_to_cycles(unsigned long us)
+{
+  return (us * (F_CPU / 1000000UL)) / BENCH_ITERATIONS;
+}
+
+void print_result(PGM_P name, unsigned long us)
+{
+  SerialPrint_P(name);
+  putstring(",");
+  Serial.println(us_to_cycles(us));
+}
+
+void bench_fifo()
+{
+  unsigned long start = micros();
+  for (int x = 0; x < BENCH_ITERATIONS; x++)
+  {
+    A7105_Strobe(&RADIO.radio, A7105_RST_RDPTR); 
+    for (int i = 0; i < A7105_MAX_FIFO_SIZE; i++)
+      BUFFER[i] = A7105_ReadReg(&RADIO.radio, A7105_05_FIFO_DATA);
+  }
+  print_result(PSTR("FIFO_PER_BYTE"), micros() - start);
+
+  start = micros();
+  for (int x = 0; x < BENCH_ITERATIONS; x++)
+  {
+    A7105_Strobe(&RADIO.radio, A7105_RST_RDPTR); 
+    A7105_ReadBurst(&RADIO.radio, A7105_05_FIFO_DATA, BUFFER, A7105_MAX_FIFO_SIZE);
+  }
+  print_result(PSTR("FIFO_BURST"), micros() - start);
+}
+
+void bench_reg_block()
+{
+  unsigned long start = micros();
+  for (int x = 0; x < BENCH_ITERATIONS; x++)
+  {
+    for (int i = 0; i < 4; i++)
+      BUFFER[i] = A7105_ReadReg(&RADIO.radio, A7105_22_IF_CALIB_I + i);
+  }
+  print_result(PSTR("REGS_PER_REG"), micros() - start);
+
+  start = micros();
+  for (int x = 0; x < BENCH_ITERATIONS; x++)
+    A7105_ReadRegBlock(&RADIO.radio, A7105_22_IF_CALIB_I, BUFFER, 4);
+  print_result(PSTR("REGS_BLOCK"), micros() - start);
+}
+
+void bench_rearm()
+{
+  uint16_t writes_elided = RADIO.radio._WRITES_ELIDED;
+  uint16_t strobes_elided = RADIO.radio._STROBES_ELIDED;
+
+  unsigned long start = micros();
+  for (int x = 0; x < BENCH_ITERATIONS; x++)
+  {
+    A7105_Easy_Listen_For_Packets(&RADIO.radio, A7105_MAX_FIFO_SIZE);
+
+    //Drop back to standby like a received packet would
+    A7105_Strobe(&RADIO.radio, A7105_STANDBY);
+  }
+  print_result(PSTR("RX_REARM"), micros() - start);
+
+  putstring("WRITES_ELIDED,");
+  Serial.println(RADIO.radio._WRITES_ELIDED - writes_elided);
+  putstring("STROBES_ELIDED,");
+  Serial.println(RADIO.radio._STROBES_ELIDED - strobes_elided);
+}
+
+//The old chip-select path, kept here as a baseline for bench_reg_access()
+void digitalwrite_write_reg(byte addr, byte value)
+{
+  digitalWrite(RADIO1_SELECT_PIN,LOW);
+  SPI.beginTransaction(SPISettings(A7105_SPI_CLOCK, MSBFIRST, SPI_MODE0));
+  SPI.transfer(addr);
+  SPI.transfer(value);
+  SPI.endTransaction();
+  digitalWrite(RADIO1_SELECT_PIN,HIGH);
+}
+
+byte digitalwrite_read_reg(byte addr)
+{
+  digitalWrite(RADIO1_SELECT_PIN,LOW);
+  SPI.beginTransaction(SPISettings(A7105_SPI_CLOCK, MSBFIRST, SPI_MODE0));
+  SPI.transfer(addr | 0x40);
+  byte read_byte = SPI.transfer(0x00);
+  SPI.endTransaction();
+  digitalWrite(RADIO1_SELECT_PIN,HIGH);
+  return read_byte;
+}
+
+void bench_reg_access()
+{
+  //NOTE: Alternate the values written so the shadow register cache doesn't skip them
+  unsigned long start = micros();
+  for (int x = 0; x < BENCH_ITERATIONS; x++)
+    digitalwrite_write_reg(A7105_1D_RSSI_THOLD, 0x40 + (x & 1));
+  print_result(PSTR("WRITE_REG_DIGITALWRITE"), micros() - start);
+
+  start = micros();
+  for (int x = 0; x < BENCH_ITERATIONS; x++)
+    A7105_WriteReg(&RADIO.radio, A7105_1D_RSSI_THOLD, (byte)(0x40 + (x & 1)));
+  print_result(PSTR("WRITE_REG"), micros() - start);
+
+  start = micros();
+  for (int x = 0; x < BENCH_ITERATIONS; x++)
+    RADIO.WriteReg(A7105_1D_RSSI_THOLD, (byte)(0x40 + (x & 1)));
+  print_result(PSTR("WRITE_REG_TEMPLATE"), micros() - start);
+
+  //The baseline writes bypassed the shadow cache, so start it over
+  A7105_Shadow_Invalidate(&RADIO.radio);
+
+  start = micros();
+  for (int x = 0; x < BENCH_ITERATIONS; x++)
+    BUFFER[0] = digitalwrite_read_reg(A7105_1D_RSSI_THOLD);
+  print_result(PSTR("READ_REG_DIGITALWRITE"), micros() - start);
+
+  start = micros();
+  for (int x = 0; x < BENCH_ITERATIONS; x++)
+    BUFFER[0] = A7105_ReadReg(&RADIO.radio, A7105_1D_RSSI_THOLD);
+  print_result(PSTR("READ_REG"), micros() - start);
+
+  start = micros();
+  for (int x = 0; x < BENCH_ITERATIONS; x++)
+    BUFFER[0] = RADIO.ReadReg(A7105_1D_RSSI_THOLD);
+  print_result(PSTR("READ_REG_TEMPLATE"), micros() - start);
+}
+
+void setup() {
+  Serial.begin(115200);
+
+  pinMode(MOSI,OUTPUT);
+  pinMode(MISO,INPUT);
+  pinMode(SCK,OUTPUT);
+
+  A7105_Status_Code ret = RADIO.Easy_Setup_Radio(RADIO_IDS,
+                                                 A7105_DATA_RATE_125Kbps,
+                                                 0,
+                                                 A7105_TXPOWER_150mW,
+                                                 1,1);
+  putstring("INIT,");
+  Serial.println(ret == A7105_STATUS_OK);
+  putstring("SPI_CLOCK_TRAINED,");
+  Serial.println(RADIO.radio._SPI_CLOCK);
+
+  //Benchmark at the same clock as the baselines (which have it as a constant)
+  RADIO.radio._SPI_CLOCK = A7105_SPI_CLOCK;
+}
+
+void loop() {
+  bench_fifo();
+  bench_reg_block();
+  bench_rearm();
+  bench_reg_access();
+  putstring("DONE\r\n");
+  delay(5000);
+}
@@ -0,0 +1,147 @@
+/*Copyright (C) 2015 Matthew Meno
+
+This file is part of ATmega A7105.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+(1) Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer. 
+
+(2) Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in
+the documentation and/or other materials provided with the
+distribution.  
+
+(3)The name of the author may not be used to
+endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "stdint.h"
+#include <SPI.h>
+#include <a7105.h> 
+
+
+/*
+  This sketch measures how long it takes from a falling edge on a WTR pin to the
+  handler the a7105 library attached to it (A7105_HAL_Attach_Falling()), which is 
+  the time that's lost before we can read a packet and re-arm RX. It doesn't need a
+  radio, EDGE_PIN stands in for GIO2 and is jumpered to both test pins:
+
+    * EXT_PIN (2):    INT0. Goes straight to the handler if the library was built with
+                      A7105_EXTERNAL_WTR_INTERRUPTS uncommented in a7105.h (PinChangeInt otherwise).
+    * PCINT_PIN (5):  Always goes through PinChangeInt.
+
+  Timer1 counts CPU cycles from just before EDGE_PIN is pulled low to the first line of 
+  the handler. Output is one comma delimited line per pin: NAME,AVG_CYCLES,MIN_CYCLES,MAX_CYCLES
+  (the few cycles it takes to pull EDGE_PIN low are in all of them).
+
+  Hookup Guide:
+    A bare Pro Mini (take the radio shield off, pin 5 isn't free on it), jumper pin 4 to 
+    pins 2 and 5. Serial port at 115200 baud.
+*/
+
+#define EDGE_PIN 4
+#define EXT_PIN 2
+#define PCINT_PIN 5
+
+#define BENCH_ITERATIONS 1000
+
+#define putstring(x) SerialPrint_P(PSTR(x))                             
+void SerialPrint_P(PGM_P str) {                                         
+  for (uint8_t c; (c = pgm_read_byte(str)); str++) Serial.write(c);     
+} 
+
+volatile uint16_t HANDLER_TCNT;
+volatile byte HANDLER_FIRED;
+
+//Stands in for _A7105_Pin_Interrupt_Callback()
+void latency_handler()
+{
+  HANDLER_TCNT = TCNT1;
+  HANDLER_FIRED = true;
+}
+
+void bench_pin(PGM_P name, int pin)
+{
+  volatile uint8_t* edge_port = portOutputRegister(digitalPinToPort(EDGE_PIN));
+  uint8_t edge_mask = digitalPinToBitMask(EDGE_PIN);
+
+  A7105_HAL_Pin_Input(pin);
+  A7105_HAL_Attach_Falling(pin, latency_handler);
+
+  //Keep the serial and millis() interrupts out of the way
+  Serial.flush();
+  uint8_t timsk0 = TIMSK0;
+  TIMSK0 = 0;
+
+  unsigned long total = 0;
+  uint16_t best = 0xFFFF;
+  uint16_t worst = 0;
+  for (int x = 0; x < BENCH_ITERATIONS; x++)
+  {
+    *edge_port |= edge_mask;
+    delayMicroseconds(20);
+    HANDLER_FIRED = false;
+
+    uint16_t start = TCNT1;
+    *edge_port &= ~edge_mask;
+    while (!HANDLER_FIRED)
+      ;
+
+    uint16_t cycles = HANDLER_TCNT - start;
+    total += cycles;
+    best = (cycles < best) ? cycles : best;
+    worst = (cycles > worst) ? cycles : worst;
+  }
+
+  TIMSK0 = timsk0;
+  A7105_HAL_Detach(pin);
+  *edge_port |= edge_mask;
+
+  SerialPrint_P(name);
+  putstring(",");
+  Serial.print(total / BENCH_ITERATIONS);
+  putstring(",");
+  Serial.print(best);
+  putstring(",");
+  Serial.println(worst);
+}
+
+void setup() {
+  Serial.begin(115200);
+
+  pinMode(EDGE_PIN, OUTPUT);
+  digitalWrite(EDGE_PIN, HIGH);
+
+  //Timer1 free running at the CPU clock
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10);
+
+#ifdef A7105_EXTERNAL_WTR_INTERRUPTS
+  putstring("EXTERNAL_WTR_INTERRUPTS,1\r\n");
+#else
+  putstring("EXTERNAL_WTR_INTERRUPTS,0\r\n");
+#endif
+}
+
+void loop() {
+  bench_pin(PSTR("INT0_PIN"), EXT_PIN);
+  bench_pin(PSTR("PCINT_PIN"), PCINT_PIN);
+  putstring("DONE\r\n");
+  delay(5000);
+}
@@ -33,18 +33,128 @@ POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include <stdint.h>
-#include <SPI.h>
 #include "a7105.h"
-#include "PinChangeInt.h"
 
-//HACK: A 328P only has 19 pins, but we oversize this array to try to keep things agnostic to the different AVR chips
-volatile byte _A7105_INTERRUPT_COUNTS[64]; //Interrupt tracking for radio RX notifications (0 = ignore for one interrupt, 1 = no interrupts, 2 = interrupt detected)
+#ifdef A7105_ASYNC_SPI_ENGINE
+#include <util/atomic.h>
+#endif
+
+#ifdef A7105_CALIBRATION_CACHE
+#include <avr/eeprom.h>
+#endif
+
+//Radios with WTR interrupts set up (so the pin change callback can find the radio for a pin)
+struct A7105* volatile _A7105_RADIOS[A7105_MAX_RADIOS];
+
+//SPI transfer engine state (ring buffer of transfers, the one at START is on the wire)
+struct A7105_SPI_Transfer _A7105_SPI_QUEUE[A7105_SPI_QUEUE_SIZE];
+volatile byte _A7105_SPI_QUEUE_START = 0;
+volatile byte _A7105_SPI_QUEUE_LENGTH = 0;
+volatile int _A7105_SPI_POSITION = -1; //Data byte currently on the wire (-1 = command byte)
+struct A7105_TX_Segment* volatile _A7105_SPI_SEGMENT; //Segment the next gathered byte comes from
+volatile byte _A7105_SPI_SEGMENT_POS; //and where in it
+
+//Polled SPI transactions in progress (see _A7105_SPI_Claim()) and whether any
+//radio has a packet waiting for the bus to copy into its RX ring
+volatile byte _A7105_SPI_CLAIMED = 0;
+volatile byte _A7105_RX_RING_PENDING = 0;
+
+void _A7105_SPI_Run_Polled(struct A7105_SPI_Transfer* transfer);
+static A7105_Status_Code _A7105_SPI_Enqueue(struct A7105_SPI_Transfer* transfer);
+static void _A7105_RX_Ring_Service();
+
+/*
+  Internal use only, chip select helpers. On AVR these write the pin's port
+  register directly (the port/mask are looked up once in A7105_Initialize)
+  instead of paying for digitalWrite()'s table lookups on every transfer.
+  The interrupt guard keeps the read-modify-write safe from ISRs that touch
+  other pins on the same port. Everywhere else the HAL drives the pin.
+*/
+static inline void _A7105_Select(struct A7105* radio)
+{
+#ifdef __AVR__
+  byte lock = A7105_HAL_Lock();
+  *(radio->_CS_PORT) &= ~(radio->_CS_MASK);
+  A7105_HAL_Unlock(lock);
+#else
+  A7105_HAL_Pin_Write(radio->_CS_PIN,LOW);
+#endif
+}
+
+static inline void _A7105_Deselect(struct A7105* radio)
+{
+#ifdef __AVR__
+  byte lock = A7105_HAL_Lock();
+  *(radio->_CS_PORT) |= radio->_CS_MASK;
+  A7105_HAL_Unlock(lock);
+#else
+  A7105_HAL_Pin_Write(radio->_CS_PIN,HIGH);
+#endif
+}
+
+/*
+  Internal use only, clears 'mask' from the radio's WTR event flags. The
+  interrupt guard keeps the WTR pin interrupt from setting a flag in the
+  middle of the read-modify-write (and us clobbering it).
+*/
+static inline void _A7105_Clear_Events(struct A7105* radio, byte mask)
+{
+  byte lock = A7105_HAL_Lock();
+  radio->_EVENTS &= ~mask;
+  A7105_HAL_Unlock(lock);
+}
+
+/*
+  Internal use only, returns true if 'len' is a packet length the Easy 
+  FIFO functions support (1 or a multiple of 8 up to the FIFO size).
+*/
+static inline byte _A7105_Valid_FIFO_Length(byte len)
+{
+  return len == 1 || (len > 0 && len <= A7105_MAX_FIFO_SIZE && (len % 8) == 0);
+}
+
+/*
+  Internal use only, RX ring bookkeeping. The head/tail counters run from 0 
+  to 2*_RX_RING_SIZE-1 so a full ring can be told apart from an empty one 
+  without giving up a slot.
+*/
+static inline byte _A7105_RX_Ring_Count(struct A7105* radio)
+{
+  byte head = radio->_RX_RING_HEAD;
+  byte tail = radio->_RX_RING_TAIL;
+  return (head >= tail) ? head - tail : head + 2*radio->_RX_RING_SIZE - tail;
+}
+
+static inline struct A7105_RX_Frame* _A7105_RX_Ring_Slot(struct A7105* radio, byte counter)
+{
+  return &(radio->_RX_RING[(counter < radio->_RX_RING_SIZE) ? counter : counter - radio->_RX_RING_SIZE]);
+}
+
+static inline byte _A7105_RX_Ring_Next(struct A7105* radio, byte counter)
+{
+  return (counter + 1 < 2*radio->_RX_RING_SIZE) ? counter + 1 : 0;
+}
 
 void A7105_Initialize(struct A7105* radio, int chip_select_pin)
 {
   A7105_Initialize(radio,chip_select_pin,1);
 }
 
+/*
+  Internal use only, sets up 4-wire SPI communication and uses GPIO2 as a WTR pin (high when 
+  transmitting/receiving) for interrupts after a reset (with 3-wire SPI, the radio's default 
+  after a reset, GPIO1 is TMEO for A7105_Set_TX_Done_Pin() instead).
+*/
+static void _A7105_Setup_GPIO(struct A7105* radio)
+{
+#ifdef A7105_3WIRE_SPI
+  A7105_WriteReg(radio,A7105_0B_GPIO1_PIN,(byte)A7105_GPIO_TMEO);
+#else
+  A7105_WriteReg(radio,A7105_0B_GPIO1_PIN,(byte)A7105_ENABLE_4WIRE);
+#endif
+  A7105_WriteReg(radio,A7105_0C_GPIO2_PIN,(byte)A7105_GPIO_WTR);
+}
+
 /*
   NOTE: This function must be called from setup()
         since we're setting pin modes (not sure if this is
@@ -52,48 +162,195 @@ void A7105_Initialize(struct A7105* radio, int chip_select_pin)
 */
 void A7105_Initialize(struct A7105* radio, int chip_select_pin, int reset)
 {
-  SPI.begin();
+  A7105_HAL_SPI_Begin();
   
-  pinMode(chip_select_pin, OUTPUT);
+  A7105_HAL_Pin_Output(chip_select_pin);
 
   //Initialize the chip select pin (HACK: Assume the pin is in OUTPUT mode, do we need to worry about doing this outside of setup()?)
   radio->_CS_PIN = chip_select_pin;
-  digitalWrite(radio->_CS_PIN,HIGH);
+#ifdef __AVR__
+  radio->_CS_PORT = portOutputRegister(digitalPinToPort(chip_select_pin));
+  radio->_CS_MASK = digitalPinToBitMask(chip_select_pin);
+#endif
+  _A7105_Deselect(radio);
+
+  //Start at the default clock, A7105_Train_SPI_Clock() can speed it up
+  radio->_SPI_CLOCK = A7105_SPI_CLOCK;
+
+  //No RX ring until A7105_RX_Ring_Begin()
+  radio->_RX_RING = NULL;
+  radio->_RX_RING_PENDING = 0;
+
+  //Start with an empty shadow register cache
+  radio->_WRITES_ELIDED = 0;
+  radio->_STROBES_ELIDED = 0;
+  A7105_Shadow_Invalidate(radio);
+
+  radio->_RSSI_THOLD = A7105_DEFAULT_RSSI_THOLD;
+
+  //Use the default calibration cache region (A7105_Easy_Setup_Radio() can override this)
+#ifdef A7105_CALIBRATION_CACHE
+  radio->_CAL_EEPROM_ADDR = A7105_CAL_EEPROM_ADDR;
+#else
+  radio->_CAL_EEPROM_ADDR = -1;
+#endif
+
+  //Reset the radio and set up its GPIO pins
+  A7105_Reset(radio);
+#ifdef A7105_3WIRE_SPI
+  radio->_TX_DONE_PIN = -1;
+#endif
+  _A7105_Setup_GPIO(radio);
 
-  //Reset the radio, set-up 4-wire SPI communication and use GPIO2 as a WTR pin (high when transmitting/receiving) for interrupts
+}
+
+/*
+  Internal use only, writes 'rounds' test patterns to the ID register at the 
+  radio's current clock and returns true if they all read back intact.
+*/
+byte _A7105_SPI_Training_Passes(struct A7105* radio, uint16_t rounds)
+{
+  byte pattern[4];
+  byte readback[4];
+  for (uint16_t round = 0; round < rounds; round++)
+  {
+    //Alternating bits (worst case for the clock edges) and a walking one/zero
+    byte bit = 1 << (round & 0x07);
+    pattern[0] = (round & 0x01) ? 0xAA : 0x55;
+    pattern[1] = (round & 0x01) ? 0x55 : 0xAA;
+    pattern[2] = bit;
+    pattern[3] = ~bit;
+
+    A7105_WriteBurst(radio, A7105_06_ID_DATA, pattern, 4);
+    A7105_ReadBurst(radio, A7105_06_ID_DATA, readback, 4);
+    if (memcmp(pattern, readback, 4) != 0)
+      return false;
+  }
+  return true;
+}
+
+uint32_t A7105_Train_SPI_Clock(struct A7105* radio)
+{
+  //Work up from the slowest clock until one fails
+  uint32_t passed = 0;
+  uint32_t previous = 0;
+  for (byte step = A7105_SPI_TRAINING_STEPS; step > 0; step--)
+  {
+    radio->_SPI_CLOCK = A7105_SPI_CLOCK_MAX >> (step - 1);
+    if (!_A7105_SPI_Training_Passes(radio, A7105_SPI_TRAINING_ROUNDS))
+      break;
+    previous = passed;
+    passed = radio->_SPI_CLOCK;
+  }
+
+  //For margin, the fastest clock that passed has to pass a much longer run too
+  //(otherwise back off a step, unless there's nothing slower that passed)
+  if (passed != 0 && previous != 0)
+  {
+    radio->_SPI_CLOCK = passed;
+    if (!_A7105_SPI_Training_Passes(radio, A7105_SPI_TRAINING_CONFIRM_ROUNDS))
+      passed = previous;
+  }
+
+  radio->_SPI_CLOCK = passed ? passed : (A7105_SPI_CLOCK_MAX >> (A7105_SPI_TRAINING_STEPS - 1));
+
+  //A garbled probe can write any register (00h resets the chip), start the radio 
+  //over at the clock we picked
   A7105_Reset(radio);
-  A7105_WriteReg(radio,A7105_0B_GPIO1_PIN,(byte)A7105_ENABLE_4WIRE);
-  A7105_WriteReg(radio,A7105_0C_GPIO2_PIN,(byte)A7105_GPIO_WTR);
+  _A7105_Setup_GPIO(radio);
+  return passed;
+}
+
+void A7105_Shadow_Invalidate(struct A7105* radio)
+{
+  memset(radio->_SHADOW_VALID, 0, sizeof(radio->_SHADOW_VALID));
+  radio->_STATE = 0;
+}
+
+/*
+  Internal use only, returns true if 'data' needs to be written to 'address'
+  (and records it in the shadow cache) or false if the radio already has it.
+*/
+byte _A7105_Shadow_Update(struct A7105* radio, byte address, byte data)
+{
+  //Don't cache registers with side effects or that the radio changes by itself
+  //(reset, auto-clearing calibration bits, FIFO and ID streams)
+  if (address >= A7105_NUM_REGISTERS ||
+      address == A7105_00_MODE ||
+      address == A7105_02_CALC ||
+      address == A7105_05_FIFO_DATA ||
+      address == A7105_06_ID_DATA)
+    return true;
+
+  byte valid_mask = 1 << (address % 8);
+  if ((radio->_SHADOW_VALID[address/8] & valid_mask) &&
+      radio->_SHADOW_REGS[address] == data)
+  {
+    radio->_WRITES_ELIDED++;
+    return false;
+  }
+
+  radio->_SHADOW_REGS[address] = data;
+  radio->_SHADOW_VALID[address/8] |= valid_mask;
+  return true;
+}
+
+/*
+  Internal use only, returns true if 'state' needs to be strobed or false if
+  the radio is already sitting in that (idle type) mode. Tracks the last mode
+  strobed in radio->_STATE.
+*/
+byte _A7105_Shadow_Strobe(struct A7105* radio, enum A7105_State state)
+{
+  //FIFO pointer resets are always sent and don't change the mode
+  if (state == A7105_RST_WRPTR || state == A7105_RST_RDPTR)
+    return true;
+
+  //Only the idle-type states are safe to skip, re-strobing RX/TX/PLL 
+  //restarts what the radio is doing
+  if (radio->_STATE == state &&
+      (state == A7105_STANDBY || state == A7105_IDLE || state == A7105_SLEEP))
+  {
+    radio->_STROBES_ELIDED++;
+    return false;
+  }
 
+  radio->_STATE = state;
+  return true;
 }
 
 void A7105_WriteReg(struct A7105* radio, byte address, byte data)
 {
-  digitalWrite(radio->_CS_PIN,LOW);
-  //NOTE: The A7105 only speaks MSBFIRST,SPI Mode 0, the variable clock rate is for debugging
-  SPI.beginTransaction(SPISettings(A7105_SPI_CLOCK, MSBFIRST, SPI_MODE0));  // gain control of SPI bus
+  //Skip the write if the radio already has this value
+  if (!_A7105_Shadow_Update(radio, address, data))
+    return;
+
+  //Let any queued transfers finish first so we don't stomp on the bus
+  A7105_SPI_Wait();
+
+  _A7105_SPI_Claim();
+  _A7105_Select(radio);
+  //NOTE: The A7105 only speaks MSBFIRST,SPI Mode 0, the clock is per radio (see A7105_Train_SPI_Clock())
+  A7105_HAL_SPI_Begin_Transaction(radio->_SPI_CLOCK);  // gain control of SPI bus
 
-  SPI.transfer(address);
-  SPI.transfer(data);
+  A7105_HAL_SPI_Transfer(address);
+  A7105_HAL_SPI_Transfer(data);
 
-  SPI.endTransaction();          // release the SPI bus
-  digitalWrite(radio->_CS_PIN,HIGH);
+  A7105_HAL_SPI_End_Transaction();          // release the SPI bus
+  _A7105_Deselect(radio);
+  _A7105_SPI_Release();
 }
 
 void A7105_WriteReg(struct A7105* radio, byte addr, uint32_t data)
 {
-  digitalWrite(radio->_CS_PIN,LOW);
-  //NOTE: The A7105 only speaks MSBFIRST,SPI Mode 0, the variable clock rate is for debugging
-  SPI.beginTransaction(SPISettings(A7105_SPI_CLOCK, MSBFIRST, SPI_MODE0));  // gain control of SPI bus
-
-  SPI.transfer(addr);
-  SPI.transfer((data >> 24) & 0xFF);
-  SPI.transfer((data >> 16) & 0xFF);
-  SPI.transfer((data >> 8) & 0xFF);
-  SPI.transfer((data >> 0) & 0xFF);
+  //MSB first
+  byte buffer[4];
+  buffer[0] = (data >> 24) & 0xFF;
+  buffer[1] = (data >> 16) & 0xFF;
+  buffer[2] = (data >> 8) & 0xFF;
+  buffer[3] = (data >> 0) & 0xFF;
   
-  SPI.endTransaction();          // release the SPI bus
-  digitalWrite(radio->_CS_PIN,HIGH);
+  A7105_WriteBurst(radio, addr, buffer, 4);
 }
 
 /*
@@ -102,68 +359,143 @@ void A7105_WriteReg(struct A7105* radio, byte addr, uint32_t data)
   NOTE: currently failure only happens on improper length data (must be multiple of 8 between 1 and 64)
 */
 A7105_Status_Code A7105_WriteData(struct A7105* radio, byte *dpbuffer, byte len)
+{
+  //Queue the TX and wait for it to be handed to the radio
+  A7105_SPI_Wait();
+  A7105_Status_Code ret = A7105_WriteData_Async(radio, dpbuffer, len, NULL, NULL);
+  A7105_SPI_Wait();
+  return ret;
+}
+
+/*
+  Internal use only, SPI callback for the standby strobe at the start of a TX.
+  The TX is only flagged as active once the radio is out of RX, so a packet
+  that finishes arriving before then is still taken for a packet (and not the
+  end of the TX). Any packet we received is about to be clobbered by the FIFO
+  write so drop that too.
+*/
+static void _A7105_TX_Standby_Done(struct A7105* radio, void* context)
+{
+  (void)context;
+  radio->_EVENTS = A7105_EVENT_TX_ACTIVE;
+}
+
+#ifdef A7105_3WIRE_SPI
+/*
+  Internal use only, SPI callback for the FIFO load of a TX on a radio with a
+  TX done pin. From here on a falling edge on GIO1 is the end of the TX (it 
+  was carrier detect before, see A7105_Set_TX_Done_Pin()).
+*/
+static void _A7105_TX_FIFO_Loaded(struct A7105* radio, void* context)
+{
+  (void)context;
+  radio->_EVENTS |= A7105_EVENT_TX_ON_AIR;
+}
+#endif
+
+/*
+  Internal use only, queues the whole TX sequence for A7105_WriteData_Async()
+  and A7105_WriteData_Gather(). The packet comes from 'dpbuffer' or, if it 
+  isn't NULL, 'segments'.
+*/
+static A7105_Status_Code _A7105_Queue_TX(struct A7105* radio,
+                                         byte *dpbuffer,
+                                         struct A7105_TX_Segment* segments,
+                                         byte len,
+                                         void (*callback)(struct A7105*,void*),
+                                         void* context)
 {
 
   //Check to make sure len is a multiple of 8 between 1 and 64
-  if (len != 1  &&
-      len != 8  &&
-      len != 16 &&
-      len != 32 &&
-      len != 64)
+  if (!_A7105_Valid_FIFO_Length(len))
   {
     return A7105_INVALID_FIFO_LENGTH;
   }
 
-  //Ensure we're not in RX mode (go back to standby)
-  A7105_Strobe(radio,A7105_STANDBY);
+  //Make sure we have room for the whole TX sequence (up to 6 transfers) so
+  //we don't leave the radio half set-up
+  if (A7105_SPI_QUEUE_SIZE - _A7105_SPI_QUEUE_LENGTH < 6)
+  {
+    return A7105_BUSY;
+  }
 
   //Make sure we aren't in the middle of a TX right now (only works
   //if a WTR pin was set, otherwise just hope for the best)
-  if (radio->_INTERRUPT_PIN > 0)
+  if (radio->_INTERRUPT_PIN > 0 && (radio->_EVENTS & A7105_EVENT_TX_ACTIVE))
   {
-    if ( _A7105_INTERRUPT_COUNTS[radio->_INTERRUPT_PIN] == A7105_INT_IGNORE_ONE)
-    {
-      return A7105_BUSY;
-    }
-
-    //If we have interrupts enabled (and arent busy), ignore the next one
-    //which will be set when we finish transmitting
-    _A7105_INTERRUPT_COUNTS[radio->_INTERRUPT_PIN] = A7105_INT_IGNORE_ONE;
+    return A7105_BUSY;
   }
 
+  //Ensure we're not in RX mode (go back to standby). If we have interrupts
+  //enabled, the next one after that is the end of this TX (see 
+  //_A7105_TX_Standby_Done()), if we're already in standby it's the next one.
+  if (_A7105_Shadow_Strobe(radio, A7105_STANDBY))
+    A7105_SPI_Queue(radio, A7105_STANDBY, 0, NULL, NULL, 0, 
+                    (radio->_INTERRUPT_PIN > 0) ? _A7105_TX_Standby_Done : NULL, NULL);
+  else if (radio->_INTERRUPT_PIN > 0)
+    radio->_EVENTS = A7105_EVENT_TX_ACTIVE;
+
   //Set the length of the FIFO data to send (len - 1 since it's an end-pointer)
-  A7105_WriteReg(radio, A7105_03_FIFO_I, (byte)(len-1));
+  //(skipped if it's the same length as last time)
+  if (_A7105_Shadow_Update(radio, A7105_03_FIFO_I, (byte)(len-1)))
+    A7105_SPI_Queue(radio, A7105_03_FIFO_I, (byte)(len-1), NULL, NULL, 1, NULL, NULL);
 
-  //Reset the FIFO write pointer
-  A7105_Strobe(radio,A7105_RST_WRPTR);
+  //Put the FIFO back to its default layout if A7105_SetFIFOSegment() or 
+  //the extended FIFO functions changed it (normally skipped by the shadow cache)
+  if (_A7105_Shadow_Update(radio, A7105_04_FIFO_II, (byte)0x00))
+    A7105_SPI_Queue(radio, A7105_04_FIFO_II, 0x00, NULL, NULL, 1, NULL, NULL);
 
-  digitalWrite(radio->_CS_PIN,LOW);
-  SPI.beginTransaction(SPISettings(A7105_SPI_CLOCK, MSBFIRST, SPI_MODE0));  // gain control of SPI bus
+  //Reset the FIFO write pointer
+  A7105_SPI_Queue(radio, A7105_RST_WRPTR, 0, NULL, NULL, 0, NULL, NULL);
 
-  SPI.transfer(A7105_05_FIFO_DATA);
-  for (int i = 0; i < len; i++)
-    SPI.transfer(dpbuffer[i]); // send some data
-   
-  SPI.endTransaction();          // release the SPI bus
-  digitalWrite(radio->_CS_PIN,HIGH);
+  //Push the whole packet in a single chip-select window
+  struct A7105_SPI_Transfer transfer = {radio, A7105_05_FIFO_DATA, 0, dpbuffer, NULL, len, NULL, NULL, segments};
+#ifdef A7105_3WIRE_SPI
+  if (radio->_TX_DONE_PIN > 0)
+    transfer.callback = _A7105_TX_FIFO_Loaded;
+#endif
+  _A7105_SPI_Enqueue(&transfer);
 
   //Tell the A7105 to blast the data
-  A7105_Strobe(radio,A7105_TX);
+  _A7105_Shadow_Strobe(radio, A7105_TX);
+  A7105_SPI_Queue(radio, A7105_TX, 0, NULL, NULL, 0, callback, context);
  
   return A7105_STATUS_OK;
 }
 
+A7105_Status_Code A7105_WriteData_Async(struct A7105* radio,
+                                        byte *dpbuffer,
+                                        byte len,
+                                        void (*callback)(struct A7105*,void*),
+                                        void* context)
+{
+  return _A7105_Queue_TX(radio, dpbuffer, NULL, len, callback, context);
+}
+
+A7105_Status_Code A7105_WriteData_Gather(struct A7105* radio,
+                                         struct A7105_TX_Segment* segments,
+                                         byte len,
+                                         void (*callback)(struct A7105*,void*),
+                                         void* context)
+{
+  return _A7105_Queue_TX(radio, NULL, segments, len, callback, context);
+}
+
 byte A7105_ReadReg(struct A7105* radio, byte addr)
 {
+  //Let any queued transfers finish first so we don't stomp on the bus
+  A7105_SPI_Wait();
+
 //digitalWrite(RADIO_SCK,LOW);
   byte command = addr | 0x40;
-  digitalWrite(radio->_CS_PIN,LOW);
-  SPI.beginTransaction(SPISettings(A7105_SPI_CLOCK, MSBFIRST, SPI_MODE0));  // gain control of SPI bus
+  _A7105_SPI_Claim();
+  _A7105_Select(radio);
+  A7105_HAL_SPI_Begin_Transaction(radio->_SPI_CLOCK);  // gain control of SPI bus
 
   //shiftOut(RADIO_MOSI,RADIO_SCK, MSBFIRST, command);
   //byte read_byte = shiftIn(RADIO_MISO,RADIO_SCK,MSBFIRST);
-  SPI.transfer(command);
-  byte read_byte = SPI.transfer(0x00);
+  A7105_HAL_SPI_Transfer(command);
+  byte read_byte = A7105_HAL_SPI_Transfer(0x00);
 
   /*
   Serial.print("Read: ");
@@ -171,14 +503,88 @@ byte A7105_ReadReg(struct A7105* radio, byte addr)
   Serial.print(" : ");
   Serial.println(read_byte,HEX);
   */
-  SPI.endTransaction();          // release the SPI bus
-  digitalWrite(radio->_CS_PIN,HIGH);
+  A7105_HAL_SPI_End_Transaction();          // release the SPI bus
+  _A7105_Deselect(radio);
+  _A7105_SPI_Release();
   return read_byte;
 }
   
 
 
+void A7105_ReadBurst(struct A7105* radio, byte addr, byte* buffer, byte len)
+{
+  //The FIFO/ID registers keep streaming bytes as long as the chip-select is held
+  A7105_SPI_Transfer(radio, addr | 0x40, NULL, buffer, len);
+}
+
+void A7105_WriteBurst(struct A7105* radio, byte addr, byte* buffer, byte len)
+{
+  A7105_SPI_Transfer(radio, addr, buffer, NULL, len);
+}
+
+void A7105_ReadRegBlock(struct A7105* radio, byte start_addr, byte* buffer, byte len)
+{
+  A7105_SPI_Wait();
+  _A7105_SPI_Claim();
+  A7105_HAL_SPI_Begin_Transaction(radio->_SPI_CLOCK);  // gain control of SPI bus
+
+  //NOTE: Control registers don't auto-increment, so we re-address each one
+  //      but keep the bus for the whole block
+  for (byte i = 0; i < len; i++)
+  {
+    _A7105_Select(radio);
+    A7105_HAL_SPI_Transfer((start_addr + i) | 0x40);
+    buffer[i] = A7105_HAL_SPI_Transfer(0x00);
+    _A7105_Deselect(radio);
+  }
+
+  A7105_HAL_SPI_End_Transaction();          // release the SPI bus
+  _A7105_SPI_Release();
+}
+
+void A7105_WriteRegBlock(struct A7105* radio, byte start_addr, byte* buffer, byte len)
+{
+  A7105_SPI_Wait();
+  _A7105_SPI_Claim();
+  A7105_HAL_SPI_Begin_Transaction(radio->_SPI_CLOCK);  // gain control of SPI bus
+
+  for (byte i = 0; i < len; i++)
+  {
+    _A7105_Select(radio);
+    A7105_HAL_SPI_Transfer(start_addr + i);
+    A7105_HAL_SPI_Transfer(buffer[i]);
+    _A7105_Deselect(radio);
+  }
+
+  A7105_HAL_SPI_End_Transaction();          // release the SPI bus
+  _A7105_SPI_Release();
+}
+
 A7105_Status_Code A7105_ReadData(struct A7105* radio, byte *dpbuffer, byte len)
+{
+  return A7105_ReadData(radio, dpbuffer, len, NULL);
+}
+
+/*
+  Internal use only, copies the oldest packet in the radio's RX ring out
+  and releases its slot (A7105_ReadData() for radios with an RX ring).
+*/
+static A7105_Status_Code _A7105_RX_Ring_Read(struct A7105* radio, byte *dpbuffer, byte len, struct A7105_RX_Metadata* metadata)
+{
+  struct A7105_RX_Frame* frame = A7105_RX_Ring_Peek(radio);
+  if (frame == NULL)
+    return A7105_NO_DATA;
+
+  memcpy(dpbuffer, frame->data, (len < frame->len) ? len : frame->len);
+  A7105_Status_Code ret = frame->meta.status;
+  if (metadata != NULL)
+    *metadata = frame->meta;
+
+  A7105_RX_Ring_Pop(radio);
+  return ret;
+}
+
+A7105_Status_Code A7105_ReadData(struct A7105* radio, byte *dpbuffer, byte len, struct A7105_RX_Metadata* metadata)
 {
     //ensure len is a valid value
     if (len > A7105_MAX_FIFO_SIZE)
@@ -186,51 +592,337 @@ A7105_Status_Code A7105_ReadData(struct A7105* radio, byte *dpbuffer, byte len)
       return A7105_INVALID_FIFO_LENGTH;
     }
 
+    //The WTR interrupt already pulled the packet out of the FIFO
+    if (radio->_RX_RING != NULL)
+    {
+      return _A7105_RX_Ring_Read(radio, dpbuffer, len, metadata);
+    }
+
+    unsigned long timestamp = 0;
 
     //If the radio specified a WTR pin interrupt, use that data
     //to determine if there is any data waiting
-    if (radio->_INTERRUPT_PIN > 0 &&
-        _A7105_INTERRUPT_COUNTS[radio->_INTERRUPT_PIN] != A7105_INT_TRIGGERED)
+    if (radio->_INTERRUPT_PIN > 0)
     {
-      return A7105_NO_DATA;
+      if (!(radio->_EVENTS & A7105_EVENT_RX_READY))
+      {
+        return A7105_NO_DATA;
+      }
+
+      //The interrupt won't touch the timestamp again until we re-arm RX
+      timestamp = radio->_RX_TIMESTAMP;
+
+      //clear the RX event since we're reading
+      _A7105_Clear_Events(radio, A7105_EVENT_RX_READY);
     }
-    
     else
     {
-      //clear the interrupt counter since we're reading
-      _A7105_INTERRUPT_COUNTS[radio->_INTERRUPT_PIN] = A7105_INT_NULL;
+      timestamp = A7105_HAL_Micros();
     }
 
     //Reset the FIFO read pointer
     A7105_Strobe(radio, A7105_RST_RDPTR); 
 
-    for(int i = 0; i < len; i++) {
-        dpbuffer[i] = A7105_ReadReg(radio, A7105_05_FIFO_DATA);
-    }
+    //The radio drops back to standby by itself once a packet is received
+    //(we only know one was if the WTR interrupt told us so)
+    if (radio->_INTERRUPT_PIN > 0 && radio->_STATE == A7105_RX)
+      radio->_STATE = A7105_STANDBY;
+
+    //Drain the FIFO in a single chip-select window (instead of a 
+    //full register read per byte)
+    A7105_ReadBurst(radio, A7105_05_FIFO_DATA, dpbuffer, len);
 
     //check for CRC/FEC (if it's enabled)
     //NOTE: We read the data either way since the user
     //can decide if they have use for the data
+    A7105_Status_Code ret = A7105_STATUS_OK;
     if (radio->_USE_CRC || radio->_USE_FEC)
     {
       byte crc_fec_check = A7105_ReadReg(radio, A7105_00_MODE);
       if ((crc_fec_check & CRC_CHECK_MASK) ||
           (crc_fec_check & FEC_CHECK_MASK))
       {
-        return A7105_RX_DATA_INTEGRITY_ERROR;
+        ret = A7105_RX_DATA_INTEGRITY_ERROR;
       }
     }
 
+    //The auto RSSI measurement (see A7105_01_MODE_CONTROL in A7105_Easy_Setup_Radio()) 
+    //holds the reading for the last packet, reads of the RSSI threshold register return it
+    if (metadata != NULL)
+    {
+      metadata->rssi = A7105_ReadReg(radio, A7105_1D_RSSI_THOLD);
+      metadata->timestamp = timestamp;
+      metadata->status = ret;
+    }
+
+    return ret;
+}
+
+A7105_Status_Code A7105_ReadData_Async(struct A7105* radio,
+                                       byte *dpbuffer,
+                                       byte len,
+                                       void (*callback)(struct A7105*,void*),
+                                       void* context)
+{
+    //ensure len is a valid value
+    if (len > A7105_MAX_FIFO_SIZE)
+    {
+      return A7105_INVALID_FIFO_LENGTH;
+    }
+
+    //The WTR interrupt already pulled the packet out of the FIFO, nothing to queue
+    if (radio->_RX_RING != NULL)
+    {
+      A7105_Status_Code ret = _A7105_RX_Ring_Read(radio, dpbuffer, len, NULL);
+      if (ret == A7105_NO_DATA)
+        return ret;
+
+      radio->_RX_MODE = (ret == A7105_STATUS_OK) ? 0 : CRC_CHECK_MASK;
+      if (callback != NULL)
+        callback(radio, context);
+      return A7105_STATUS_OK;
+    }
+
+    //Make sure we have room for the reset, read and MODE snapshot
+    if (A7105_SPI_QUEUE_SIZE - _A7105_SPI_QUEUE_LENGTH < 3)
+    {
+      return A7105_BUSY;
+    }
+
+    //Same interrupt pin handling as A7105_ReadData()
+    if (radio->_INTERRUPT_PIN > 0)
+    {
+      if (!(radio->_EVENTS & A7105_EVENT_RX_READY))
+        return A7105_NO_DATA;
+
+      //clear the RX event since we're reading
+      _A7105_Clear_Events(radio, A7105_EVENT_RX_READY);
+    }
+
+    //The radio drops back to standby by itself once a packet is received
+    //(we only know one was if the WTR interrupt told us so)
+    if (radio->_INTERRUPT_PIN > 0 && radio->_STATE == A7105_RX)
+      radio->_STATE = A7105_STANDBY;
+
+    //Reset the read pointer, drain the FIFO and grab the MODE register (CRC/FEC flags)
+    //for A7105_Async_RX_Status()
+    radio->_RX_MODE = 0;
+    A7105_SPI_Queue(radio, A7105_RST_RDPTR, 0, NULL, NULL, 0, NULL, NULL);
+    A7105_SPI_Queue(radio, A7105_05_FIFO_DATA | 0x40, 0, NULL, dpbuffer, len, NULL, NULL);
+    A7105_SPI_Queue(radio, A7105_00_MODE | 0x40, 0, NULL, &(radio->_RX_MODE), 1, callback, context);
+
     return A7105_STATUS_OK;
 }
 
+A7105_Status_Code A7105_Async_RX_Status(struct A7105* radio)
+{
+  if ((radio->_USE_CRC || radio->_USE_FEC) &&
+      ((radio->_RX_MODE & CRC_CHECK_MASK) ||
+       (radio->_RX_MODE & FEC_CHECK_MASK)))
+  {
+    return A7105_RX_DATA_INTEGRITY_ERROR;
+  }
+  return A7105_STATUS_OK;
+}
+
+A7105_Status_Code A7105_SetFIFOSegment(struct A7105* radio, byte start, byte len)
+{
+  if (len == 0 || (uint16_t)start + len > A7105_MAX_FIFO_SIZE)
+    return A7105_INVALID_FIFO_LENGTH;
+
+  //In segment mode the start (PSA) and end (FEP) pointers are both FIFO addresses
+  A7105_WriteReg(radio, A7105_04_FIFO_II, (byte)(start & 0x3F));
+  A7105_WriteReg(radio, A7105_03_FIFO_I, (byte)(start + len - 1));
+
+  return A7105_STATUS_OK;
+}
+
+/*
+  Internal use only, waits for the FPF pin (GIO2 in FIFO extension mode) 
+  to go high. Returns false if it took longer than 'timeout' milliseconds.
+*/
+static byte _A7105_Wait_FPF(struct A7105* radio, unsigned long timeout)
+{
+  unsigned long start = A7105_HAL_Millis();
+  while (A7105_HAL_Pin_Read(radio->_INTERRUPT_PIN) == LOW)
+  {
+    if (A7105_HAL_Millis() - start > timeout)
+      return false;
+  }
+  return true;
+}
+
+/*
+  Internal use only, waits for the radio to finish a TX/RX (the TRX circuitry
+  goes idle). Returns false if it took longer than 'timeout' milliseconds.
+*/
+static byte _A7105_Wait_TRX_Idle(struct A7105* radio, unsigned long timeout)
+{
+  unsigned long start = A7105_HAL_Millis();
+  while (A7105_ReadReg(radio, A7105_00_MODE) & 0x01)
+  {
+    if (A7105_HAL_Millis() - start > timeout)
+      return false;
+  }
+  return true;
+}
+
+/*
+  Internal use only, sets the radio up for FIFO extension mode (end pointer
+  for the whole packet, FIFO pointer margin and GIO2 as FPF) and puts it back.
+*/
+static void _A7105_FIFO_Extended_Begin(struct A7105* radio, uint16_t len)
+{
+  A7105_Strobe(radio, A7105_STANDBY);
+  A7105_WriteReg(radio, A7105_03_FIFO_I, (byte)(len-1));
+  A7105_WriteReg(radio, A7105_04_FIFO_II, (byte)A7105_FIFO_EXT_MARGIN);
+  A7105_WriteReg(radio, A7105_0C_GPIO2_PIN, (byte)A7105_GPIO_FPF);
+}
+
+static void _A7105_FIFO_Extended_End(struct A7105* radio)
+{
+  //Stop anything we gave up on (skipped if the TX/RX finished)
+  A7105_Strobe(radio, A7105_STANDBY);
+  A7105_WriteReg(radio, A7105_0C_GPIO2_PIN, (byte)A7105_GPIO_WTR);
+  A7105_WriteReg(radio, A7105_04_FIFO_II, (byte)0x00);
+
+  //The FPF edges went through the WTR interrupt, forget them
+  radio->_EVENTS = 0;
+}
+
+A7105_Status_Code A7105_WriteData_Extended(struct A7105* radio, byte *dpbuffer, uint16_t len)
+{
+  //We need to watch GIO2 to know when to top up the FIFO
+  if (radio->_INTERRUPT_PIN <= 0)
+    return A7105_NO_WTR_INTERRUPT_SET;
+
+  //The RX ring would take the FPF edges for received packets
+  if (radio->_RX_RING != NULL)
+    return A7105_BUSY;
+
+  if (len == 0 || len > A7105_MAX_EXTENDED_FIFO_SIZE)
+    return A7105_INVALID_FIFO_LENGTH;
+
+  _A7105_FIFO_Extended_Begin(radio, len);
+
+  //Pre-load as much of the packet as will fit and start sending
+  uint16_t sent = (len < A7105_MAX_FIFO_SIZE) ? len : A7105_MAX_FIFO_SIZE;
+  A7105_Strobe(radio, A7105_RST_WRPTR);
+  A7105_WriteBurst(radio, A7105_05_FIFO_DATA, dpbuffer, (byte)sent);
+  A7105_Strobe(radio, A7105_TX);
+
+  //Top up the FIFO each time the radio says it's running low
+  A7105_Status_Code ret = A7105_STATUS_OK;
+  while (sent < len)
+  {
+    if (!_A7105_Wait_FPF(radio, A7105_FIFO_EXT_TIMEOUT))
+    {
+      ret = A7105_BUSY;
+      break;
+    }
+
+    byte chunk = (len - sent < A7105_FIFO_EXT_CHUNK) ? (byte)(len - sent) : A7105_FIFO_EXT_CHUNK;
+    A7105_WriteBurst(radio, A7105_05_FIFO_DATA, dpbuffer + sent, chunk);
+    sent += chunk;
+  }
+
+  //Wait for the tail of the packet to go out
+  if (ret == A7105_STATUS_OK && _A7105_Wait_TRX_Idle(radio, A7105_FIFO_EXT_TIMEOUT))
+    radio->_STATE = A7105_STANDBY;
+  else
+    ret = A7105_BUSY;
+
+  _A7105_FIFO_Extended_End(radio);
+  return ret;
+}
+
+A7105_Status_Code A7105_ReadData_Extended(struct A7105* radio, byte *dpbuffer, uint16_t len, unsigned long timeout)
+{
+  //We need to watch GIO2 to know when to drain the FIFO
+  if (radio->_INTERRUPT_PIN <= 0)
+    return A7105_NO_WTR_INTERRUPT_SET;
+
+  //The RX ring would take the FPF edges for received packets
+  if (radio->_RX_RING != NULL)
+    return A7105_BUSY;
+
+  if (len == 0 || len > A7105_MAX_EXTENDED_FIFO_SIZE)
+    return A7105_INVALID_FIFO_LENGTH;
+
+  _A7105_FIFO_Extended_Begin(radio, len);
+  A7105_Strobe(radio, A7105_RST_RDPTR);
+  A7105_Strobe(radio, A7105_RX);
+
+  //Pull full chunks out as they arrive (the first wait covers the packet showing up),
+  //the last partial chunk is read once the RX is done
+  A7105_Status_Code ret = A7105_STATUS_OK;
+  uint16_t received = 0;
+  unsigned long wait = timeout;
+  while (len - received > A7105_FIFO_EXT_CHUNK)
+  {
+    if (!_A7105_Wait_FPF(radio, wait))
+    {
+      ret = A7105_NO_DATA;
+      break;
+    }
+
+    A7105_ReadBurst(radio, A7105_05_FIFO_DATA, dpbuffer + received, A7105_FIFO_EXT_CHUNK);
+    received += A7105_FIFO_EXT_CHUNK;
+    wait = A7105_FIFO_EXT_TIMEOUT;
+  }
+
+  if (ret == A7105_STATUS_OK && _A7105_Wait_TRX_Idle(radio, wait))
+  {
+    //The radio drops back to standby by itself once the packet is in
+    radio->_STATE = A7105_STANDBY;
+    A7105_ReadBurst(radio, A7105_05_FIFO_DATA, dpbuffer + received, (byte)(len - received));
+
+    //check for CRC/FEC (if it's enabled)
+    if (radio->_USE_CRC || radio->_USE_FEC)
+    {
+      byte crc_fec_check = A7105_ReadReg(radio, A7105_00_MODE);
+      if ((crc_fec_check & CRC_CHECK_MASK) ||
+          (crc_fec_check & FEC_CHECK_MASK))
+      {
+        ret = A7105_RX_DATA_INTEGRITY_ERROR;
+      }
+    }
+  }
+  else
+    ret = A7105_NO_DATA;
+
+  _A7105_FIFO_Extended_End(radio);
+  return ret;
+}
+
 A7105_Status_Code A7105_CheckTXFinished(struct A7105* radio)
 {
 
   //Serial.println("DEBUG: CheckTxFinished");
+  //With a WTR pin, A7105_WriteData_Async() flagged the TX as active and the
+  //falling edge at the end of the TX clears that, so we're busy until it's
+  //been seen (no need to touch the SPI bus)
+  //NOTE: Yielding lets callers spin on this (it's empty on AVRs, the host
+  //      emulator moves its clock forward)
+  if (radio->_INTERRUPT_PIN > 0 &&
+      (radio->_EVENTS & A7105_EVENT_TX_ACTIVE))
+  {
+    A7105_HAL_Yield();
+    return A7105_BUSY;
+  }
+
+  //Confirm with the radio (the edge could have come from an RX we aborted). A TX
+  //done pin only falls at the end of the TX, so there's nothing to check.
+#ifdef A7105_3WIRE_SPI
+  if (radio->_TX_DONE_PIN <= 0)
+#endif
   if (A7105_ReadReg(radio, A7105_00_MODE) & 0x01)
     return  A7105_BUSY;
 
+  //The radio drops back to standby by itself once the packet is sent
+  if (radio->_STATE == A7105_TX)
+    radio->_STATE = A7105_STANDBY;
+
   return A7105_STATUS_OK;
 }
 
@@ -241,8 +933,21 @@ A7105_Status_Code A7105_CheckRXWaiting(struct A7105* radio)
   //to determine if there is any data waiting
   if (radio->_INTERRUPT_PIN > 0)
   {
-    if (_A7105_INTERRUPT_COUNTS[radio->_INTERRUPT_PIN] != A7105_INT_TRIGGERED)
+    //The WTR interrupt already checked the CRC/FEC flags for packets in the ring
+    if (radio->_RX_RING != NULL)
     {
+      struct A7105_RX_Frame* frame = A7105_RX_Ring_Peek(radio);
+      if (frame == NULL)
+      {
+        A7105_HAL_Yield(); //see A7105_CheckTXFinished()
+        return A7105_NO_DATA;
+      }
+      return (frame->meta.status == A7105_STATUS_OK) ? A7105_RX_DATA_WAITING : A7105_RX_DATA_INTEGRITY_ERROR;
+    }
+
+    if (!(radio->_EVENTS & A7105_EVENT_RX_READY))
+    {
+      A7105_HAL_Yield(); //see A7105_CheckTXFinished()
       return A7105_NO_DATA;
     }
 
@@ -251,30 +956,392 @@ A7105_Status_Code A7105_CheckRXWaiting(struct A7105* radio)
       //check for CRC/FEC only if it's enabled (otherwise we're just wasting cycles)
       if (radio->_USE_CRC || radio->_USE_FEC)
       {
-        //Serial.println("DEBUG: CheckRXWaiting");
-        byte crc_fec_check = A7105_ReadReg(radio, A7105_00_MODE);
-        if ((crc_fec_check & CRC_CHECK_MASK) ||
-            (crc_fec_check & FEC_CHECK_MASK))
-        {
-          //Serial.println("DEBUG: Data integrity error");
-          return A7105_RX_DATA_INTEGRITY_ERROR;
-        }
+        //Serial.println("DEBUG: CheckRXWaiting");
+        byte crc_fec_check = A7105_ReadReg(radio, A7105_00_MODE);
+        if ((crc_fec_check & CRC_CHECK_MASK) ||
+            (crc_fec_check & FEC_CHECK_MASK))
+        {
+          //Serial.println("DEBUG: Data integrity error");
+          return A7105_RX_DATA_INTEGRITY_ERROR;
+        }
+      }
+
+
+      return  A7105_RX_DATA_WAITING;
+    }
+  }
+  return A7105_NO_WTR_INTERRUPT_SET;
+}
+
+//Run a transfer by polling the SPI hardware (the bus must be idle)
+void _A7105_SPI_Run_Polled(struct A7105_SPI_Transfer* transfer)
+{
+  _A7105_Select(transfer->radio);
+  A7105_HAL_SPI_Begin_Transaction(transfer->radio->_SPI_CLOCK);  // gain control of SPI bus
+
+  A7105_HAL_SPI_Transfer(transfer->command);
+  if (transfer->segments == NULL)
+  {
+    A7105_HAL_SPI_Transfer_Block(transfer->tx_buffer, transfer->data, transfer->rx_buffer, transfer->len);
+  }
+  else
+  {
+    //Each segment in turn (cut off at 'len'), then pad out the rest
+    byte left = transfer->len;
+    for (struct A7105_TX_Segment* segment = transfer->segments; segment->len > 0 && left > 0; segment++)
+    {
+      byte len = (segment->len < left) ? segment->len : left;
+      A7105_HAL_SPI_Transfer_Block(segment->data, 0, NULL, len);
+      left -= len;
+    }
+    A7105_HAL_SPI_Transfer_Block(NULL, transfer->data, NULL, left);
+  }
+
+  A7105_HAL_SPI_End_Transaction();          // release the SPI bus
+  _A7105_Deselect(transfer->radio);
+}
+
+#ifdef A7105_ASYNC_SPI_ENGINE
+//Put the transfer at the front of the queue on the wire (interrupts must be disabled)
+void _A7105_SPI_Start_Next()
+{
+  struct A7105_SPI_Transfer* transfer = &(_A7105_SPI_QUEUE[_A7105_SPI_QUEUE_START]);
+
+  _A7105_Select(transfer->radio);
+  A7105_HAL_SPI_Begin_Transaction(transfer->radio->_SPI_CLOCK);  // gain control of SPI bus
+
+  //NOTE: beginTransaction() rewrites SPCR, so enable the interrupt after it
+  _A7105_SPI_POSITION = -1;
+  _A7105_SPI_SEGMENT = transfer->segments;
+  _A7105_SPI_SEGMENT_POS = 0;
+  SPCR |= _BV(SPIE);
+  SPDR = transfer->command;
+}
+
+//Next data byte of a transfer with segments (the transfer's 'data' once they run out)
+static inline byte _A7105_SPI_Gather_Byte(struct A7105_SPI_Transfer* transfer)
+{
+  struct A7105_TX_Segment* segment = _A7105_SPI_SEGMENT;
+  if (segment->len == 0)
+    return transfer->data;
+
+  byte out = segment->data ? segment->data[_A7105_SPI_SEGMENT_POS] : 0;
+  if (++_A7105_SPI_SEGMENT_POS == segment->len)
+  {
+    _A7105_SPI_SEGMENT = segment + 1;
+    _A7105_SPI_SEGMENT_POS = 0;
+  }
+  return out;
+}
+
+//One byte finished on the wire, push the next or finish the transfer
+ISR(SPI_STC_vect)
+{
+  struct A7105_SPI_Transfer* transfer = &(_A7105_SPI_QUEUE[_A7105_SPI_QUEUE_START]);
+  byte in = SPDR;
+
+  //Store what we clocked in (nothing useful comes back during the command byte)
+  if (_A7105_SPI_POSITION >= 0 && transfer->rx_buffer)
+    transfer->rx_buffer[_A7105_SPI_POSITION] = in;
+
+  //More data to send?
+  _A7105_SPI_POSITION++;
+  if (_A7105_SPI_POSITION < transfer->len)
+  {
+    if (transfer->segments)
+      SPDR = _A7105_SPI_Gather_Byte(transfer);
+    else
+      SPDR = transfer->tx_buffer ? transfer->tx_buffer[_A7105_SPI_POSITION] : transfer->data;
+    return;
+  }
+
+  //Done, release the chip and the bus
+  SPCR &= ~_BV(SPIE);
+  A7105_HAL_SPI_End_Transaction();          // release the SPI bus
+  _A7105_Deselect(transfer->radio);
+
+  //Pop the transfer before the callback (the callback may want to queue more)
+  struct A7105* radio = transfer->radio;
+  void (*callback)(struct A7105*,void*) = transfer->callback;
+  void* context = transfer->context;
+  _A7105_SPI_QUEUE_START = (_A7105_SPI_QUEUE_START + 1) % A7105_SPI_QUEUE_SIZE;
+  _A7105_SPI_QUEUE_LENGTH--;
+
+  if (callback != NULL)
+    callback(radio, context);
+
+  if (_A7105_SPI_QUEUE_LENGTH > 0)
+    _A7105_SPI_Start_Next();
+  else if (_A7105_RX_RING_PENDING && _A7105_SPI_CLAIMED == 0)
+    _A7105_RX_Ring_Service(); //Packets that came in while we had the bus
+}
+#endif
+
+A7105_Status_Code A7105_SPI_Queue(struct A7105* radio,
+                                  byte command,
+                                  byte data,
+                                  byte* tx_buffer,
+                                  byte* rx_buffer,
+                                  byte len,
+                                  void (*callback)(struct A7105*,void*),
+                                  void* context)
+{
+  struct A7105_SPI_Transfer transfer = {radio, command, data, tx_buffer, rx_buffer, len, callback, context, NULL};
+  return _A7105_SPI_Enqueue(&transfer);
+}
+
+/*
+  Internal use only, A7105_SPI_Queue() for a transfer that's already filled in
+  (so the driver can queue transfers with segments).
+*/
+static A7105_Status_Code _A7105_SPI_Enqueue(struct A7105_SPI_Transfer* transfer)
+{
+#ifdef A7105_ASYNC_SPI_ENGINE
+  A7105_Status_Code ret = A7105_STATUS_OK;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    if (_A7105_SPI_QUEUE_LENGTH == A7105_SPI_QUEUE_SIZE)
+    {
+      ret = A7105_BUSY;
+    }
+    else
+    {
+      _A7105_SPI_QUEUE[(_A7105_SPI_QUEUE_START + _A7105_SPI_QUEUE_LENGTH) % A7105_SPI_QUEUE_SIZE] = *transfer;
+      _A7105_SPI_QUEUE_LENGTH++;
+
+      //Kick off the engine if it was idle
+      if (_A7105_SPI_QUEUE_LENGTH == 1)
+        _A7105_SPI_Start_Next();
+    }
+  }
+  return ret;
+#else
+  //No engine, just run it now
+  _A7105_SPI_Claim();
+  _A7105_SPI_Run_Polled(transfer);
+  _A7105_SPI_Release();
+  if (transfer->callback != NULL)
+    transfer->callback(transfer->radio, transfer->context);
+  return A7105_STATUS_OK;
+#endif
+}
+
+void A7105_SPI_Transfer(struct A7105* radio,
+                        byte command,
+                        byte* tx_buffer,
+                        byte* rx_buffer,
+                        byte len)
+{
+  struct A7105_SPI_Transfer transfer = {radio, command, 0, tx_buffer, rx_buffer, len, NULL, NULL, NULL};
+  A7105_SPI_Wait();
+  _A7105_SPI_Claim();
+  _A7105_SPI_Run_Polled(&transfer);
+  _A7105_SPI_Release();
+}
+
+byte A7105_SPI_Busy()
+{
+  return _A7105_SPI_QUEUE_LENGTH > 0;
+}
+
+void A7105_SPI_Wait()
+{
+  while (_A7105_SPI_QUEUE_LENGTH > 0) {}
+}
+
+void _A7105_SPI_Claim()
+{
+  byte lock = A7105_HAL_Lock();
+  _A7105_SPI_CLAIMED++;
+  A7105_HAL_Unlock(lock);
+}
+
+void _A7105_SPI_Release()
+{
+  byte lock = A7105_HAL_Lock();
+  _A7105_SPI_CLAIMED--;
+
+  //Copy any packets that came in while we had the bus (with interrupts 
+  //still off, like the WTR interrupt would)
+  if (_A7105_RX_RING_PENDING && _A7105_SPI_CLAIMED == 0 && _A7105_SPI_QUEUE_LENGTH == 0)
+    _A7105_RX_Ring_Service();
+  A7105_HAL_Unlock(lock);
+}
+
+/*
+  Internal use only, clocks FIFO bytes into 'frame' until it holds 'len' of them 
+  (the FIFO read command has to have been sent already).
+*/
+static void _A7105_RX_Ring_Read_FIFO(struct A7105_RX_Frame* frame, byte len)
+{
+  if (len <= frame->len)
+    return;
+  A7105_HAL_SPI_Transfer_Block(NULL, 0, frame->data + frame->len, len - frame->len);
+  frame->len = len;
+}
+
+/*
+  Internal use only, copies the packet sitting in the FIFO into the next free
+  slot of the radio's RX ring (unless the ring filter drops it) and puts the 
+  radio straight back in RX. Interrupts must be off and the SPI bus free (this 
+  runs from the WTR interrupt or when the bus is released, see 
+  _A7105_RX_Ring_Service()).
+*/
+static void _A7105_RX_Ring_Drain(struct A7105* radio)
+{
+  struct A7105_SPI_Transfer transfer = {radio, A7105_RST_RDPTR, 0, NULL, NULL, 0, NULL, NULL, NULL};
+  byte next_len = 0;
+  radio->_RX_RING_PENDING = 0;
+
+  //A TX was started while the packet waited for the bus, the FIFO write 
+  //clobbered it (and listening now would cut the TX off)
+  if (radio->_EVENTS & A7105_EVENT_TX_ACTIVE)
+  {
+    radio->_RX_RING_DROPPED++;
+    return;
+  }
+
+  if (_A7105_RX_Ring_Count(radio) < radio->_RX_RING_SIZE)
+  {
+    struct A7105_RX_Frame* frame = _A7105_RX_Ring_Slot(radio, radio->_RX_RING_HEAD);
+    byte len = radio->_SHADOW_REGS[A7105_03_FIFO_I] + 1; //the length we're listening for
+    if (len > A7105_RX_RING_FRAME_SIZE)
+      len = A7105_RX_RING_FRAME_SIZE;
+
+    //The CRC/FEC flags and RSSI reading only hold until we listen again
+    byte mode = 0;
+    transfer.command = A7105_00_MODE | 0x40;
+    transfer.rx_buffer = &mode;
+    transfer.len = 1;
+    _A7105_SPI_Run_Polled(&transfer);
+    transfer.command = A7105_1D_RSSI_THOLD | 0x40;
+    transfer.rx_buffer = &(frame->meta.rssi);
+    _A7105_SPI_Run_Polled(&transfer);
+
+    frame->len = 0;
+    frame->tag = 0;
+    frame->meta.timestamp = radio->_RX_TIMESTAMP;
+    frame->meta.status = A7105_STATUS_OK;
+    if ((radio->_USE_CRC || radio->_USE_FEC) &&
+        ((mode & CRC_CHECK_MASK) || (mode & FEC_CHECK_MASK)))
+      frame->meta.status = A7105_RX_DATA_INTEGRITY_ERROR;
+
+    //With a filter, a packet that failed CRC/FEC isn't worth reading
+    if (radio->_RX_RING_FILTER != NULL && frame->meta.status != A7105_STATUS_OK)
+      len = 0;
+
+    //Reset the read pointer and drain the FIFO in a single chip-select window, 
+    //the filter gets a look a piece at a time (a packet it drops just ends the window early)
+    byte verdict = A7105_RX_RING_KEEP;
+    transfer.command = A7105_RST_RDPTR;
+    transfer.rx_buffer = NULL;
+    transfer.len = 0;
+    _A7105_SPI_Run_Polled(&transfer);
+    if (len > 0)
+    {
+      _A7105_Select(radio);
+      A7105_HAL_SPI_Begin_Transaction(radio->_SPI_CLOCK);
+      A7105_HAL_SPI_Transfer(A7105_05_FIFO_DATA | 0x40);
+
+      if (radio->_RX_RING_FILTER != NULL)
+      {
+        while ((verdict = radio->_RX_RING_FILTER(radio, frame, radio->_RX_RING_CONTEXT)) != A7105_RX_RING_DROP &&
+               verdict != A7105_RX_RING_KEEP && verdict > frame->len && frame->len < len)
+          _A7105_RX_Ring_Read_FIFO(frame, (verdict < len) ? verdict : len);
       }
+      if (verdict != A7105_RX_RING_DROP)
+        _A7105_RX_Ring_Read_FIFO(frame, len);
 
-
-      return  A7105_RX_DATA_WAITING;
+      A7105_HAL_SPI_End_Transaction();
+      _A7105_Deselect(radio);
     }
+
+    if (radio->_RX_RING_CALLBACK != NULL)
+      next_len = radio->_RX_RING_CALLBACK(radio, frame, radio->_RX_RING_CONTEXT);
+
+    if (verdict == A7105_RX_RING_DROP)
+      radio->_RX_RING_FILTERED++;
+    else
+      radio->_RX_RING_HEAD = _A7105_RX_Ring_Next(radio, radio->_RX_RING_HEAD);
+  }
+  else
+  {
+    radio->_RX_RING_DROPPED++;
+  }
+
+  //Listen again (see A7105_Easy_Listen_For_Packets()), for a different 
+  //length if the callback asked for one
+  transfer.rx_buffer = NULL;
+  if (_A7105_Valid_FIFO_Length(next_len) && radio->_SHADOW_REGS[A7105_03_FIFO_I] != next_len - 1)
+  {
+    radio->_SHADOW_REGS[A7105_03_FIFO_I] = next_len - 1;
+    transfer.command = A7105_03_FIFO_I;
+    transfer.data = next_len - 1;
+    transfer.len = 1;
+    _A7105_SPI_Run_Polled(&transfer);
+  }
+  transfer.len = 0;
+  transfer.command = A7105_RST_WRPTR;
+  _A7105_SPI_Run_Polled(&transfer);
+  transfer.command = A7105_RX;
+  _A7105_SPI_Run_Polled(&transfer);
+  radio->_STATE = A7105_RX;
+}
+
+/*
+  Internal use only, drains the RX rings of the radios that got a packet
+  while the SPI bus was busy. Interrupts must be off.
+*/
+static void _A7105_RX_Ring_Service()
+{
+  _A7105_RX_RING_PENDING = 0;
+  for (byte x = 0; x < A7105_MAX_RADIOS; x++)
+  {
+    struct A7105* radio = _A7105_RADIOS[x];
+    if (radio != NULL && radio->_RX_RING_PENDING)
+      _A7105_RX_Ring_Drain(radio);
   }
-  return A7105_NO_WTR_INTERRUPT_SET;
 }
 
 void A7105_Reset(struct A7105* radio)
 {
     A7105_WriteReg(radio, 0x00, (byte) 0x00);
     //NOTE: Maybe we should just delay(1) here?
-    delayMicroseconds(1000);
+    A7105_HAL_Delay_Us(1000);
+
+    //Every register is back to its default value now
+    A7105_Shadow_Invalidate(radio);
+}
+
+
+void A7105_Set_RSSI_Threshold(struct A7105* radio, byte threshold)
+{
+  A7105_WriteReg(radio, A7105_1D_RSSI_THOLD, threshold);
+  radio->_RSSI_THOLD = threshold;
 }
 
+A7105_Status_Code A7105_Check_Channel_Clear(struct A7105* radio)
+{
+  //A packet showing up is as busy as it gets
+  if (radio->_INTERRUPT_PIN > 0 && (radio->_EVENTS & A7105_EVENT_RX_READY))
+    return A7105_BUSY;
+
+  //We can only measure RSSI while listening (the auto RSSI measurement 
+  //keeps the reading up to date in RX mode)
+  byte was_listening = (radio->_STATE == A7105_RX);
+  if (!was_listening)
+  {
+    A7105_Strobe(radio, A7105_RX);
+    A7105_HAL_Delay_Us(A7105_RSSI_SETTLE_US);
+  }
+
+  byte rssi = A7105_ReadReg(radio, A7105_1D_RSSI_THOLD);
+
+  if (!was_listening)
+    A7105_Strobe(radio, A7105_STANDBY);
+
+  return (rssi < radio->_RSSI_THOLD) ? A7105_BUSY : A7105_STATUS_OK;
+}
 
 void A7105_SetPower(struct A7105* radio, A7105_TxPower power)
 {
@@ -306,16 +1373,168 @@ void A7105_SetPower(struct A7105* radio, A7105_TxPower power)
 
 void A7105_Strobe(struct A7105* radio, enum A7105_State state)
 {
-  digitalWrite(radio->_CS_PIN,LOW);
-  //NOTE: The A7105 only speaks MSBFIRST,SPI Mode 0, the variable clock rate is for debugging
-  SPI.beginTransaction(SPISettings(A7105_SPI_CLOCK, MSBFIRST, SPI_MODE0));  // gain control of SPI bus
+  //Skip the strobe if we're already in this (idle type) mode
+  if (!_A7105_Shadow_Strobe(radio, state))
+    return;
+
+  //Let any queued transfers finish first so we don't stomp on the bus
+  A7105_SPI_Wait();
+
+  _A7105_SPI_Claim();
+  _A7105_Select(radio);
+  //NOTE: The A7105 only speaks MSBFIRST,SPI Mode 0, the clock is per radio (see A7105_Train_SPI_Clock())
+  A7105_HAL_SPI_Begin_Transaction(radio->_SPI_CLOCK);  // gain control of SPI bus
+
+  A7105_HAL_SPI_Transfer(state);
+
+  A7105_HAL_SPI_End_Transaction();          // release the SPI bus
+  _A7105_Deselect(radio);
+  _A7105_SPI_Release();
+}
+
+
+/*
+  Internal use only, auto-calibrates the radio on the channel currently set in
+  A7105_0F_PLL_I. Returns A7105_STATUS_OK or A7105_CALIBRATION_ERROR.
+*/
+static A7105_Status_Code _A7105_Calibrate(struct A7105* radio)
+{
+  //Calibrate the radio (required after reset/power-on)
+  //Check out pg. 63 of the data sheet
+
+  //This set's up the chip for auto calibration (clears any manual values
+  //we restored from the calibration cache)
+  A7105_WriteReg(radio,A7105_22_IF_CALIB_I,(byte)0x00);
+  A7105_WriteReg(radio,A7105_24_VCO_CURCAL,(byte)0x00);
+  A7105_WriteReg(radio,A7105_25_VCO_SBCAL_I,(byte)0x00);
+
+  //Tell the radio to go into PLL mode
+  A7105_Strobe(radio,A7105_PLL);
+
+  //Turn on IF Filter, VCO current and VCO bank calibration
+  A7105_WriteReg(radio,A7105_02_CALC, (byte)0x07);
+
+  //Wait for the FBC part of the 02_CALC register to clear so we 
+  //know calibration is done (if we time-out return a failure code)
+  unsigned long ms = A7105_HAL_Millis();
+  int calibration_success = 0;
+  while(A7105_HAL_Millis() - ms < A7105_CALIBRATION_TIMEOUT)
+  {
+    //check if the FBC,VCO,VCC bits (lowest 3) are auto-cleared (signals the end of autocalibration)
+    if ((A7105_ReadReg(radio,A7105_02_CALC) & 0x07) == 0x00)
+    {
+      calibration_success = 1;
+      break;
+    }
+  }
+
+  //check for timeout calibrating IF Filter
+  if (!calibration_success)
+  {
+    return A7105_CALIBRATION_ERROR;
+  }
+
+  //check for failure code of IF Filter calibration (0x10 bit high)
+  if ((A7105_ReadReg(radio,A7105_22_IF_CALIB_I) & 0x10) == 0x10)
+  {
+    return A7105_CALIBRATION_ERROR;
+  }
+
+  //check for failure code of VCO Current calibration (0x10 bit high)
+  if ((A7105_ReadReg(radio,A7105_24_VCO_CURCAL) & 0x10) == 0x10)
+  {
+    return A7105_CALIBRATION_ERROR;
+  }
+
+  //check for failure code of VCO Band calibration (0x08 bit high)
+  if ((A7105_ReadReg(radio,A7105_25_VCO_SBCAL_I) & 0x80) == 0x80)
+  {
+    return A7105_CALIBRATION_ERROR;
+  }
+
+  return A7105_STATUS_OK;
+}
+
+#ifdef A7105_CALIBRATION_CACHE
+/*
+  Internal use only, returns the EEPROM address of the cache entry for 'channel'.
+  Each entry is the IF filter bank (22h), VCO current (24h) and VCO band (25h) 
+  read back after a successful auto-calibration. Erased EEPROM (0xFF) has the 
+  IF filter failure bit set so it never looks like a valid entry.
+*/
+static inline uint8_t* _A7105_Cal_Entry(struct A7105* radio, byte channel)
+{
+  return (uint8_t*)(radio->_CAL_EEPROM_ADDR + channel * 3);
+}
+#endif
+
+A7105_Status_Code A7105_SetChannel(struct A7105* radio, byte channel)
+{
+  //Verify the channel is in the legit range
+  if (channel > A7105_HIGHEST_CHANNEL)
+  {
+    return A7105_INVALID_CHANNEL;
+  }
+
+  //Re-tune from standby (also needs to be set before calibrating)
+  A7105_Strobe(radio,A7105_STANDBY);
+  A7105_WriteReg(radio,A7105_0F_PLL_I, channel);
 
-  SPI.transfer(state);
+#ifdef A7105_CALIBRATION_CACHE
+  if (radio->_CAL_EEPROM_ADDR >= 0)
+  {
+    uint8_t* entry = _A7105_Cal_Entry(radio,channel);
+    byte if_calib = eeprom_read_byte(entry);
+
+    //Cached, write the results back with the manual select bits set
+    //(MFBS, MVCS and MVBS, see pg. 63 of the data sheet)
+    if ((if_calib & 0x10) == 0x00)
+    {
+      A7105_WriteReg(radio,A7105_22_IF_CALIB_I,(byte)((if_calib & 0x0F) | 0x10));
+      A7105_WriteReg(radio,A7105_24_VCO_CURCAL,(byte)((eeprom_read_byte(entry + 1) & 0x0F) | 0x10));
+      A7105_WriteReg(radio,A7105_25_VCO_SBCAL_I,(byte)((eeprom_read_byte(entry + 2) & 0x07) | 0x08));
+      return A7105_STATUS_OK;
+    }
+  }
+#endif
+
+  A7105_Status_Code status = _A7105_Calibrate(radio);
+
+  //Put the radio back in standby mode (calibration leaves it in PLL mode)
+  A7105_Strobe(radio,A7105_STANDBY);
 
-  SPI.endTransaction();          // release the SPI bus
-  digitalWrite(radio->_CS_PIN,HIGH);
+  if (status != A7105_STATUS_OK)
+  {
+    return status;
+  }
+
+#ifdef A7105_CALIBRATION_CACHE
+  //Save the results for next time
+  if (radio->_CAL_EEPROM_ADDR >= 0)
+  {
+    uint8_t* entry = _A7105_Cal_Entry(radio,channel);
+    eeprom_update_byte(entry,     A7105_ReadReg(radio,A7105_22_IF_CALIB_I) & 0x0F);
+    eeprom_update_byte(entry + 1, A7105_ReadReg(radio,A7105_24_VCO_CURCAL) & 0x0F);
+    eeprom_update_byte(entry + 2, A7105_ReadReg(radio,A7105_25_VCO_SBCAL_I) & 0x07);
+  }
+#endif
+
+  return A7105_STATUS_OK;
 }
 
+void A7105_Clear_Calibration_Cache(struct A7105* radio)
+{
+#ifdef A7105_CALIBRATION_CACHE
+  if (radio->_CAL_EEPROM_ADDR < 0)
+    return;
+
+  //Only the first byte of each entry matters, 0xFF marks it invalid
+  for (int channel = 0; channel <= A7105_HIGHEST_CHANNEL; channel++)
+  {
+    eeprom_update_byte(_A7105_Cal_Entry(radio,channel),0xFF);
+  }
+#endif
+}
 
 A7105_Status_Code A7105_Easy_Setup_Radio(struct A7105* radio, 
                                          int cs_pin, 
@@ -327,6 +1546,24 @@ A7105_Status_Code A7105_Easy_Setup_Radio(struct A7105* radio,
                                          int use_CRC,
                                          int use_FEC)
 {
+#ifdef A7105_CALIBRATION_CACHE
+  return A7105_Easy_Setup_Radio(radio,cs_pin,wtr_pin,radio_id,data_rate,channel,power,use_CRC,use_FEC,A7105_CAL_EEPROM_ADDR);
+#else
+  return A7105_Easy_Setup_Radio(radio,cs_pin,wtr_pin,radio_id,data_rate,channel,power,use_CRC,use_FEC,-1);
+#endif
+}
+
+A7105_Status_Code A7105_Easy_Setup_Radio(struct A7105* radio, 
+                                         int cs_pin, 
+                                         int wtr_pin, 
+                                         uint32_t radio_id, 
+                                         A7105_DataRate data_rate, 
+                                         byte channel, 
+                                         A7105_TxPower power,
+                                         int use_CRC,
+                                         int use_FEC,
+                                         int cal_eeprom_addr)
+{
 
   /*
     Implementor note: The A7105 does not obey a high-Z state on the
@@ -338,6 +1575,12 @@ d initalize all radios before using any of them to avoid interfering with the SP
   //Initialize (this sets the CS pin option and 4-wire spi bus options
   //if it wasn't already, resets the radio, etc).
   A7105_Initialize(radio,cs_pin);
+
+#ifdef A7105_SPI_TRAINING
+  //Find the fastest SPI clock this radio's wiring can take (this resets the radio, so before we set it up).
+  //Nothing getting through at all is caught by the clock register check below.
+  A7105_Train_SPI_Clock(radio);
+#endif
   
   //Set ID (for packet filtering)
   A7105_WriteReg(radio,A7105_06_ID_DATA,radio_id);
@@ -426,78 +1669,54 @@ d initalize all radios before using any of them to avoid interfering with the SP
   A7105_WriteReg(radio,A7105_29_RX_DEM_TEST_I, (byte)0x47);
 
 
-  //Verify the channel is in the legit range
-  if (channel > A7105_HIGHEST_CHANNEL)
-  {
-    return A7105_INVALID_CHANNEL;
-  }
-  //Set the channel (need to be here so the VDO calibration works later)
-  A7105_WriteReg(radio,A7105_0F_PLL_I, channel);
-
-  //Calibrate the radio (required after reset/power-on)
-  //Check out pg. 63 of the data sheet
-
-  //This set's up the chip for auto calibration
-  A7105_WriteReg(radio,A7105_22_IF_CALIB_I,(byte)0x00);
-
-  //Tell the radio to go into PLL mode
-  A7105_Strobe(radio,A7105_PLL);
-
-  //Turn on IF Filter, VCO current and VCO bank calibration
-  A7105_WriteReg(radio,A7105_02_CALC, (byte)0x07);
-
-  //Wait for the FBC part of the 02_CALC register to clear so we 
-  //know calibration is done (if we time-out return a failure code)
-  unsigned long ms = millis();
-  int calibration_success = 0;
-  while(millis() - ms < A7105_CALIBRATION_TIMEOUT)
-  {
-    //check if the FBC,VCO,VCC bits (lowest 3) are auto-cleared (signals the end of autocalibration)
-    if ((A7105_ReadReg(radio,A7105_02_CALC) & 0x07) == 0x00)
-    {
-      calibration_success = 1;
-      break;
-    }
-  }
-
-  //check for timeout calibrating IF Filter
-  if (!calibration_success)
-  {
-    return A7105_CALIBRATION_ERROR;
-  }
-
-  //check for failure code of IF Filter calibration (0x10 bit high)
-  if ((A7105_ReadReg(radio,A7105_22_IF_CALIB_I) & 0x10) == 0x10)
-  {
-    return A7105_CALIBRATION_ERROR;
-  }
-
-  //check for failure code of VCO Current calibration (0x10 bit high)
-  if ((A7105_ReadReg(radio,A7105_24_VCO_CURCAL) & 0x10) == 0x10)
-  {
-    return A7105_CALIBRATION_ERROR;
-  }
-
-  //check for failure code of VCO Band calibration (0x08 bit high)
-  if ((A7105_ReadReg(radio,A7105_25_VCO_SBCAL_I) & 0x80) == 0x80)
+  //Tune and calibrate the radio for our channel (from the calibration cache if we can)
+#ifdef A7105_CALIBRATION_CACHE
+  radio->_CAL_EEPROM_ADDR = cal_eeprom_addr;
+#else
+  (void)cal_eeprom_addr;
+#endif
+  A7105_Status_Code status = A7105_SetChannel(radio,channel);
+  if (status != A7105_STATUS_OK)
   {
-    return A7105_CALIBRATION_ERROR;
+    return status;
   }
 
   //Set the transmit power
   A7105_SetPower(radio,power);
 
+  //Set the carrier sense threshold (see A7105_Check_Channel_Clear())
+  A7105_Set_RSSI_Threshold(radio,A7105_DEFAULT_RSSI_THOLD);
+
   //Put the radio back in standby mode   
   A7105_Strobe(radio,A7105_STANDBY);
 
   //Set up the WTR pin change interrupt if it was specified
+  radio->_EVENTS = 0;
+  radio->_INTERRUPT_PIN = wtr_pin; //save the pin (or -1 value) for use elsewhere
   if (wtr_pin > 0)  
   {
-    _A7105_INTERRUPT_COUNTS[wtr_pin] = A7105_INT_NULL; 
-    pinMode(wtr_pin,INPUT);
-    attachPinChangeInterrupt(wtr_pin,_A7105_Pin_Interrupt_Callback,FALLING);
+    //Find this radio's slot (if it's being set up again) or a free one
+    int slot = -1;
+    for (int x = 0; x < A7105_MAX_RADIOS; x++)
+    {
+      if (_A7105_RADIOS[x] == radio)
+      {
+        slot = x;
+        break;
+      }
+      if (slot < 0 && _A7105_RADIOS[x] == NULL)
+        slot = x;
+    }
+    if (slot < 0)
+    {
+      radio->_INTERRUPT_PIN = -1;
+      return A7105_TOO_MANY_RADIOS;
+    }
+    _A7105_RADIOS[slot] = radio;
+
+    A7105_HAL_Pin_Input(wtr_pin);
+    A7105_HAL_Attach_Falling(wtr_pin,_A7105_Pin_Interrupt_Callback);
   }
-  radio->_INTERRUPT_PIN = wtr_pin; //save the pin (or -1 value) for use elsewhere
 
 
   //If we make it here, we're calling it a success
@@ -508,30 +1727,25 @@ A7105_Status_Code A7105_Easy_Listen_For_Packets(struct A7105* radio,
                                                 byte length)
 {
   //Check to make sure len is a multiple of 8 between 1 and 64
-  if (length != 1  &&
-      length != 8  &&
-      length != 16 &&
-      length != 32 &&
-      length != 64)
+  if (!_A7105_Valid_FIFO_Length(length))
   {
     return A7105_INVALID_FIFO_LENGTH;
   }
 
-  //DEBUG (not sure if this stanza is totally necessary yet)
+  //Make sure we're in standby before re-arming. NOTE: This is skipped if
+  //we already know we're there (the radio drops back to standby after 
+  //every TX/RX)
   A7105_Strobe(radio,A7105_STANDBY);
 
-  if (radio->_INTERRUPT_PIN > 0)
-  {
-    //clear the interrupt counter since we're reading
-    _A7105_INTERRUPT_COUNTS[radio->_INTERRUPT_PIN] = A7105_INT_NULL;
-  }
+  //Start listening with a clean slate (the radio is in standby so no
+  //TX can be in progress)
+  radio->_EVENTS = 0;
   A7105_Strobe(radio,A7105_RST_WRPTR);
-  //DEBUG
 
   //Send the length of the packet we're expecting (len - 1 since it's an end-pointer)
-  //TODO: Maybe we can make this optional so we don't have to do it for 
-  //every packet?
+  //NOTE: The shadow register cache skips this if the length hasn't changed
   A7105_WriteReg(radio, A7105_03_FIFO_I, (byte)(length-1));
+  A7105_WriteReg(radio, A7105_04_FIFO_II, (byte)0x00); //default FIFO layout (see A7105_SetFIFOSegment())
 
   //Put radio2 in RX mode so it will hear the packet we're sending with radio1
   A7105_Strobe(radio,A7105_RX);
@@ -542,15 +1756,118 @@ A7105_Status_Code A7105_Easy_Listen_For_Packets(struct A7105* radio,
 
 
 
+byte A7105_Get_Events(struct A7105* radio)
+{
+  return radio->_EVENTS;
+}
+
+A7105_Status_Code A7105_RX_Ring_Begin(struct A7105* radio,
+                                      struct A7105_RX_Frame* frames,
+                                      byte count,
+                                      byte (*callback)(struct A7105*,struct A7105_RX_Frame*,void*),
+                                      void* context)
+{
+  //The WTR interrupt does all the work
+  if (radio->_INTERRUPT_PIN <= 0)
+    return A7105_NO_WTR_INTERRUPT_SET;
+
+  //The head/tail counters go up to 2*count-1 (see _A7105_RX_Ring_Count())
+  if (frames == NULL || count == 0 || count > 127)
+    return A7105_INVALID_FIFO_LENGTH;
+
+  byte lock = A7105_HAL_Lock();
+  radio->_RX_RING_SIZE = count;
+  radio->_RX_RING_HEAD = 0;
+  radio->_RX_RING_TAIL = 0;
+  radio->_RX_RING_PENDING = 0;
+  radio->_RX_RING_DROPPED = 0;
+  radio->_RX_RING_FILTERED = 0;
+  radio->_RX_RING_CALLBACK = callback;
+  radio->_RX_RING_FILTER = NULL;
+  radio->_RX_RING_CONTEXT = context;
+  radio->_RX_RING = frames;
+  A7105_HAL_Unlock(lock);
+
+  return A7105_STATUS_OK;
+}
+
+void A7105_RX_Ring_End(struct A7105* radio)
+{
+  byte lock = A7105_HAL_Lock();
+  radio->_RX_RING = NULL;
+
+  //A packet still waiting for the bus is in the FIFO, hand it to A7105_ReadData()
+  if (radio->_RX_RING_PENDING)
+    radio->_EVENTS |= A7105_EVENT_RX_READY;
+  radio->_RX_RING_PENDING = 0;
+  A7105_HAL_Unlock(lock);
+}
+
+void A7105_RX_Ring_Set_Filter(struct A7105* radio,
+                              byte (*filter)(struct A7105*,struct A7105_RX_Frame*,void*))
+{
+  byte lock = A7105_HAL_Lock();
+  radio->_RX_RING_FILTER = filter;
+  A7105_HAL_Unlock(lock);
+}
+
+struct A7105_RX_Frame* A7105_RX_Ring_Peek(struct A7105* radio)
+{
+  if (radio->_RX_RING == NULL || radio->_RX_RING_HEAD == radio->_RX_RING_TAIL)
+    return NULL;
+  return _A7105_RX_Ring_Slot(radio, radio->_RX_RING_TAIL);
+}
+
+void A7105_RX_Ring_Pop(struct A7105* radio)
+{
+  if (radio->_RX_RING == NULL || radio->_RX_RING_HEAD == radio->_RX_RING_TAIL)
+    return;
+  radio->_RX_RING_TAIL = _A7105_RX_Ring_Next(radio, radio->_RX_RING_TAIL);
+}
+
 void A7105_Pause(struct A7105* radio)
 {
-  detachInterrupt(radio->_INTERRUPT_PIN); 
+  if (radio->_INTERRUPT_PIN > 0)
+    A7105_HAL_Detach(radio->_INTERRUPT_PIN);
+#ifdef A7105_3WIRE_SPI
+  if (radio->_TX_DONE_PIN > 0)
+    A7105_HAL_Detach(radio->_TX_DONE_PIN);
+#endif
 }
 
 void A7105_Resume(struct A7105* radio)
 {
-  attachPinChangeInterrupt(radio->_INTERRUPT_PIN,_A7105_Pin_Interrupt_Callback,FALLING);
+  if (radio->_INTERRUPT_PIN > 0)
+    A7105_HAL_Attach_Falling(radio->_INTERRUPT_PIN,_A7105_Pin_Interrupt_Callback);
+#ifdef A7105_3WIRE_SPI
+  if (radio->_TX_DONE_PIN > 0)
+    A7105_HAL_Attach_Falling(radio->_TX_DONE_PIN,_A7105_Pin_Interrupt_Callback);
+#endif
+}
+
+#ifdef A7105_3WIRE_SPI
+A7105_Status_Code A7105_Set_TX_Done_Pin(struct A7105* radio, int tx_done_pin)
+{
+  //The interrupt callback finds the radio through its WTR pin slot
+  if (radio->_INTERRUPT_PIN <= 0)
+    return A7105_NO_WTR_INTERRUPT_SET;
+
+  if (radio->_TX_DONE_PIN > 0)
+    A7105_HAL_Detach(radio->_TX_DONE_PIN);
+
+  byte lock = A7105_HAL_Lock();
+  radio->_TX_DONE_PIN = tx_done_pin;
+  radio->_EVENTS &= ~A7105_EVENT_TX_ON_AIR;
+  A7105_HAL_Unlock(lock);
+
+  if (tx_done_pin > 0)
+  {
+    A7105_HAL_Pin_Input(tx_done_pin);
+    A7105_HAL_Attach_Falling(tx_done_pin,_A7105_Pin_Interrupt_Callback);
+  }
+  return A7105_STATUS_OK;
 }
+#endif
 
 /*
   Internal use only, This function is the callback for the pin change
@@ -558,9 +1875,60 @@ void A7105_Resume(struct A7105* radio)
 */
 void _A7105_Pin_Interrupt_Callback()
 {
+  //Find the radio that owns this pin
+  int pin = A7105_HAL_Interrupt_Pin();
+  struct A7105* radio = NULL;
+  for (byte x = 0; x < A7105_MAX_RADIOS; x++)
+  {
+    if (_A7105_RADIOS[x] != NULL && _A7105_RADIOS[x]->_INTERRUPT_PIN == pin)
+    {
+      radio = _A7105_RADIOS[x];
+      break;
+    }
+#ifdef A7105_3WIRE_SPI
+    //The end of a TX we started (GIO1 is carrier detect the rest of the time)
+    if (_A7105_RADIOS[x] != NULL && _A7105_RADIOS[x]->_TX_DONE_PIN == pin)
+    {
+      radio = _A7105_RADIOS[x];
+      if (radio->_EVENTS & A7105_EVENT_TX_ON_AIR)
+        radio->_EVENTS = (radio->_EVENTS & ~(A7105_EVENT_TX_ACTIVE | A7105_EVENT_TX_ON_AIR)) | A7105_EVENT_TX_DONE;
+      return;
+    }
+#endif
+  }
+  if (radio == NULL)
+    return;
+
+#ifdef A7105_3WIRE_SPI
+  //The TX done pin reports the end of the TX, so WTR edges from then until we listen
+  //again are the TX itself (or an RX we cut short to start it), not packets
+  if (radio->_TX_DONE_PIN > 0)
+  {
+    if ((radio->_EVENTS & (A7105_EVENT_TX_ACTIVE | A7105_EVENT_TX_DONE)) && radio->_STATE != A7105_RX)
+      return;
+  }
+  else
+#endif
+  //NOTE: Both TX and RX make the WTR pin go high during activity. A7105_WriteData_Async()
+  //flags the TX as active before strobing TX so the falling edge at the end of it can be 
+  //told apart from a received packet.
+  if (radio->_EVENTS & A7105_EVENT_TX_ACTIVE)
+  {
+    radio->_EVENTS = (radio->_EVENTS & ~A7105_EVENT_TX_ACTIVE) | A7105_EVENT_TX_DONE;
+    return;
+  }
 
-  //NOTE: We don't bother differentating TX vs RX here (both cause the WTR pin to go high during activity) because we set the interrupt counter to IGNORE_ONE before activating the TX circuity. That way it just get's incremented to NULL after it's done.
+  radio->_RX_TIMESTAMP = A7105_HAL_Micros();
 
-  if (_A7105_INTERRUPT_COUNTS[PCintPort::arduinoPin] < A7105_INT_TRIGGERED)
-    _A7105_INTERRUPT_COUNTS[PCintPort::arduinoPin]++; 
+  //With an RX ring we copy the packet out and listen again right away, unless
+  //someone has the SPI bus (then it waits in the FIFO until they're done)
+  if (radio->_RX_RING == NULL)
+    radio->_EVENTS |= A7105_EVENT_RX_READY;
+  else if (_A7105_SPI_CLAIMED || _A7105_SPI_QUEUE_LENGTH)
+  {
+    radio->_RX_RING_PENDING = 1;
+    _A7105_RX_RING_PENDING = 1;
+  }
+  else
+    _A7105_RX_Ring_Drain(radio);
 }
@@ -46,8 +46,16 @@ POSSIBILITY OF SUCH DAMAGE.
     I used the PinChangeInt() library to trigger the RX data waiting interrupts and this has only been tested using
     an ATMEGA328P. The use of other chips is untested.
 
+    All the hardware access (SPI, chip selects, the clock and the WTR interrupts) goes through a small HAL
+    (a7105_hal.h) so the library can also run on Linux (spidev and the GPIO character device) or against
+    the host emulator in emulator/.
+
     This library was written using the Arduino-1.6.1 distribution (includes the transactional SPI library).
 
+    FIFO transfers can be queued on a small interrupt driven SPI engine (the *_Async functions) so the
+    calling code can keep working while bytes are clocked out. This uses the SPI_STC_vect interrupt on
+    AVR chips; see A7105_DISABLE_ASYNC_SPI below if that conflicts with something else in your sketch.
+
   Hardware Notes:
     This library was written/tested using an Arduino Pro Mini and the XL7105-SY-B breakouts from DX.com. these
     breakouts are basically the reference implementation (16Mhz crystal, etc) so this library should work with 
@@ -67,20 +75,48 @@ POSSIBILITY OF SUCH DAMAGE.
       3v3 as a logical 1 due to the 0.7V voltage drop. The pull down keeps the MISO line low but doesn't sink too much 
       current so either radio can chat.
 
+      The radio can also talk over its bidirectional SDIO pin alone (3-wire SPI, see A7105_3WIRE_SPI below),
+      which frees up GIO1. Tie MISO straight to SDIO and MOSI to SDIO through a ~1K resistor so the radio 
+      can out-drive MOSI when it's answering. SDIO is only driven while the chip select is low, so radios
+      can share the line without the diode hack above.
+
   -Matt Meno (matthew.meno@gmail.com), March 27 2015
 */
 #ifndef _A7105_H_
 #define _A7105_H_
 
 #include <stdint.h>
+#include "a7105_hal.h"
 
 #define A7105_ENABLE_4WIRE 0x19 //GPIO register value to make the pin a MISO pin (for 4-wire SPI comms)
 #define A7105_GPIO_WTR 0x01 //Code to set a GIO pin to do WTR activity (be high during transmit/receive and low otherwise)
+#define A7105_GPIO_FPF 0x15 //Code to set a GIO pin to be the FIFO pointer flag (used for FIFO extension mode)
+#define A7105_GPIO_TMEO 0x09 //Code to set a GIO pin to TMEO (high while the transmitter is on) in TX and carrier detect in RX
+
+//Uncomment to talk to the radios over 3-wire SPI (SDIO only, see the wiring notes above) instead
+//of using GIO1 as MISO. GIO1 is then set to TMEO so it can be wired to a second interrupt
+//pin that only signals the end of a TX (see A7105_Set_TX_Done_Pin()). The WTR pin on GIO2
+//is then only used for received packets.
+//#define A7105_3WIRE_SPI
+
+//Uncomment to take WTR (and TX done) interrupts on pins 2 and 3 straight from INT0/INT1 on the
+//ATmega168/328 instead of through PinChangeInt, which has to work out which pin changed before it
+//gets to our handler. Other pins still use PinChangeInt. NOTE: This defines the INT0/INT1 vectors,
+//so attachInterrupt() can't be used anywhere else in the sketch.
+//#define A7105_EXTERNAL_WTR_INTERRUPTS
 
 //NOTE: This is 1/2 the maximum value specified in the datasheet. 10000000 was 
 //      giving me issues with my ghetto breadboard test harness so feel free to alter 
 //      this if you wish, but be careful pushing it too fast.
-#define A7105_SPI_CLOCK 5000000 //Clock rate for SPI communications with A7105's
+#define A7105_SPI_CLOCK 5000000 //Clock rate for SPI communications with A7105's (until A7105_Train_SPI_Clock() picks one)
+#define A7105_SPI_CLOCK_MAX 10000000 //Maximum SPI clock in the datasheet, the fastest A7105_Train_SPI_Clock() will try
+#define A7105_SPI_TRAINING_STEPS 5 //Clocks A7105_Train_SPI_Clock() probes (A7105_SPI_CLOCK_MAX halved each step down)
+#define A7105_SPI_TRAINING_ROUNDS 8 //ID write/readback patterns that all have to come back intact at a clock
+#define A7105_SPI_TRAINING_CONFIRM_ROUNDS 256 //patterns the fastest clock that passed then has to get through too (for margin)
+
+//Uncomment to have A7105_Easy_Setup_Radio() train the SPI clock (see A7105_Train_SPI_Clock(),
+//otherwise the radios always run at A7105_SPI_CLOCK)
+//#define A7105_SPI_TRAINING
 
 #define CRC_ENABLE_MASK 0x08 //Mask to enable CRC on register 1F (code register 1)
 #define FEC_ENABLE_MASK 0x10 //Mask to enable FEC on register 1F (code register 1)
@@ -93,6 +129,44 @@ POSSIBILITY OF SUCH DAMAGE.
                                       //(this is *way* more time that the datasheet calls out, maybe we should reduce this?)
 #define A7105_MAX_FIFO_SIZE 64 //largest amount of data that will fit in the FIFO in Easy mode
 
+//FIFO extension mode (see A7105_WriteData_Extended()/A7105_ReadData_Extended())
+#define A7105_MAX_EXTENDED_FIFO_SIZE 256 //largest packet in FIFO extension mode (the FIFO end pointer is 8 bits)
+#define A7105_FIFO_EXT_MARGIN 0xC0 //FPM bits for FIFO II (04h), FPF goes high with 16 bytes left to send (TX) or 48 bytes to read (RX)
+#define A7105_FIFO_EXT_CHUNK 48 //Bytes moved through the FIFO each time FPF goes high
+#define A7105_FIFO_EXT_TIMEOUT 500 //milliseconds to wait on the radio between chunks before giving up (~190ms per chunk at 2Kbps)
+
+//Carrier sense (see A7105_Check_Channel_Clear()). RSSI readings are ADC values where lower 
+//means a stronger signal, so the channel is busy if the reading is *below* the threshold.
+#define A7105_DEFAULT_RSSI_THOLD 0x50 //Written to 1Dh by A7105_Easy_Setup_Radio(), tune it for your noise floor
+#define A7105_RSSI_SETTLE_US 150 //microseconds for the RX circuitry and RSSI reading to settle after strobing RX
+
+#define A7105_NUM_REGISTERS 0x33 //Number of control registers (00h-32h) tracked in the shadow register cache
+
+//Number of queued SPI transfers the interrupt driven transfer engine can hold (shared by all radios).
+//NOTE: An async TX (A7105_WriteData_Async) needs up to 6 of these, keep that in mind if you shrink it.
+#define A7105_SPI_QUEUE_SIZE 6
+
+//Uncomment to disable the interrupt driven SPI transfer engine (i.e. if something else in
+//your sketch needs the SPI_STC_vect interrupt). All transfers will then be polled and the
+//*_Async functions will finish (and call their callbacks) before returning.
+//#define A7105_DISABLE_ASYNC_SPI
+
+#if defined(__AVR__) && defined(SPIE) && !defined(A7105_DISABLE_ASYNC_SPI)
+#define A7105_ASYNC_SPI_ENGINE
+#endif
+
+//Calibration results (IF filter bank, VCO current and VCO band) are cached per channel in
+//EEPROM so A7105_Easy_Setup_Radio() and A7105_SetChannel() can skip the auto-calibration.
+//Each radio needs its own region of A7105_CAL_EEPROM_SIZE bytes (see A7105_Easy_Setup_Radio()).
+//Uncomment to disable the cache (i.e. if your sketch needs that EEPROM space).
+//#define A7105_DISABLE_CALIBRATION_CACHE
+#define A7105_CAL_EEPROM_ADDR 0 //Default EEPROM address of the calibration cache
+#define A7105_CAL_EEPROM_SIZE ((A7105_HIGHEST_CHANNEL + 1) * 3) //3 bytes per channel (507 bytes)
+
+#if defined(__AVR__) && !defined(A7105_DISABLE_CALIBRATION_CACHE)
+#define A7105_CALIBRATION_CACHE
+#endif
+
 //Status codes for returns from the various functions in this library
 //These don't have any representation in the datasheet; they're just
 //for ease of use with this library (see individual functions for the meanings in context).
@@ -107,6 +181,7 @@ enum A7105_Status_Code{
   A7105_NO_DATA,
   A7105_NO_WTR_INTERRUPT_SET,
   A7105_BUSY,
+  A7105_TOO_MANY_RADIOS,
 };
 
 //The states from the A7105. These are the "Strobe" commands
@@ -122,14 +197,29 @@ enum A7105_State {
     A7105_RST_RDPTR = 0xF0,
 };
 
-//Internal states for the WTR pin interrupt tracking
-//these aren't visible outside the library.
+//Event flags set by the WTR pin interrupt (see A7105_Get_Events()). These
+//are tracked per radio so several radios can be used from one microcontroller.
 enum {
-  A7105_INT_IGNORE_ONE = 0,
-  A7105_INT_NULL = 1,
-  A7105_INT_TRIGGERED = 2
+  A7105_EVENT_TX_ACTIVE = 0x01, //A TX was started and the radio hasn't finished sending it
+  A7105_EVENT_TX_DONE   = 0x02, //The last TX finished
+  A7105_EVENT_RX_READY  = 0x04, //A packet was received and is waiting in the FIFO
+  A7105_EVENT_TX_ON_AIR = 0x08  //The TX strobe has gone out (only tracked with a TX done pin, see A7105_Set_TX_Done_Pin())
 };
 
+//Largest packet an RX ring slot holds (see A7105_RX_Ring_Begin()). Longer packets are cut short.
+#ifndef A7105_RX_RING_FRAME_SIZE
+#define A7105_RX_RING_FRAME_SIZE A7105_MAX_FIFO_SIZE
+#endif
+
+//RX ring filter verdicts (see A7105_RX_Ring_Set_Filter()), anything in between asks for more bytes
+#define A7105_RX_RING_DROP 0
+#define A7105_RX_RING_KEEP 0xFF
+
+//The most radios with WTR interrupts that can be set up at once (each slot is one pointer of RAM)
+#ifndef A7105_MAX_RADIOS
+#define A7105_MAX_RADIOS 4
+#endif
+
 //All the registers available in the A7105. These 
 //make up the bulk of the datasheet. check out the 
 //code of this library for some examples.
@@ -216,15 +306,103 @@ enum A7105_TxPower {
   library to keep track of the radio state (pins, etc). It's opaque to the 
   calling code.
 */
+struct A7105_RX_Frame;
+
 struct A7105
 {
   int _CS_PIN; //chip select pin (arduino number) so we can have multipe radios per microcontroller
-  int _STATE; //Uses the values of the A7105 Strobe states for tracking interrupts and such 
+  volatile uint8_t* _CS_PORT; //Output register for _CS_PIN (resolved once in A7105_Initialize so we can skip digitalWrite)
+  uint8_t _CS_MASK; //Bit mask for _CS_PIN within _CS_PORT
+  uint32_t _SPI_CLOCK; //SPI clock rate for this radio (A7105_SPI_CLOCK unless A7105_Train_SPI_Clock() found a better one)
+  int _STATE; //Last mode strobed (A7105_STANDBY, A7105_RX, etc), 0 if unknown. Used to skip redundant strobes.
   int _INTERRUPT_PIN;  //The pin mapped to GIO2 that get's interrupts on TX/RX (used for tracking data being available)
                        //-1 if no interrupt pin specified 
+#ifdef A7105_3WIRE_SPI
+  int _TX_DONE_PIN; //The pin mapped to GIO1 (TMEO) that gets interrupts at the end of a TX, -1 if none
+#endif
+  volatile byte _EVENTS; //A7105_EVENT_* flags, updated by the WTR pin interrupt
+  volatile unsigned long _RX_TIMESTAMP; //micros() when the WTR pin interrupt saw the last packet arrive
   int _USE_CRC; //0/1 if CRC is disabled/enabled on the radio
   int _USE_FEC; //0/1 if FEC is disabled/enabled on the radio
   byte _DATA_RATE; //Remember our current data rate setting
+  int _CAL_EEPROM_ADDR; //EEPROM address of this radio's calibration cache (-1 if it isn't using one)
+  byte _RSSI_THOLD; //Carrier sense threshold (what's written to A7105_1D_RSSI_THOLD)
+  byte _RX_MODE; //Snapshot of the MODE register taken at the end of the last A7105_ReadData_Async()
+
+  //Shadow register cache (last value written to each control register) so
+  //we can skip writes that wouldn't change anything
+  byte _SHADOW_REGS[A7105_NUM_REGISTERS];
+  byte _SHADOW_VALID[(A7105_NUM_REGISTERS+7)/8]; //bitmask of _SHADOW_REGS entries that are known good
+  uint16_t _WRITES_ELIDED; //Register writes skipped because the shadow cache already matched
+  uint16_t _STROBES_ELIDED; //Mode strobes skipped because the radio was already in that state
+
+  //RX ring (see A7105_RX_Ring_Begin()). Only the WTR interrupt moves _RX_RING_HEAD and
+  //only the reader moves _RX_RING_TAIL, both count up forever (slot = count % _RX_RING_SIZE)
+  struct A7105_RX_Frame* _RX_RING; //NULL if the ring isn't in use
+  byte _RX_RING_SIZE;
+  volatile byte _RX_RING_HEAD;
+  volatile byte _RX_RING_TAIL;
+  volatile byte _RX_RING_PENDING; //A packet is waiting in the FIFO for the SPI bus to free up
+  volatile uint16_t _RX_RING_DROPPED; //Packets lost because the ring was full
+  volatile uint16_t _RX_RING_FILTERED; //Packets the ring filter dropped
+  byte (*_RX_RING_CALLBACK)(struct A7105*,struct A7105_RX_Frame*,void*);
+  byte (*_RX_RING_FILTER)(struct A7105*,struct A7105_RX_Frame*,void*);
+  void* _RX_RING_CONTEXT;
+};
+
+/*
+  Extra information about a received packet (see A7105_ReadData()).
+*/
+struct A7105_RX_Metadata
+{
+  byte rssi; //The radio's RSSI measurement (ADC reading of 1Dh) for the packet. NOTE: Lower is a stronger signal
+  unsigned long timestamp; //micros() when the packet finished arriving (taken in the WTR pin interrupt,
+                           //or when it was read if the radio has no WTR pin)
+  A7105_Status_Code status; //A7105_STATUS_OK or A7105_RX_DATA_INTEGRITY_ERROR (CRC/FEC failure)
+};
+
+/*
+  A packet the WTR interrupt copied out of the FIFO into an RX ring (see 
+  A7105_RX_Ring_Begin()).
+*/
+struct A7105_RX_Frame
+{
+  byte data[A7105_RX_RING_FRAME_SIZE];
+  byte len; //Bytes read from the FIFO (the packet length the radio was listening for)
+  byte tag; //Free for the ring callback to mark the frame with (0 otherwise)
+  struct A7105_RX_Metadata meta;
+};
+
+/*
+  One piece of a packet for A7105_WriteData_Gather(). A NULL 'data' sends 'len'
+  zeros and a 'len' of 0 ends a list of segments.
+*/
+struct A7105_TX_Segment
+{
+  byte* data;
+  byte len;
+};
+
+/*
+  An SPI transfer for the interrupt driven transfer engine. A transfer is
+  one chip-select window: the 'command' byte (register address or strobe)
+  followed by 'len' data bytes. Data bytes come from 'tx_buffer' or, if that
+  is NULL, are all 'data' (so single register writes don't need a buffer).
+  If 'segments' isn't NULL the data bytes are gathered from those instead
+  (then 'data' once they run out). If 'rx_buffer' isn't NULL, the bytes 
+  clocked in during the data phase are stored there.
+*/
+struct A7105_SPI_Transfer
+{
+  struct A7105* radio;
+  byte command;
+  byte data;
+  byte* tx_buffer;
+  byte* rx_buffer;
+  byte len;
+  void (*callback)(struct A7105*,void*); //Called (from interrupt context!) when the transfer finishes, may be NULL
+  void* context;
+  struct A7105_TX_Segment* segments;
 };
 
 void mm_debug(struct A7105* radio);
@@ -243,13 +421,41 @@ void A7105_Initialize:
 
   This function initializes the A7105 structure, sets up the chip-select pin, 
   and configures the A7105 radio to use the GPIO1/2 pins for MISO and WTR functions
-  respectively. This function does *not* guarantee correct connections or the
+  respectively (TMEO and WTR with A7105_3WIRE_SPI). This function does *not* guarantee correct connections or the
   required radio calibration and set-up before you can start pushing data around. 
   Check out A7105_Easy_Setup_Radio() for a function that handles all that.
 */
 void A7105_Initialize(struct A7105* radio, int chip_select_pin);
 void A7105_Initialize(struct A7105* radio, int chip_select_pin, int reset);
 
+/*
+uint32_t A7105_Train_SPI_Clock:
+  * radio: A A7105 structure that has been previously passed to A7105_Initialize (i.e. it's configured)
+
+  Side Effects/Notes:
+    * This resets the radio (a probe at a clock that's too fast can land on any register,
+      00h resets the chip) and sets GIO1/GIO2 back up like A7105_Initialize(). Set up
+      everything else (ID, FIFO, etc) afterwards.
+    * A7105_Easy_Setup_Radio() calls this if A7105_SPI_TRAINING is defined.
+
+  This function works out how fast this radio's SPI wiring can really be clocked. Starting
+  A7105_SPI_TRAINING_STEPS halvings below A7105_SPI_CLOCK_MAX and doubling each step, it writes
+  A7105_SPI_TRAINING_ROUNDS test patterns (0x55/0xAA, walking ones and zeros) to the ID 
+  register and reads them back, stopping at the first clock that garbles one. For margin the
+  fastest clock that passed (A7105_SPI_CLOCK_MAX included, the datasheet doesn't let us test
+  past it) then has to get through A7105_SPI_TRAINING_CONFIRM_ROUNDS more patterns, if it
+  garbles any we back off a step. The radio uses the clock picked for everything it does 
+  from then on. Clean boards keep A7105_SPI_CLOCK_MAX while flaky harnesses fall back on 
+  their own.
+
+  NOTE: The hardware SPI can only divide its own clock, so neighbouring steps may end up
+        running at the same speed (i.e. 10MHz is really 8MHz on a 16MHz Arduino).
+
+  Returns: The SPI clock picked (also stored in the radio), 0 if even the slowest clock
+           failed (the radio is left on that slowest clock and is probably not connected).
+*/
+uint32_t A7105_Train_SPI_Clock(struct A7105* radio);
+
 /*
   void A7105_WriteReg:
     * radio: A A7105 structure that has been previously passed to A7105_Initialize (i.e. it's configured)
@@ -257,7 +463,8 @@ void A7105_Initialize(struct A7105* radio, int chip_select_pin, int reset);
     * value: The byte (or uint32_t) value to write to the register
 
   This function writes values to the A7105 registers using the transactional SPI library 
-  from the Arduino source.
+  from the Arduino source. Single byte writes that match the shadow register cache are 
+  skipped (see A7105_Shadow_Invalidate()).
 */
 void A7105_WriteReg(struct A7105* radio, byte addr, byte value);
 void A7105_WriteReg(struct A7105* radio, byte addr, uint32_t value);
@@ -285,6 +492,71 @@ A7105_Status_Code A7105_WriteData:
 */
 A7105_Status_Code A7105_WriteData(struct A7105* radio, byte *dpbuffer, byte len);
 
+/*
+A7105_Status_Code A7105_WriteData_Async:
+  * radio, dpbuffer, len: See A7105_WriteData() above.
+  * callback: Function to call once the FIFO is loaded and the TX strobe has been
+              sent (i.e. the packet is in the air). May be NULL.
+              NOTE: This is called from interrupt context so keep it short.
+  * context: Passed verbatim to 'callback'
+
+  Side-Effects/Notes:
+    This function queues the whole TX sequence on the interrupt driven SPI engine and
+    returns right away so the calling code can keep working while the FIFO is loaded.
+    'dpbuffer' is read from interrupt context, so it must not be modified or go out of 
+    scope until 'callback' is called (or A7105_SPI_Busy() returns false).
+
+  Returns:
+    * A7105_STATUS_OK: If the transmission was queued
+    * A7105_INVALID_FIFO_LENGTH: If the length specified was not a legitimate value (multiple of 8 in 1-64)
+    * A7105_BUSY: If the radio is still transmitting or there isn't room in the SPI queue
+*/
+A7105_Status_Code A7105_WriteData_Async(struct A7105* radio,
+                                        byte *dpbuffer,
+                                        byte len,
+                                        void (*callback)(struct A7105*,void*),
+                                        void* context);
+
+/*
+A7105_Status_Code A7105_WriteData_Gather:
+  * radio, len, callback, context: See A7105_WriteData_Async() above.
+  * segments: The pieces of the packet in order, ended by a segment with a 'len' of 0 
+              (see struct A7105_TX_Segment)
+
+  This function sends a packet that's spread over several buffers (i.e. a header
+  and a payload that lives somewhere else) without copying it together first. The
+  segments are streamed into the FIFO one after the other in a single chip-select
+  window and the packet is zero padded out to 'len' on the fly (anything past 'len'
+  is cut off).
+
+  Side-Effects/Notes:
+    Like A7105_WriteData_Async() the segments and the buffers they point to are read
+    from interrupt context, leave them alone until 'callback' is called (or 
+    A7105_SPI_Busy() returns false).
+
+  Returns:
+    See A7105_WriteData_Async() above.
+*/
+A7105_Status_Code A7105_WriteData_Gather(struct A7105* radio,
+                                         struct A7105_TX_Segment* segments,
+                                         byte len,
+                                         void (*callback)(struct A7105*,void*),
+                                         void* context);
+
+/*
+void A7105_Shadow_Invalidate:
+  * radio: A A7105 structure that has been previously passed to A7105_Initialize (i.e. it's configured)
+
+  The driver keeps a copy of every control register it writes (and the last mode 
+  it strobed) so redundant writes/strobes can be skipped. Call this if you poke the radio
+  behind the library's back (i.e. anything other than these functions) so the next write
+  to every register goes through. A7105_Reset() calls this for you.
+
+  The number of skipped writes/strobes are kept in radio->_WRITES_ELIDED and
+  radio->_STROBES_ELIDED (these just wrap around, they're for benchmarking).
+*/
+void A7105_Shadow_Invalidate(struct A7105* radio);
+
 /*
   void A7105_ReadReg:
     * radio: A A7105 structure that has been previously passed to A7105_Initialize (i.e. it's configured)
@@ -306,10 +578,15 @@ A7105_Status_Code A7105_ReadData:
            calibrated all the registers for the radio.
   * dpbuffer: A byte array of *at least* 'len' length.
   * len: the number of bytes to read. The maximum value for this is 64.
+  * metadata: (optional) If not NULL, filled in with the RSSI, arrival time and 
+              CRC/FEC status of the packet (costs one extra register read for the RSSI).
+              Only valid if A7105_STATUS_OK or A7105_RX_DATA_INTEGRITY_ERROR is returned.
 
   Side-Effects/Notes:
     This function will try to read data always if no interrupt pin was specified. If you aren't using interrupts,
     make sure you wait long enough to have guaranteed delivery.
+    If the radio has an RX ring (A7105_RX_Ring_Begin()) the oldest packet in the ring is 
+    copied out (and released) instead, the radio is already listening again.
 
   Returns:
     * A7105_NO_DATA: If an interrupt wtr pin was specified for the radio and data was detected via that interrupt pin.
@@ -324,6 +601,169 @@ A7105_Status_Code A7105_ReadData:
                                      into 'dpbuffer' but do *NOT* trust it's integrity.
 */
 A7105_Status_Code A7105_ReadData(struct A7105* radio, byte *dpbuffer, byte len);
+A7105_Status_Code A7105_ReadData(struct A7105* radio, byte *dpbuffer, byte len, struct A7105_RX_Metadata* metadata);
+
+/*
+A7105_Status_Code A7105_ReadData_Async:
+  * radio, dpbuffer, len: See A7105_ReadData() above.
+  * callback: Function to call once the FIFO has been read into 'dpbuffer'. May be NULL.
+              NOTE: This is called from interrupt context so keep it short.
+  * context: Passed verbatim to 'callback'
+
+  Side-Effects/Notes:
+    This queues the FIFO read on the interrupt driven SPI engine and returns right away.
+    'dpbuffer' isn't valid until 'callback' is called (or A7105_SPI_Busy() returns false). 
+    Use A7105_Async_RX_Status() after that to check the CRC/FEC flags for the data.
+    With an RX ring the packet is copied out of the ring and 'callback' called before 
+    this returns.
+
+  Returns:
+    * A7105_NO_DATA, A7105_INVALID_FIFO_LENGTH: See A7105_ReadData() above.
+    * A7105_BUSY: If there isn't room in the SPI queue
+    * A7105_STATUS_OK: If the read was queued
+*/
+A7105_Status_Code A7105_ReadData_Async(struct A7105* radio,
+                                       byte *dpbuffer,
+                                       byte len,
+                                       void (*callback)(struct A7105*,void*),
+                                       void* context);
+
+/*
+A7105_Status_Code A7105_Async_RX_Status:
+  * radio: A radio that has finished an A7105_ReadData_Async() call
+
+  Returns:
+    * A7105_RX_DATA_INTEGRITY_ERROR: If CRC/FEC is enabled and the last async read failed the check
+    * A7105_STATUS_OK: Otherwise
+*/
+A7105_Status_Code A7105_Async_RX_Status(struct A7105* radio);
+
+/*
+A7105_Status_Code A7105_SetFIFOSegment:
+  * radio: A A7105 structure that has been previously passed to A7105_Initialize (i.e. it's configured)
+  * start: The first FIFO byte of the segment (0-63)
+  * len: The number of bytes in the segment
+
+  This function puts the radio in FIFO segment mode so the next TX sends (or RX fills)
+  only bytes 'start' through 'start + len - 1' of the FIFO. This lets you load several
+  short packets into the FIFO once (A7105_Strobe(A7105_RST_WRPTR) and A7105_WriteBurst())
+  and send each of them with just this call and A7105_Strobe(radio, A7105_TX).
+
+  Side-Effects/Notes:
+    * A7105_WriteData(), A7105_WriteData_Async() and A7105_Easy_Listen_For_Packets() put
+      the FIFO back to the default (start at 0) layout.
+
+  Returns:
+    * A7105_INVALID_FIFO_LENGTH: If the segment doesn't fit in the 64 byte FIFO
+    * A7105_STATUS_OK: Otherwise
+*/
+A7105_Status_Code A7105_SetFIFOSegment(struct A7105* radio, byte start, byte len);
+
+/*
+A7105_Status_Code A7105_WriteData_Extended:
+  * radio: Pointer to a valid A7105 structure for state tracking. This 
+           must have a WTR interrupt pin (see A7105_Easy_Setup_Radio()).
+  * data:  A valid byte array that is at least 'length' bytes long
+  * length: The length of the packet to send (1-256)
+
+  This function sends a packet longer than the FIFO using the radio's FIFO extension
+  mode. The first 64 bytes are loaded before the TX starts and the rest are streamed
+  in A7105_FIFO_EXT_CHUNK byte pieces as the radio drains the FIFO. The whole packet 
+  goes out with a single preamble/ID, which is much less airtime than sending the 
+  same data as several 64 byte packets.
+
+  Side-Effects/Notes:
+    * This function blocks until the packet has been sent (i.e. ~1s for 256 bytes at 2Kbps).
+    * GIO2 is switched from WTR to FPF (FIFO pointer flag) for the duration of the call 
+      since it's the only radio pin we can watch (GIO1 is the SPI MISO). The WTR interrupt
+      state is reset when we're done, so don't expect A7105_CheckRXWaiting() to report
+      anything from while this was running.
+    * The receiver has to be using A7105_ReadData_Extended() with the same length.
+
+  Returns:
+    * A7105_NO_WTR_INTERRUPT_SET: If the radio doesn't have a WTR interrupt pin
+    * A7105_INVALID_FIFO_LENGTH: If 'length' is 0 or longer than A7105_MAX_EXTENDED_FIFO_SIZE
+    * A7105_BUSY: If the radio stopped taking data (timed out waiting on FPF or the end of the TX)
+    * A7105_STATUS_OK: If the packet was sent
+*/
+A7105_Status_Code A7105_WriteData_Extended(struct A7105* radio, byte *dpbuffer, uint16_t len);
+
+/*
+A7105_Status_Code A7105_ReadData_Extended:
+  * radio: Pointer to a valid A7105 structure for state tracking. This 
+           must have a WTR interrupt pin (see A7105_Easy_Setup_Radio()).
+  * data:  A valid byte array that is at least 'length' bytes long
+  * length: The length of the packet to receive (1-256)
+  * timeout: milliseconds to wait for the packet to start arriving
+
+  This function is the receiving end of A7105_WriteData_Extended(). It puts
+  the radio in RX and reads the packet out of the FIFO while it's still arriving.
+
+  Side-Effects/Notes:
+    * This function blocks until the packet is received or 'timeout' runs out.
+    * See A7105_WriteData_Extended() for notes on the GIO2 pin.
+    * The radio is left in standby, call A7105_Easy_Listen_For_Packets() to go back
+      to listening for regular packets.
+
+  Returns:
+    * A7105_NO_WTR_INTERRUPT_SET: If the radio doesn't have a WTR interrupt pin
+    * A7105_INVALID_FIFO_LENGTH: If 'length' is 0 or longer than A7105_MAX_EXTENDED_FIFO_SIZE
+    * A7105_NO_DATA: If no packet showed up before 'timeout' (or it stopped mid-packet)
+    * A7105_RX_DATA_INTEGRITY_ERROR: If CRC/FEC is enabled and the packet failed the check
+    * A7105_STATUS_OK: If the whole packet was received
+*/
+A7105_Status_Code A7105_ReadData_Extended(struct A7105* radio, byte *dpbuffer, uint16_t len, unsigned long timeout);
+
+/*
+void A7105_ReadBurst:
+  * radio: A A7105 structure that has been previously passed to A7105_Initialize (i.e. it's configured)
+  * addr: The register to read from. This should be a register that streams multiple
+          bytes (i.e. A7105_05_FIFO_DATA or A7105_06_ID_DATA).
+  * buffer: A byte array of *at least* 'len' length.
+  * len: The number of bytes to read.
+
+  This function reads 'len' bytes from a single address while holding
+  the chip-select low and the SPI bus in one transaction. This is
+  much cheaper than calling A7105_ReadReg() 'len' times since we only
+  pay the chip-select and transaction overhead once.
+*/
+void A7105_ReadBurst(struct A7105* radio, byte addr, byte* buffer, byte len);
+
+/*
+void A7105_WriteBurst:
+  * radio: A A7105 structure that has been previously passed to A7105_Initialize (i.e. it's configured)
+  * addr: The register to write to (A7105_05_FIFO_DATA or A7105_06_ID_DATA)
+  * buffer: A byte array of *at least* 'len' length.
+  * len: The number of bytes to write.
+
+  This is the write version of A7105_ReadBurst().
+*/
+void A7105_WriteBurst(struct A7105* radio, byte addr, byte* buffer, byte len);
+
+/*
+void A7105_ReadRegBlock:
+  * radio: A A7105 structure that has been previously passed to A7105_Initialize (i.e. it's configured)
+  * start_addr: The first register in the block to read
+  * buffer: A byte array of *at least* 'len' length.
+  * len: The number of consecutive registers to read (start_addr through start_addr+len-1)
+
+  Side-Effects/Notes:
+    The A7105 doesn't auto-increment the address for the control registers
+    so we still have to send an address byte (and toggle the chip-select) for
+    every register, but the whole block is done inside a single SPI transaction.
+*/
+void A7105_ReadRegBlock(struct A7105* radio, byte start_addr, byte* buffer, byte len);
+
+/*
+void A7105_WriteRegBlock:
+  * radio: A A7105 structure that has been previously passed to A7105_Initialize (i.e. it's configured)
+  * start_addr: The first register in the block to write
+  * buffer: A byte array of *at least* 'len' length.
+  * len: The number of consecutive registers to write (start_addr through start_addr+len-1)
+
+  This is the write version of A7105_ReadRegBlock().
+*/
+void A7105_WriteRegBlock(struct A7105* radio, byte start_addr, byte* buffer, byte len);
 
 /*
 A7105_Status_Code A7105_CheckTXFinished:
@@ -333,8 +773,10 @@ A7105_Status_Code A7105_CheckTXFinished:
            calibrated all the registers for the radio.
 
   This function checks if the TX data previously sent has finished transmission.
-  This checks the MODE (00h) register of the radio and doesn't depend on 
-  interrupts to work.
+  If the radio has a WTR interrupt pin, this doesn't touch the SPI bus until the
+  falling edge at the end of the TX has been seen, so it's cheap enough to poll
+  from loop(). Otherwise (and to confirm the edge) it checks the MODE (00h) 
+  register of the radio.
 
   Returns:
     A7105_STATUS_OK: If the radio TRX circuitry is idle (i.e. done sending)
@@ -354,6 +796,8 @@ A7105_Status_Code A7105_CheckRXWaiting:
   NOTE: This only works if an interrupt pin was specified with A7105_Easy_Setup_Radio()
         to be used as connected to the GPIO2 pin of the A7105 that acts as a WTR pin.
 
+  With an RX ring (A7105_RX_Ring_Begin()) this checks the oldest packet in the ring.
+
   Returns:
     A7105_NO_DATA: If interrupt pin was configured, but no data is waiting to be read
     A7105_RX_DATA_WAITING: If interrupt pin was configured and data is waiting to be read
@@ -365,6 +809,142 @@ A7105_Status_Code A7105_CheckRXWaiting:
  */
 A7105_Status_Code A7105_CheckRXWaiting(struct A7105* radio);
 
+//RX ring
+
+/*
+A7105_Status_Code A7105_RX_Ring_Begin:
+  * radio: A radio that was set up with a WTR pin (see A7105_Easy_Setup_Radio())
+  * frames: Storage for the ring, 'count' A7105_RX_Frame's that stay valid until A7105_RX_Ring_End()
+  * count: Number of slots in the ring (1-127)
+  * callback: (optional) Called from the WTR interrupt for each packet after it's read 
+              (before RX is re-armed) and may set the frame's 'tag'. Returns the packet 
+              length to listen for next (1-64, multiples of 8) or 0 to keep the current one. 
+              May be NULL.
+  * context: Passed verbatim to 'callback' (and the filter, see A7105_RX_Ring_Set_Filter())
+
+  The A7105 FIFO only holds one packet and the radio stops listening once it 
+  has it, so anything that shows up before the sketch reads the FIFO and calls 
+  A7105_Easy_Listen_For_Packets() again is lost. With a ring, the WTR interrupt 
+  copies each packet (data, RSSI, CRC/FEC status and arrival time) into the next 
+  free slot and puts the radio straight back in RX. The sketch takes packets out 
+  in order with A7105_RX_Ring_Peek()/A7105_RX_Ring_Pop() (or A7105_ReadData()).
+
+  Side-Effects/Notes:
+    * The interrupt needs the SPI bus for the copy. If the bus is busy with a transfer
+      from the sketch (or the SPI engine) the copy waits until that transfer is done.
+    * Packets that arrive while the ring is full are dropped (counted in _RX_RING_DROPPED)
+      but the radio keeps listening.
+    * A7105_WriteData_Extended()/A7105_ReadData_Extended() can't be used with a ring.
+
+  Returns:
+    * A7105_NO_WTR_INTERRUPT_SET: If the radio doesn't have a WTR pin
+    * A7105_INVALID_FIFO_LENGTH: If 'count' is out of range
+    * A7105_STATUS_OK: If the ring is running
+*/
+A7105_Status_Code A7105_RX_Ring_Begin(struct A7105* radio,
+                                      struct A7105_RX_Frame* frames,
+                                      byte count,
+                                      byte (*callback)(struct A7105*,struct A7105_RX_Frame*,void*),
+                                      void* context);
+
+//Stops using the RX ring, packets still in it are thrown away
+void A7105_RX_Ring_End(struct A7105* radio);
+
+/*
+void A7105_RX_Ring_Set_Filter:
+  * radio: A radio with an RX ring (see A7105_RX_Ring_Begin())
+  * filter: Called from the WTR interrupt with the part of the packet read so far (frame->len
+            bytes, starting at 0) and the ring's context. Returns A7105_RX_RING_DROP to throw 
+            the packet away, A7105_RX_RING_KEEP to read the rest of it into the ring or the 
+            number of bytes it needs to see to decide. NULL reads every packet whole.
+
+  Most of an SPI FIFO read is wasted on packets the sketch is going to throw away
+  (repeats it's already seen, replies meant for someone else). With a filter, the
+  WTR interrupt checks the CRC/FEC flags first, then reads the packet a few bytes
+  at a time for as long as the filter asks for more. Dropped packets never take a
+  ring slot and the rest of them is never read.
+
+  Side-Effects/Notes:
+    * Packets that failed CRC/FEC aren't shown to the filter or read at all, they go 
+      in the ring with a 'len' of 0 (and the error in their metadata).
+    * The ring callback still sees dropped packets (with the bytes the filter read) so
+      it can keep track of packet lengths, they're counted in _RX_RING_FILTERED.
+*/
+void A7105_RX_Ring_Set_Filter(struct A7105* radio,
+                              byte (*filter)(struct A7105*,struct A7105_RX_Frame*,void*));
+
+/*
+struct A7105_RX_Frame* A7105_RX_Ring_Peek:
+  * radio: A radio with an RX ring (see A7105_RX_Ring_Begin())
+
+  Returns the oldest packet in the ring (NULL if it's empty). The slot belongs 
+  to the caller until A7105_RX_Ring_Pop() hands it back to the interrupt.
+*/
+struct A7105_RX_Frame* A7105_RX_Ring_Peek(struct A7105* radio);
+
+//Releases the packet returned by A7105_RX_Ring_Peek()
+void A7105_RX_Ring_Pop(struct A7105* radio);
+
+//Interrupt driven SPI transfer engine
+
+/*
+A7105_Status_Code A7105_SPI_Queue:
+  * radio: A A7105 structure that has been previously passed to A7105_Initialize (i.e. it's configured)
+  * command, data, tx_buffer, rx_buffer, len: See struct A7105_SPI_Transfer above.
+  * callback: Function to call (from interrupt context) when the transfer finishes, may be NULL.
+  * context: Passed verbatim to 'callback'
+
+  This function adds a transfer to the end of the SPI queue. Transfers are run
+  in the order they're queued by the SPI-complete interrupt (one byte per interrupt), so
+  the calling code gets its CPU back while the bytes are clocked out. The synchronous
+  functions in this library (A7105_WriteReg(), A7105_ReadReg(), etc.) wait for the queue 
+  to empty before touching the bus so ordering is always preserved.
+
+  Side-Effects/Notes:
+    If the engine is disabled (A7105_DISABLE_ASYNC_SPI or a non-AVR target) the transfer
+    is run (and 'callback' called) before this function returns.
+
+  Returns:
+    * A7105_STATUS_OK: If the transfer was queued
+    * A7105_BUSY: If the queue is full
+*/
+A7105_Status_Code A7105_SPI_Queue(struct A7105* radio,
+                                  byte command,
+                                  byte data,
+                                  byte* tx_buffer,
+                                  byte* rx_buffer,
+                                  byte len,
+                                  void (*callback)(struct A7105*,void*),
+                                  void* context);
+
+/*
+void A7105_SPI_Transfer:
+  Blocking version of A7105_SPI_Queue(). Waits for any queued transfers to finish
+  and then runs this one (polled, since we'd just be spinning anyway).
+*/
+void A7105_SPI_Transfer(struct A7105* radio,
+                        byte command,
+                        byte* tx_buffer,
+                        byte* rx_buffer,
+                        byte len);
+
+//Returns true if the SPI engine has transfers queued or in progress
+byte A7105_SPI_Busy();
+
+//Blocks until the SPI engine queue is empty. 
+//NOTE: Don't call this from an interrupt (or with interrupts disabled), it will never return.
+void A7105_SPI_Wait();
+
+/*
+void _A7105_SPI_Claim() / _A7105_SPI_Release():
+  Internal functions that wrap a polled SPI transaction (the chip select goes
+  low between them). While the bus is claimed the WTR interrupt leaves 
+  received packets in the FIFO, the release copies them to their RX rings.
+  Only exposed for the A7105Radio<> front-end (a7105_radio.h).
+*/
+void _A7105_SPI_Claim();
+void _A7105_SPI_Release();
+
 /*
 void A7105_Reset:
   * radio: A A7105 structure that has been previously passed to A7105_Initialize (i.e. it's configured)
@@ -376,6 +956,37 @@ void A7105_Reset:
 */
 void A7105_Reset(struct A7105* radio);
 
+/*
+A7105_Status_Code A7105_SetChannel:
+  * radio: A radio that was previously set up with A7105_Easy_Setup_Radio()
+  * channel: The channel to switch to (0-A8)
+
+  This function re-tunes the radio to 'channel'. If the calibration cache has
+  results for 'channel', they're written straight to the radio (a handful of 
+  register writes, no waiting on the radio). Otherwise the radio is auto-calibrated
+  (this can take a while, see A7105_CALIBRATION_TIMEOUT) and the results are cached.
+
+  Side-Effects/Notes:
+    * The radio is left in standby, call A7105_Easy_Listen_For_Packets() to start
+      listening on the new channel.
+
+  Returns:
+    * A7105_INVALID_CHANNEL: If 'channel' is outside the allowable range of 0-A8 
+    * A7105_CALIBRATION_ERROR: If the auto-calibration failed or timed out
+    * A7105_STATUS_OK: Otherwise
+*/
+A7105_Status_Code A7105_SetChannel(struct A7105* radio, byte channel);
+
+/*
+void A7105_Clear_Calibration_Cache:
+  * radio: A radio that was previously set up with A7105_Easy_Setup_Radio()
+
+  This function forgets all the cached calibration results for 'radio' so every 
+  channel is auto-calibrated again the next time it's used (i.e. if the radio
+  was swapped or is running at a very different temperature than when it was cached).
+*/
+void A7105_Clear_Calibration_Cache(struct A7105* radio);
+
 /*
 void A7105_SetPower:
   * radio: A A7105 structure that has been previously passed to A7105_Initialize (i.e. it's configured)
@@ -388,6 +999,34 @@ void A7105_SetPower:
 */
 void A7105_SetPower(struct A7105* radio, A7105_TxPower power);
 
+/*
+void A7105_Set_RSSI_Threshold:
+  * radio: A A7105 structure that has been previously passed to A7105_Initialize (i.e. it's configured)
+  * threshold: RSSI ADC reading below which the channel is considered busy 
+               (A7105_DEFAULT_RSSI_THOLD by default, lower values are stronger signals)
+
+  Sets the carrier sense threshold used by A7105_Check_Channel_Clear() (and the
+  radio's own carrier detect, A7105_1D_RSSI_THOLD).
+*/
+void A7105_Set_RSSI_Threshold(struct A7105* radio, byte threshold);
+
+/*
+A7105_Status_Code A7105_Check_Channel_Clear:
+  * radio: A radio that was previously set up with A7105_Easy_Setup_Radio()
+
+  This function samples the channel before a TX (listen-before-talk). It's
+  cheapest when the radio is already listening (A7105_Easy_Listen_For_Packets()):
+  one register read. Otherwise the radio is strobed to RX for A7105_RSSI_SETTLE_US
+  to take a reading and put back in standby.
+
+  Returns:
+    * A7105_BUSY: If the RSSI reading is stronger than the threshold (see 
+                  A7105_Set_RSSI_Threshold()) or the WTR interrupt says a packet 
+                  just arrived (someone else is talking)
+    * A7105_STATUS_OK: If the channel looks clear
+*/
+A7105_Status_Code A7105_Check_Channel_Clear(struct A7105* radio);
+
 /*
 void A7105_Strobe:
   * radio: A A7105 structure that has been previously passed to A7105_Initialize (i.e. it's configured)
@@ -421,7 +1060,8 @@ A7105_Status_Code A7105_Setup_Radio:
              makes this pin go high when the radio is active TX or 
              RX. Specify -1 to ignore. Otherwise, a pin interrupt 
              will be set for this pin and it will be specified as 
-             input.
+             input. Each radio needs its own WTR pin (up to A7105_MAX_RADIOS).
+             Pins 2 and 3 have the quickest interrupts with A7105_EXTERNAL_WTR_INTERRUPTS.
   * radio_id: 4-byte ID to use for communicating radios to recognize
               each-other's traffic. All radios that talk to each other
               should have the same 'radio_id'
@@ -434,10 +1074,16 @@ A7105_Status_Code A7105_Setup_Radio:
   * use_FEC: 0 or 1 to disable/enable the use of Foward Error Correction 
              (that is 1 bit auto correction for every 4-bit nibble) transmitted.
              This is done on the A7105 chip and affects transmission time.
+  * cal_eeprom_addr: (optional) EEPROM address of this radio's calibration cache
+                     (A7105_CAL_EEPROM_SIZE bytes). Defaults to A7105_CAL_EEPROM_ADDR,
+                     give each radio its own region if you use more than one.
+                     Specify -1 to always auto-calibrate.
 
   Side Effects/Notes:
     Be sure to call this method from the setup() function since
     we do some pinMode() stuff in here and SPI.begin() calls.
+    The SPI clock for the radio is trained (see A7105_Train_SPI_Clock())
+    if A7105_SPI_TRAINING is defined.
 
 
   Returns:
@@ -447,13 +1093,16 @@ A7105_Status_Code A7105_Setup_Radio:
                         read back the clock settings as a sanity check 
                         to make sure the radio isn't just a black hole.
     * A7105_CALIBRATION_ERROR: If the auto-calibration fails for the 
-                               chip. A7105's have to be auto-calibrated
+                               chip. A7105's have to be calibrated
                                every time they're reset or powered on
-                               and that is done in this function.
+                               and that is done in this function (from
+                               the calibration cache if possible).
     * A7105_INVALID_CHANNEL: If the specified channel is outside
                              the allowable range of 0-A8 (given our
                              pre-set and datasheet recommended channel
                              steps).
+    * A7105_TOO_MANY_RADIOS: If 'wtr_pin' was specified and A7105_MAX_RADIOS
+                             radios already have WTR interrupts set up.
 */
 A7105_Status_Code A7105_Easy_Setup_Radio(struct A7105* radio, 
                                     int cs_pin, 
@@ -464,6 +1113,16 @@ A7105_Status_Code A7105_Easy_Setup_Radio(struct A7105* radio,
                                     A7105_TxPower power,
                                     int use_CRC,
                                     int use_FEC);
+A7105_Status_Code A7105_Easy_Setup_Radio(struct A7105* radio, 
+                                    int cs_pin, 
+                                    int wtr_pin, 
+                                    uint32_t radio_id, 
+                                    A7105_DataRate data_rate,
+                                    byte channel,
+                                    A7105_TxPower power,
+                                    int use_CRC,
+                                    int use_FEC,
+                                    int cal_eeprom_addr);
 /*
 A7105_Status_Code A7105_Easy_Listen_For_Packets:
   * radio: Pointer to a valid A7105 structure for state tracking. This 
@@ -482,15 +1141,73 @@ A7105_Status_Code A7105_Easy_Listen_For_Packets(struct A7105* radio,
                                                 byte length);
 
 
+/*
+byte A7105_Get_Events:
+  * radio: A radio that was set up with a WTR pin (see A7105_Easy_Setup_Radio())
+
+  Returns the A7105_EVENT_* flags for 'radio' (0 if it has no WTR pin). 
+  This doesn't clear anything, the flags are cleared by the functions that 
+  consume them (A7105_ReadData(), A7105_WriteData(), A7105_Easy_Listen_For_Packets(), etc).
+  Handy for polling several radios without touching the SPI bus.
+*/
+byte A7105_Get_Events(struct A7105* radio);
+
+/*
+void A7105_Pause/A7105_Resume:
+  * radio: A radio that was set up with a WTR pin (see A7105_Easy_Setup_Radio())
+
+  Stop/start listening to the WTR pin interrupt for 'radio' (i.e. while the 
+  sketch is doing something timing sensitive). Events that happen while 
+  paused are lost.
+*/
 void A7105_Pause(struct A7105* radio);
 void A7105_Resume(struct A7105* radio);
 
+#ifdef A7105_3WIRE_SPI
+/*
+A7105_Status_Code A7105_Set_TX_Done_Pin:
+  * radio: A radio that was set up with a WTR pin (see A7105_Easy_Setup_Radio())
+  * tx_done_pin: The arduino pin connected to the radio's GIO1 pin (-1 to stop using it)
+
+  With 3-wire SPI, GIO1 is free to carry TMEO, which falls when the radio finishes
+  sending. This function attaches a falling edge interrupt to it so the end of a TX
+  and a received packet are separate interrupts: 'tx_done_pin' moves the radio from
+  A7105_EVENT_TX_ACTIVE to A7105_EVENT_TX_DONE and the WTR pin only ever reports
+  packets. A7105_CheckTXFinished() then doesn't need to read the MODE register to 
+  rule out an RX we cut short, and WTR edges from the end of our own TX (or an RX
+  aborted to start one) are ignored instead of being taken for the end of the TX.
+
+  Side-Effects/Notes:
+    * GIO1 is carrier detect in RX, so its edges are ignored unless a TX strobe
+      is out (A7105_EVENT_TX_ON_AIR).
+
+  Returns:
+    * A7105_NO_WTR_INTERRUPT_SET: If the radio doesn't have a WTR pin
+    * A7105_STATUS_OK: If the pin was set up (or removed)
+*/
+A7105_Status_Code A7105_Set_TX_Done_Pin(struct A7105* radio, int tx_done_pin);
+#endif
+
 
 /*
 void _A7105_Pin_Interrupt_Callback():
   This is an internal function that is the registered callback with 
   the PinChangeInterrupt library that we use to detect FALLING edges
-  on the WTR pin that signal the end of either a TX or an RX operation.
+  on the WTR pins that signal the end of either a TX or an RX operation
+  (and on the TX done pins, see A7105_Set_TX_Done_Pin()).
+  It looks up the radio that owns the pin and updates its _EVENTS (or
+  copies the packet into the radio's RX ring, see A7105_RX_Ring_Begin()).
 */
 void _A7105_Pin_Interrupt_Callback();
+
+/*
+byte _A7105_Shadow_Update() / _A7105_Shadow_Strobe():
+  Internal functions that check (and update) the shadow register cache 
+  before a register write or mode strobe. They return false if the radio 
+  already has that value/mode and the SPI transfer can be skipped. These 
+  are only exposed for the A7105Radio<> front-end (a7105_radio.h) so it 
+  stays in sync with the cache.
+*/
+byte _A7105_Shadow_Update(struct A7105* radio, byte address, byte data);
+byte _A7105_Shadow_Strobe(struct A7105* radio, enum A7105_State state);
 #endif
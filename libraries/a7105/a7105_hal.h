@@ -0,0 +1,154 @@
+/*
+Copyright (C) 2015 Matthew Meno
+
+This file is part of ATmega A7105.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+(1) Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer. 
+
+(2) Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in
+the documentation and/or other materials provided with the
+distribution.  
+
+(3)The name of the author may not be used to
+endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+  Hardware abstraction layer for the A7105 library.
+
+  Everything the driver needs from the platform (SPI, GPIO, a clock and pin
+  interrupts) goes through the functions below so the same driver and mesh code
+  can run on an Arduino or on a Linux box with the radio on a SPI port.
+
+  Backends:
+    * Arduino (default): SPI library, digitalWrite()/digitalRead(), millis() and 
+      the PinChangeInt library (see a7105_hal_arduino.h/.cpp).
+    * A7105_HAL_LINUX: spidev for SPI and the GPIO character device (/dev/gpiochipN)
+      for chip selects and WTR interrupts (see a7105_hal_linux.cpp). Pin numbers
+      are line offsets on that GPIO chip.
+    * A7105_HAL_EMULATOR: the host-native radio emulator (see emulator/).
+
+  The host backends (define one when compiling) also get the handful of Arduino
+  core functions the libraries use (see a7105_hal_host.h).
+*/
+#ifndef _A7105_HAL_H_
+#define _A7105_HAL_H_
+
+#if defined(A7105_HAL_LINUX) || defined(A7105_HAL_EMULATOR)
+#define A7105_HAL_HOST
+#include "a7105_hal_host.h"
+#else
+#include "a7105_hal_arduino.h"
+#endif
+
+/*
+  A7105_HAL_SPI_Begin:
+    Sets up the SPI bus (safe to call more than once).
+*/
+void A7105_HAL_SPI_Begin();
+
+/*
+  A7105_HAL_SPI_Begin_Transaction/A7105_HAL_SPI_End_Transaction:
+    * clock: SPI clock rate (Hz). The A7105 only speaks MSB first, SPI mode 0.
+
+    Side-Effects/Notes: Bytes are only clocked between these, the chip select is 
+                        handled separately (A7105_HAL_Pin_Write()).
+*/
+void A7105_HAL_SPI_Begin_Transaction(uint32_t clock);
+void A7105_HAL_SPI_End_Transaction();
+
+//Clocks one byte out and returns the byte clocked in
+byte A7105_HAL_SPI_Transfer(byte out);
+
+/*
+  A7105_HAL_SPI_Transfer_Block:
+    * tx_buffer: Bytes to clock out (NULL to send 'fill' for every byte)
+    * fill: Byte to send when tx_buffer is NULL
+    * rx_buffer: Where to put the bytes clocked in (NULL to drop them)
+    * len: Number of bytes
+
+    Side-Effects/Notes: Lets backends with a per-call cost (i.e. an ioctl) move a 
+                        whole FIFO burst at once.
+*/
+void A7105_HAL_SPI_Transfer_Block(const byte* tx_buffer, byte fill, byte* rx_buffer, byte len);
+
+//GPIO (chip selects and WTR pins)
+void A7105_HAL_Pin_Output(int pin);
+void A7105_HAL_Pin_Input(int pin);
+void A7105_HAL_Pin_Write(int pin, byte level);
+byte A7105_HAL_Pin_Read(int pin);
+
+//Monotonic clock
+unsigned long A7105_HAL_Millis();
+unsigned long A7105_HAL_Micros();
+void A7105_HAL_Delay_Us(unsigned long us);
+
+//Called while spinning on flags set by the WTR interrupt (let other threads/the emulator run)
+void A7105_HAL_Yield();
+
+/*
+  A7105_HAL_Attach_Falling:
+    * pin: Pin to watch
+    * callback: Called (in interrupt context or an event thread) when 'pin' falls.
+                A7105_HAL_Interrupt_Pin() returns 'pin' while it runs.
+*/
+void A7105_HAL_Attach_Falling(int pin, void (*callback)());
+void A7105_HAL_Detach(int pin);
+int A7105_HAL_Interrupt_Pin();
+
+/*
+  A7105_HAL_Lock/A7105_HAL_Unlock:
+    Keeps the WTR callback out while the driver updates state it shares with it.
+    Nests, pass the value A7105_HAL_Lock() returned to A7105_HAL_Unlock().
+*/
+byte A7105_HAL_Lock();
+void A7105_HAL_Unlock(byte state);
+
+#ifdef A7105_HAL_LINUX
+//Default devices (see A7105_HAL_Linux_Begin())
+#ifndef A7105_HAL_LINUX_SPIDEV
+#define A7105_HAL_LINUX_SPIDEV "/dev/spidev0.0"
+#endif
+#ifndef A7105_HAL_LINUX_GPIOCHIP
+#define A7105_HAL_LINUX_GPIOCHIP "/dev/gpiochip0"
+#endif
+#define A7105_HAL_LINUX_MAX_LINES 16 //chip select and WTR lines we can hold
+#define A7105_HAL_LINUX_POLL_MS 10 //how long the event thread takes to notice newly attached lines
+#define A7105_HAL_LINUX_SLEEP_MIN_US 200 //shorter delays spin instead of sleeping
+
+/*
+  A7105_HAL_Linux_Begin:
+    * spidev_path: spidev device the radios are on (NULL for A7105_HAL_LINUX_SPIDEV)
+    * gpiochip_path: GPIO chip with the chip select/WTR lines (NULL for A7105_HAL_LINUX_GPIOCHIP)
+
+    Side-Effects/Notes: Call this before A7105_Easy_Setup_Radio()/A7105_Mesh_Initialize() to 
+                        use other devices (otherwise the defaults are opened on first use). 
+                        Pointing these at a mock device is how the backend can be tested 
+                        without a radio.
+
+    Returns:
+      * true if both devices opened (errors are printed to stderr), false otherwise
+*/
+byte A7105_HAL_Linux_Begin(const char* spidev_path, const char* gpiochip_path);
+#endif
+
+#endif
@@ -0,0 +1,110 @@
+/*
+Copyright (C) 2015 Matthew Meno
+
+This file is part of ATmega A7105.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+(1) Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer. 
+
+(2) Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in
+the documentation and/or other materials provided with the
+distribution.  
+
+(3)The name of the author may not be used to
+endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "a7105.h"
+
+#ifndef A7105_HAL_HOST
+#include "PinChangeInt.h"
+
+SPISettings _A7105_HAL_SPI_SETTINGS(A7105_SPI_CLOCK, MSBFIRST, SPI_MODE0);
+uint32_t _A7105_HAL_SPI_SETTINGS_CLOCK = A7105_SPI_CLOCK;
+
+#if defined(A7105_EXTERNAL_WTR_INTERRUPTS) && \
+    (defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328__) || \
+     defined(__AVR_ATmega168__) || defined(__AVR_ATmega168A__) || defined(__AVR_ATmega168P__))
+#define A7105_HAL_EXTERNAL_INTERRUPTS
+#endif
+
+#ifdef A7105_HAL_EXTERNAL_INTERRUPTS
+//Pin 2 is INT0 and pin 3 is INT1
+#define _A7105_HAL_EXT_FIRST_PIN 2
+
+void (*_A7105_HAL_EXT_CALLBACKS[2])();
+volatile int8_t _A7105_HAL_EXT_PIN = -1; //Pin of the INT0/INT1 callback that's running, -1 otherwise
+
+//Straight from the vector to the callback (no port scan or pin list to walk like PinChangeInt)
+ISR(INT0_vect)
+{
+  _A7105_HAL_EXT_PIN = _A7105_HAL_EXT_FIRST_PIN;
+  _A7105_HAL_EXT_CALLBACKS[0]();
+  _A7105_HAL_EXT_PIN = -1;
+}
+
+ISR(INT1_vect)
+{
+  _A7105_HAL_EXT_PIN = _A7105_HAL_EXT_FIRST_PIN + 1;
+  _A7105_HAL_EXT_CALLBACKS[1]();
+  _A7105_HAL_EXT_PIN = -1;
+}
+#endif
+
+void A7105_HAL_Attach_Falling(int pin, void (*callback)())
+{
+#ifdef A7105_HAL_EXTERNAL_INTERRUPTS
+  if (pin == _A7105_HAL_EXT_FIRST_PIN || pin == _A7105_HAL_EXT_FIRST_PIN + 1)
+  {
+    byte n = pin - _A7105_HAL_EXT_FIRST_PIN;
+    byte state = A7105_HAL_Lock();
+    _A7105_HAL_EXT_CALLBACKS[n] = callback;
+    EICRA = (EICRA & ~(0x03 << (2*n))) | (0x02 << (2*n)); //ISCn1:0 = 10, falling edge
+    EIFR = _BV(n); //forget any edge from before we were watching
+    EIMSK |= _BV(n);
+    A7105_HAL_Unlock(state);
+    return;
+  }
+#endif
+  attachPinChangeInterrupt(pin, callback, FALLING);
+}
+
+void A7105_HAL_Detach(int pin)
+{
+#ifdef A7105_HAL_EXTERNAL_INTERRUPTS
+  if (pin == _A7105_HAL_EXT_FIRST_PIN || pin == _A7105_HAL_EXT_FIRST_PIN + 1)
+  {
+    EIMSK &= ~_BV(pin - _A7105_HAL_EXT_FIRST_PIN);
+    return;
+  }
+#endif
+  detachPinChangeInterrupt(pin);
+}
+
+int A7105_HAL_Interrupt_Pin()
+{
+#ifdef A7105_HAL_EXTERNAL_INTERRUPTS
+  if (_A7105_HAL_EXT_PIN >= 0)
+    return _A7105_HAL_EXT_PIN;
+#endif
+  return PCintPort::arduinoPin;
+}
+#endif
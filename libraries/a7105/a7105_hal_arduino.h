@@ -0,0 +1,157 @@
+/*
+Copyright (C) 2015 Matthew Meno
+
+This file is part of ATmega A7105.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+(1) Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer. 
+
+(2) Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in
+the documentation and/or other materials provided with the
+distribution.  
+
+(3)The name of the author may not be used to
+endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+  Arduino backend for the A7105 HAL (see a7105_hal.h). The calls on the SPI
+  hot path are inline wrappers around the Arduino core/SPI library so the HAL 
+  costs nothing over calling them directly. The pin interrupt hookup lives in
+  a7105_hal_arduino.cpp (the PinChangeInt library can only be included once).
+*/
+#ifndef _A7105_HAL_ARDUINO_H_
+#define _A7105_HAL_ARDUINO_H_
+
+#include <Arduino.h>
+#include <SPI.h>
+
+inline void A7105_HAL_SPI_Begin()
+{
+  SPI.begin();
+}
+
+//Settings for the last clock asked for (defined in a7105_hal_arduino.cpp). The clock 
+//is per radio so the compiler can't fold SPISettings() down to constants any more.
+extern SPISettings _A7105_HAL_SPI_SETTINGS;
+extern uint32_t _A7105_HAL_SPI_SETTINGS_CLOCK;
+
+inline void A7105_HAL_SPI_Begin_Transaction(uint32_t clock)
+{
+  //Only work out the clock divider when the clock changes (i.e. between radios)
+  if (clock != _A7105_HAL_SPI_SETTINGS_CLOCK)
+  {
+    _A7105_HAL_SPI_SETTINGS = SPISettings(clock, MSBFIRST, SPI_MODE0);
+    _A7105_HAL_SPI_SETTINGS_CLOCK = clock;
+  }
+  SPI.beginTransaction(_A7105_HAL_SPI_SETTINGS);  // gain control of SPI bus
+}
+
+inline void A7105_HAL_SPI_End_Transaction()
+{
+  SPI.endTransaction();          // release the SPI bus
+}
+
+inline byte A7105_HAL_SPI_Transfer(byte out)
+{
+  return SPI.transfer(out);
+}
+
+inline void A7105_HAL_SPI_Transfer_Block(const byte* tx_buffer, byte fill, byte* rx_buffer, byte len)
+{
+  for (byte i = 0; i < len; i++)
+  {
+    byte in = SPI.transfer(tx_buffer ? tx_buffer[i] : fill);
+    if (rx_buffer)
+      rx_buffer[i] = in;
+  }
+}
+
+inline void A7105_HAL_Pin_Output(int pin)
+{
+  pinMode(pin, OUTPUT);
+}
+
+inline void A7105_HAL_Pin_Input(int pin)
+{
+  pinMode(pin, INPUT);
+}
+
+inline void A7105_HAL_Pin_Write(int pin, byte level)
+{
+  digitalWrite(pin, level);
+}
+
+inline byte A7105_HAL_Pin_Read(int pin)
+{
+  return digitalRead(pin);
+}
+
+inline unsigned long A7105_HAL_Millis()
+{
+  return millis();
+}
+
+inline unsigned long A7105_HAL_Micros()
+{
+  return micros();
+}
+
+inline void A7105_HAL_Delay_Us(unsigned long us)
+{
+  //delayMicroseconds() only takes 16 bits on AVRs (and is only accurate to ~16ms)
+  while (us > 16000)
+  {
+    delayMicroseconds(16000);
+    us -= 16000;
+  }
+  delayMicroseconds((unsigned int)us);
+}
+
+inline void A7105_HAL_Yield()
+{
+  yield();
+}
+
+inline byte A7105_HAL_Lock()
+{
+#ifdef __AVR__
+  byte state = SREG;
+  cli();
+  return state;
+#else
+  //NOTE: No way to read the interrupt state portably, so locks don't nest here
+  noInterrupts();
+  return 0;
+#endif
+}
+
+inline void A7105_HAL_Unlock(byte state)
+{
+#ifdef __AVR__
+  SREG = state;
+#else
+  (void)state;
+  interrupts();
+#endif
+}
+
+#endif
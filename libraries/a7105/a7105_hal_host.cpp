@@ -0,0 +1,147 @@
+/*
+Copyright (C) 2015 Matthew Meno
+
+This file is part of ATmega A7105.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+(1) Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer. 
+
+(2) Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in
+the documentation and/or other materials provided with the
+distribution.  
+
+(3)The name of the author may not be used to
+endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "a7105_hal.h"
+
+#ifdef A7105_HAL_HOST
+#include <stdio.h>
+
+HardwareSerial Serial;
+
+//xorshift state for random() (the same sequence on every host so seeded runs repeat)
+static uint32_t _A7105_HAL_RANDOM = 1;
+
+long random(long howbig)
+{
+  if (howbig <= 0)
+    return 0;
+
+  uint32_t x = _A7105_HAL_RANDOM;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  _A7105_HAL_RANDOM = x;
+  return (long)(x % (uint32_t)howbig);
+}
+
+long random(long howsmall, long howbig)
+{
+  if (howsmall >= howbig)
+    return howsmall;
+  return random(howbig - howsmall) + howsmall;
+}
+
+void randomSeed(unsigned long seed)
+{
+  if (seed != 0)
+    _A7105_HAL_RANDOM = (uint32_t)seed;
+}
+
+int analogRead(uint8_t pin)
+{
+  (void)pin;
+  return A7105_HAL_Noise() & 0x3FF;
+}
+
+void HardwareSerial::flush()
+{
+  if (_enabled)
+    fflush(stdout);
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+  if (_enabled)
+    putchar(c);
+  return 1;
+}
+
+size_t HardwareSerial::write(const char* str)
+{
+  size_t n = 0;
+  while (str[n])
+    write((uint8_t)str[n++]);
+  return n;
+}
+
+size_t HardwareSerial::print_number(unsigned long n, int base)
+{
+  char buffer[8 * sizeof(unsigned long) + 1];
+  char* str = &buffer[sizeof(buffer) - 1];
+  *str = '\0';
+  if (base < 2)
+    base = 10;
+
+  do
+  {
+    unsigned long digit = n % base;
+    n /= base;
+    *--str = (char)(digit < 10 ? digit + '0' : digit + 'A' - 10);
+  } while (n);
+
+  return write(str);
+}
+
+size_t HardwareSerial::print(const char* str) { return write(str); }
+size_t HardwareSerial::print(char c) { return write((uint8_t)c); }
+size_t HardwareSerial::print(unsigned char n, int base) { return print_number(n, base); }
+size_t HardwareSerial::print(int n, int base) { return print((long)n, base); }
+size_t HardwareSerial::print(unsigned int n, int base) { return print_number(n, base); }
+size_t HardwareSerial::print(unsigned long n, int base) { return print_number(n, base); }
+
+size_t HardwareSerial::print(long n, int base)
+{
+  //Like the Arduino core, only base 10 gets a sign
+  if (base == DEC && n < 0)
+    return write('-') + print_number((unsigned long)(-n), DEC);
+  return print_number((unsigned long)n, base);
+}
+
+size_t HardwareSerial::print(double n, int digits)
+{
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%.*f", digits, n);
+  return write(buffer);
+}
+
+size_t HardwareSerial::println() { return write("\r\n"); }
+size_t HardwareSerial::println(const char* str) { return print(str) + println(); }
+size_t HardwareSerial::println(char c) { return print(c) + println(); }
+size_t HardwareSerial::println(unsigned char n, int base) { return print(n, base) + println(); }
+size_t HardwareSerial::println(int n, int base) { return print(n, base) + println(); }
+size_t HardwareSerial::println(unsigned int n, int base) { return print(n, base) + println(); }
+size_t HardwareSerial::println(long n, int base) { return print(n, base) + println(); }
+size_t HardwareSerial::println(unsigned long n, int base) { return print(n, base) + println(); }
+size_t HardwareSerial::println(double n, int digits) { return print(n, digits) + println(); }
+#endif
@@ -0,0 +1,148 @@
+/*
+Copyright (C) 2015 Matthew Meno
+
+This file is part of ATmega A7105.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+(1) Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer. 
+
+(2) Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in
+the documentation and/or other materials provided with the
+distribution.  
+
+(3)The name of the author may not be used to
+endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+  The parts of the Arduino core the a7105/a7105_mesh libraries (and programs
+  built on them) use, for the host HAL backends (A7105_HAL_LINUX and 
+  A7105_HAL_EMULATOR). Timing goes through the HAL clock; random(), analogRead()
+  and Serial are in a7105_hal_host.cpp.
+*/
+#ifndef _A7105_HAL_HOST_H_
+#define _A7105_HAL_HOST_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+//Analog pins (only used for the random seed, see analogRead())
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+
+//No separate program memory on the host
+#define PROGMEM
+#define PGM_P const char*
+#define PSTR(s) (s)
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) _A7105_HAL_Read_Word(addr)
+#define strncpy_P strncpy
+#define strcmp_P strcmp
+#define strlen_P strlen
+
+//Pointer tables in PROGMEM hold full (host sized) pointers
+static inline uintptr_t _A7105_HAL_Read_Word(const void* addr)
+{
+  uintptr_t word;
+  memcpy(&word, addr, sizeof(word));
+  return word;
+}
+
+unsigned long A7105_HAL_Millis();
+unsigned long A7105_HAL_Micros();
+void A7105_HAL_Delay_Us(unsigned long us);
+
+inline unsigned long millis() { return A7105_HAL_Millis(); }
+inline unsigned long micros() { return A7105_HAL_Micros(); }
+inline void delay(unsigned long ms) { A7105_HAL_Delay_Us(ms * 1000UL); }
+inline void delayMicroseconds(unsigned int us) { A7105_HAL_Delay_Us(us); }
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+//Returns noise from the backend (A7105_HAL_Noise()), the libraries only use it for random seeds
+int analogRead(uint8_t pin);
+int A7105_HAL_Noise();
+
+//Serial goes to stdout
+class HardwareSerial
+{
+  public:
+    void begin(unsigned long baud) { (void)baud; }
+    void end() {}
+    int available() { return 0; }
+    int read() { return -1; }
+    int peek() { return -1; }
+    void flush();
+
+    size_t write(uint8_t c);
+    size_t write(const char* str);
+
+    size_t print(const char* str);
+    size_t print(char c);
+    size_t print(unsigned char n, int base = DEC);
+    size_t print(int n, int base = DEC);
+    size_t print(unsigned int n, int base = DEC);
+    size_t print(long n, int base = DEC);
+    size_t print(unsigned long n, int base = DEC);
+    size_t print(double n, int digits = 2);
+
+    size_t println();
+    size_t println(const char* str);
+    size_t println(char c);
+    size_t println(unsigned char n, int base = DEC);
+    size_t println(int n, int base = DEC);
+    size_t println(unsigned int n, int base = DEC);
+    size_t println(long n, int base = DEC);
+    size_t println(unsigned long n, int base = DEC);
+    size_t println(double n, int digits = 2);
+
+    //Turns the output on/off (i.e. to keep debug output out of benchmark results)
+    void set_output(byte enabled) { _enabled = enabled; }
+
+    HardwareSerial() : _enabled(true) {}
+
+  private:
+    size_t print_number(unsigned long n, int base);
+    byte _enabled;
+};
+
+extern HardwareSerial Serial;
+
+#endif
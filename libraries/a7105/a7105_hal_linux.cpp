@@ -0,0 +1,462 @@
+/*
+Copyright (C) 2015 Matthew Meno
+
+This file is part of ATmega A7105.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+(1) Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer. 
+
+(2) Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in
+the documentation and/or other materials provided with the
+distribution.  
+
+(3)The name of the author may not be used to
+endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "a7105_hal.h"
+
+#ifdef A7105_HAL_LINUX
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+#include <linux/spi/spidev.h>
+
+/*
+  Linux userspace backend. SPI goes through spidev with the controller's own
+  chip select turned off (SPI_NO_CS), the driver drives its chip selects as
+  GPIO lines like it does on an Arduino. WTR edges are read from GPIO line
+  event file descriptors by a thread that calls the attached callback with 
+  the HAL lock held (that's the "interrupt").
+*/
+
+//Line types for _A7105_HAL_Request_Line() (besides INPUT and OUTPUT)
+#define _A7105_HAL_LINE_EVENT 2
+
+struct _A7105_HAL_Line
+{
+  int pin; //line offset on the GPIO chip (-1 if the slot is free)
+  int fd; //line handle (outputs/inputs) or line event fd (interrupts)
+  byte is_event;
+  void (*callback)();
+};
+
+static int _A7105_HAL_SPI_FD = -1;
+static int _A7105_HAL_GPIO_FD = -1;
+static const char* _A7105_HAL_SPI_PATH = A7105_HAL_LINUX_SPIDEV;
+static const char* _A7105_HAL_GPIO_PATH = A7105_HAL_LINUX_GPIOCHIP;
+static uint32_t _A7105_HAL_SPI_CLOCK = 0;
+
+static struct _A7105_HAL_Line _A7105_HAL_LINES[A7105_HAL_LINUX_MAX_LINES];
+static byte _A7105_HAL_LINES_INIT = false;
+
+static pthread_mutex_t _A7105_HAL_MUTEX;
+static pthread_t _A7105_HAL_THREAD;
+static byte _A7105_HAL_THREAD_RUNNING = false;
+static int _A7105_HAL_INTERRUPT_PIN = -1;
+
+static struct timespec _A7105_HAL_EPOCH;
+static byte _A7105_HAL_EPOCH_SET = false;
+
+static void _A7105_HAL_Fail(const char* what, const char* path)
+{
+  fprintf(stderr, "a7105_hal_linux: %s %s: %s\n", what, path ? path : "", strerror(errno));
+}
+
+static void _A7105_HAL_Init_Lines()
+{
+  if (_A7105_HAL_LINES_INIT)
+    return;
+
+  //Recursive so A7105_HAL_Lock() nests like the AVR version
+  pthread_mutexattr_t attr;
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+  pthread_mutex_init(&_A7105_HAL_MUTEX, &attr);
+  pthread_mutexattr_destroy(&attr);
+
+  for (int x = 0; x < A7105_HAL_LINUX_MAX_LINES; x++)
+  {
+    _A7105_HAL_LINES[x].pin = -1;
+    _A7105_HAL_LINES[x].fd = -1;
+  }
+  _A7105_HAL_LINES_INIT = true;
+}
+
+byte A7105_HAL_Linux_Begin(const char* spidev_path, const char* gpiochip_path)
+{
+  _A7105_HAL_Init_Lines();
+  if (spidev_path != NULL)
+    _A7105_HAL_SPI_PATH = spidev_path;
+  if (gpiochip_path != NULL)
+    _A7105_HAL_GPIO_PATH = gpiochip_path;
+
+  if (_A7105_HAL_SPI_FD < 0)
+  {
+    _A7105_HAL_SPI_FD = open(_A7105_HAL_SPI_PATH, O_RDWR);
+    if (_A7105_HAL_SPI_FD < 0)
+    {
+      _A7105_HAL_Fail("can't open", _A7105_HAL_SPI_PATH);
+      return false;
+    }
+
+    uint32_t mode = SPI_MODE_0 | SPI_NO_CS;
+    uint8_t bits = 8;
+    if (ioctl(_A7105_HAL_SPI_FD, SPI_IOC_WR_MODE32, &mode) < 0 ||
+        ioctl(_A7105_HAL_SPI_FD, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0)
+    {
+      _A7105_HAL_Fail("can't set up", _A7105_HAL_SPI_PATH);
+      return false;
+    }
+  }
+
+  if (_A7105_HAL_GPIO_FD < 0)
+  {
+    _A7105_HAL_GPIO_FD = open(_A7105_HAL_GPIO_PATH, O_RDWR);
+    if (_A7105_HAL_GPIO_FD < 0)
+    {
+      _A7105_HAL_Fail("can't open", _A7105_HAL_GPIO_PATH);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static struct _A7105_HAL_Line* _A7105_HAL_Find_Line(int pin)
+{
+  for (int x = 0; x < A7105_HAL_LINUX_MAX_LINES; x++)
+    if (_A7105_HAL_LINES[x].pin == pin)
+      return &(_A7105_HAL_LINES[x]);
+  return NULL;
+}
+
+/*
+  Internal use only, (re-)requests 'pin' from the GPIO chip as an output, an
+  input or a falling edge event source. Returns the line (or NULL on failure).
+*/
+static struct _A7105_HAL_Line* _A7105_HAL_Request_Line(int pin, int type)
+{
+  A7105_HAL_Linux_Begin(NULL, NULL);
+  if (_A7105_HAL_GPIO_FD < 0)
+    return NULL;
+
+  struct _A7105_HAL_Line* line = _A7105_HAL_Find_Line(pin);
+  if (line == NULL)
+    line = _A7105_HAL_Find_Line(-1);
+  if (line == NULL)
+  {
+    fprintf(stderr, "a7105_hal_linux: more than %d GPIO lines\n", A7105_HAL_LINUX_MAX_LINES);
+    return NULL;
+  }
+
+  if (line->fd >= 0)
+    close(line->fd);
+  line->pin = pin;
+  line->fd = -1;
+  line->is_event = (type == _A7105_HAL_LINE_EVENT);
+
+  if (line->is_event)
+  {
+    struct gpioevent_request req;
+    memset(&req, 0, sizeof(req));
+    req.lineoffset = pin;
+    req.handleflags = GPIOHANDLE_REQUEST_INPUT;
+    req.eventflags = GPIOEVENT_REQUEST_FALLING_EDGE;
+    strncpy(req.consumer_label, "a7105 wtr", sizeof(req.consumer_label) - 1);
+    if (ioctl(_A7105_HAL_GPIO_FD, GPIO_GET_LINEEVENT_IOCTL, &req) < 0)
+    {
+      _A7105_HAL_Fail("can't watch line on", _A7105_HAL_GPIO_PATH);
+      line->pin = -1;
+      return NULL;
+    }
+    line->fd = req.fd;
+  }
+  else
+  {
+    struct gpiohandle_request req;
+    memset(&req, 0, sizeof(req));
+    req.lineoffsets[0] = pin;
+    req.lines = 1;
+    req.flags = (type == OUTPUT) ? GPIOHANDLE_REQUEST_OUTPUT : GPIOHANDLE_REQUEST_INPUT;
+    req.default_values[0] = HIGH; //chip selects idle high
+    strncpy(req.consumer_label, "a7105", sizeof(req.consumer_label) - 1);
+    if (ioctl(_A7105_HAL_GPIO_FD, GPIO_GET_LINEHANDLE_IOCTL, &req) < 0)
+    {
+      _A7105_HAL_Fail("can't request line on", _A7105_HAL_GPIO_PATH);
+      line->pin = -1;
+      return NULL;
+    }
+    line->fd = req.fd;
+  }
+
+  return line;
+}
+
+//Event thread, stands in for the pin change interrupt
+static void* _A7105_HAL_Event_Thread(void* arg)
+{
+  (void)arg;
+  while (true)
+  {
+    struct pollfd fds[A7105_HAL_LINUX_MAX_LINES];
+    int pins[A7105_HAL_LINUX_MAX_LINES];
+    int count = 0;
+
+    pthread_mutex_lock(&_A7105_HAL_MUTEX);
+    for (int x = 0; x < A7105_HAL_LINUX_MAX_LINES; x++)
+    {
+      if (_A7105_HAL_LINES[x].is_event && _A7105_HAL_LINES[x].fd >= 0)
+      {
+        fds[count].fd = _A7105_HAL_LINES[x].fd;
+        fds[count].events = POLLIN;
+        pins[count] = _A7105_HAL_LINES[x].pin;
+        count++;
+      }
+    }
+    pthread_mutex_unlock(&_A7105_HAL_MUTEX);
+
+    //Short timeout so lines attached later get picked up
+    if (poll(fds, count, A7105_HAL_LINUX_POLL_MS) <= 0)
+      continue;
+
+    for (int x = 0; x < count; x++)
+    {
+      if (!(fds[x].revents & POLLIN))
+        continue;
+
+      struct gpioevent_data event;
+      if (read(fds[x].fd, &event, sizeof(event)) != (ssize_t)sizeof(event))
+        continue;
+
+      pthread_mutex_lock(&_A7105_HAL_MUTEX);
+      struct _A7105_HAL_Line* line = _A7105_HAL_Find_Line(pins[x]);
+      if (line != NULL && line->callback != NULL)
+      {
+        _A7105_HAL_INTERRUPT_PIN = pins[x];
+        line->callback();
+        _A7105_HAL_INTERRUPT_PIN = -1;
+      }
+      pthread_mutex_unlock(&_A7105_HAL_MUTEX);
+    }
+  }
+  return NULL;
+}
+
+void A7105_HAL_SPI_Begin()
+{
+  A7105_HAL_Linux_Begin(NULL, NULL);
+}
+
+void A7105_HAL_SPI_Begin_Transaction(uint32_t clock)
+{
+  _A7105_HAL_SPI_CLOCK = clock;
+}
+
+void A7105_HAL_SPI_End_Transaction()
+{
+}
+
+void A7105_HAL_SPI_Transfer_Block(const byte* tx_buffer, byte fill, byte* rx_buffer, byte len)
+{
+  if (len == 0 || _A7105_HAL_SPI_FD < 0)
+    return;
+
+  byte tx[256];
+  if (tx_buffer == NULL)
+  {
+    memset(tx, fill, len);
+    tx_buffer = tx;
+  }
+
+  struct spi_ioc_transfer transfer;
+  memset(&transfer, 0, sizeof(transfer));
+  transfer.tx_buf = (uintptr_t)tx_buffer;
+  transfer.rx_buf = (uintptr_t)rx_buffer;
+  transfer.len = len;
+  transfer.speed_hz = _A7105_HAL_SPI_CLOCK;
+  transfer.bits_per_word = 8;
+  if (ioctl(_A7105_HAL_SPI_FD, SPI_IOC_MESSAGE(1), &transfer) < 0)
+    _A7105_HAL_Fail("transfer failed on", _A7105_HAL_SPI_PATH);
+}
+
+byte A7105_HAL_SPI_Transfer(byte out)
+{
+  byte in = 0xFF;
+  A7105_HAL_SPI_Transfer_Block(&out, out, &in, 1);
+  return in;
+}
+
+void A7105_HAL_Pin_Output(int pin)
+{
+  _A7105_HAL_Init_Lines();
+  struct _A7105_HAL_Line* line = _A7105_HAL_Find_Line(pin);
+  if (line == NULL || line->is_event)
+    _A7105_HAL_Request_Line(pin, OUTPUT);
+}
+
+void A7105_HAL_Pin_Input(int pin)
+{
+  //Interrupt lines can be read already
+  _A7105_HAL_Init_Lines();
+  if (_A7105_HAL_Find_Line(pin) == NULL)
+    _A7105_HAL_Request_Line(pin, INPUT);
+}
+
+void A7105_HAL_Pin_Write(int pin, byte level)
+{
+  struct _A7105_HAL_Line* line = _A7105_HAL_Find_Line(pin);
+  if (line == NULL || line->fd < 0)
+    return;
+
+  struct gpiohandle_data data;
+  memset(&data, 0, sizeof(data));
+  data.values[0] = level;
+  ioctl(line->fd, GPIOHANDLE_SET_LINE_VALUES_IOCTL, &data);
+}
+
+byte A7105_HAL_Pin_Read(int pin)
+{
+  struct _A7105_HAL_Line* line = _A7105_HAL_Find_Line(pin);
+  if (line == NULL || line->fd < 0)
+    return LOW;
+
+  //Works on line event fds too
+  struct gpiohandle_data data;
+  memset(&data, 0, sizeof(data));
+  if (ioctl(line->fd, GPIOHANDLE_GET_LINE_VALUES_IOCTL, &data) < 0)
+    return LOW;
+  return data.values[0] ? HIGH : LOW;
+}
+
+static uint64_t _A7105_HAL_Now_Us()
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  if (!_A7105_HAL_EPOCH_SET)
+  {
+    _A7105_HAL_EPOCH = now;
+    _A7105_HAL_EPOCH_SET = true;
+  }
+  return (uint64_t)(now.tv_sec - _A7105_HAL_EPOCH.tv_sec) * 1000000ULL +
+         (now.tv_nsec - _A7105_HAL_EPOCH.tv_nsec) / 1000;
+}
+
+unsigned long A7105_HAL_Millis()
+{
+  return (unsigned long)(_A7105_HAL_Now_Us() / 1000ULL);
+}
+
+unsigned long A7105_HAL_Micros()
+{
+  return (unsigned long)_A7105_HAL_Now_Us();
+}
+
+void A7105_HAL_Delay_Us(unsigned long us)
+{
+  //Sleeping is only worth it past the scheduler's granularity, spin for short waits
+  if (us >= A7105_HAL_LINUX_SLEEP_MIN_US)
+  {
+    struct timespec delay;
+    delay.tv_sec = us / 1000000UL;
+    delay.tv_nsec = (us % 1000000UL) * 1000L;
+    while (nanosleep(&delay, &delay) < 0 && errno == EINTR) {}
+    return;
+  }
+
+  uint64_t start = _A7105_HAL_Now_Us();
+  while (_A7105_HAL_Now_Us() - start < us) {}
+}
+
+void A7105_HAL_Yield()
+{
+  sched_yield();
+}
+
+void A7105_HAL_Attach_Falling(int pin, void (*callback)())
+{
+  _A7105_HAL_Init_Lines();
+  pthread_mutex_lock(&_A7105_HAL_MUTEX);
+
+  struct _A7105_HAL_Line* line = _A7105_HAL_Find_Line(pin);
+  if (line == NULL || !line->is_event)
+    line = _A7105_HAL_Request_Line(pin, _A7105_HAL_LINE_EVENT);
+  if (line != NULL)
+    line->callback = callback;
+
+  if (!_A7105_HAL_THREAD_RUNNING &&
+      pthread_create(&_A7105_HAL_THREAD, NULL, _A7105_HAL_Event_Thread, NULL) == 0)
+    _A7105_HAL_THREAD_RUNNING = true;
+
+  pthread_mutex_unlock(&_A7105_HAL_MUTEX);
+}
+
+void A7105_HAL_Detach(int pin)
+{
+  //Keep the line (and drain its events) so re-attaching doesn't lose edges to a re-request
+  _A7105_HAL_Init_Lines();
+  pthread_mutex_lock(&_A7105_HAL_MUTEX);
+  struct _A7105_HAL_Line* line = _A7105_HAL_Find_Line(pin);
+  if (line != NULL)
+    line->callback = NULL;
+  pthread_mutex_unlock(&_A7105_HAL_MUTEX);
+}
+
+int A7105_HAL_Interrupt_Pin()
+{
+  return _A7105_HAL_INTERRUPT_PIN;
+}
+
+byte A7105_HAL_Lock()
+{
+  _A7105_HAL_Init_Lines();
+  pthread_mutex_lock(&_A7105_HAL_MUTEX);
+  return 0;
+}
+
+void A7105_HAL_Unlock(byte state)
+{
+  (void)state;
+  pthread_mutex_unlock(&_A7105_HAL_MUTEX);
+}
+
+int A7105_HAL_Noise()
+{
+  uint16_t noise = 0;
+  int fd = open("/dev/urandom", O_RDONLY);
+  if (fd >= 0)
+  {
+    if (read(fd, &noise, sizeof(noise)) != (ssize_t)sizeof(noise))
+      noise = (uint16_t)_A7105_HAL_Now_Us();
+    close(fd);
+  }
+  else
+    noise = (uint16_t)_A7105_HAL_Now_Us();
+  return noise;
+}
+#endif
@@ -0,0 +1,210 @@
+/*Copyright (C) 2015 Matthew Meno
+
+This file is part of ATmega A7105.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+(1) Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer. 
+
+(2) Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in
+the documentation and/or other materials provided with the
+distribution.  
+
+(3)The name of the author may not be used to
+endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+  A7105Radio<CS_PIN, WTR_PIN>: Compile-time pin specialized front-end for the A7105 library
+
+  The plain A7105_* functions take the chip-select pin at runtime, so the best
+  they can do is look the port register/bit up once (A7105_Initialize) and poke
+  it through a pointer. When the pins are known at compile time, this template
+  folds the pin down to a constant port address and bit mask so every
+  chip-select toggle is a single sbi/cbi instruction.
+
+  The hot register paths (WriteReg, ReadReg, Strobe) are implemented inline here.
+  Everything else forwards to the A7105_* functions on the same struct A7105,
+  so both APIs can be mixed freely (they share the shadow register cache and 
+  the SPI transfer queue). Pass 'radio.radio' to anything that wants a struct A7105*.
+
+  Usage:
+    A7105Radio<7,2> radio;
+    radio.Easy_Setup_Radio(0x5475C52A, A7105_DATA_RATE_250Kbps, 0x14, A7105_TXPOWER_150mW, 1, 0);
+    radio.WriteReg(A7105_1D_RSSI_THOLD, 0x40);
+
+  Software Notes:
+    The arduino toolchain builds sketches as C++98, so the pin mapping below uses
+    template constants and lets the optimizer fold them instead of constexpr.
+
+    The direct port mapping only covers the ATmega168/328 family (Arduino pins
+    0-7 = PORTD, 8-13 = PORTB, 14-19 = PORTC). On anything else the chip-select
+    falls back to the HAL (still correct, just slower).
+*/
+
+#ifndef _A7105_RADIO_H_
+#define _A7105_RADIO_H_
+
+#include "a7105.h"
+
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328__) || \
+    defined(__AVR_ATmega168__) || defined(__AVR_ATmega168A__) || defined(__AVR_ATmega168P__)
+#define A7105_DIRECT_PIN_MAP
+#endif
+
+/*
+  Internal use only, maps an Arduino pin number to its output port and bit
+  at compile time.
+*/
+template <uint8_t PIN>
+struct _A7105_Pin
+{
+#ifdef A7105_DIRECT_PIN_MAP
+  //Fails to compile (negative array size) if PIN isn't a digital pin on this chip
+  typedef char _PIN_IN_RANGE[(PIN < 20) ? 1 : -1];
+
+  enum { MASK = 1 << ((PIN < 8) ? PIN : ((PIN < 14) ? (PIN - 8) : (PIN - 14))) };
+
+  static inline volatile uint8_t& Port()
+  {
+    return (PIN < 8) ? PORTD : ((PIN < 14) ? PORTB : PORTC);
+  }
+
+  //NOTE: Constant I/O addresses compile to sbi/cbi which are atomic, so no interrupt guard
+  static inline void Low() { Port() &= (uint8_t)~MASK; }
+  static inline void High() { Port() |= (uint8_t)MASK; }
+#else
+  static inline void Low() { A7105_HAL_Pin_Write(PIN,LOW); }
+  static inline void High() { A7105_HAL_Pin_Write(PIN,HIGH); }
+#endif
+};
+
+template <uint8_t CS_PIN, int8_t WTR_PIN = -1>
+class A7105Radio
+{
+public:
+  struct A7105 radio; //Shared library state (same as the A7105_* functions use)
+
+  //See A7105_Easy_Setup_Radio()
+  A7105_Status_Code Easy_Setup_Radio(uint32_t radio_id,
+                                     A7105_DataRate data_rate,
+                                     byte channel,
+                                     A7105_TxPower power,
+                                     int use_CRC,
+                                     int use_FEC)
+  {
+    return A7105_Easy_Setup_Radio(&radio, CS_PIN, WTR_PIN, radio_id, data_rate, channel, power, use_CRC, use_FEC);
+  }
+  A7105_Status_Code Easy_Setup_Radio(uint32_t radio_id,
+                                     A7105_DataRate data_rate,
+                                     byte channel,
+                                     A7105_TxPower power,
+                                     int use_CRC,
+                                     int use_FEC,
+                                     int cal_eeprom_addr)
+  {
+    return A7105_Easy_Setup_Radio(&radio, CS_PIN, WTR_PIN, radio_id, data_rate, channel, power, use_CRC, use_FEC, cal_eeprom_addr);
+  }
+
+  //See A7105_Initialize()
+  void Initialize(int reset = 1) { A7105_Initialize(&radio, CS_PIN, reset); }
+
+  //See A7105_WriteReg()
+  inline void WriteReg(byte addr, byte value)
+  {
+    //Skip the write if the radio already has this value
+    if (!_A7105_Shadow_Update(&radio, addr, value))
+      return;
+
+    //Let any queued transfers finish first so we don't stomp on the bus
+    A7105_SPI_Wait();
+
+    _A7105_SPI_Claim();
+    _A7105_Pin<CS_PIN>::Low();
+    A7105_HAL_SPI_Begin_Transaction(radio._SPI_CLOCK);
+    A7105_HAL_SPI_Transfer(addr);
+    A7105_HAL_SPI_Transfer(value);
+    A7105_HAL_SPI_End_Transaction();
+    _A7105_Pin<CS_PIN>::High();
+    _A7105_SPI_Release();
+  }
+
+  void WriteReg(byte addr, uint32_t value) { A7105_WriteReg(&radio, addr, value); }
+
+  //See A7105_ReadReg()
+  inline byte ReadReg(byte addr)
+  {
+    A7105_SPI_Wait();
+
+    _A7105_SPI_Claim();
+    _A7105_Pin<CS_PIN>::Low();
+    A7105_HAL_SPI_Begin_Transaction(radio._SPI_CLOCK);
+    A7105_HAL_SPI_Transfer(addr | 0x40);
+    byte read_byte = A7105_HAL_SPI_Transfer(0x00);
+    A7105_HAL_SPI_End_Transaction();
+    _A7105_Pin<CS_PIN>::High();
+    _A7105_SPI_Release();
+    return read_byte;
+  }
+
+  //See A7105_Strobe()
+  inline void Strobe(enum A7105_State state)
+  {
+    //Skip the strobe if we're already in this (idle type) mode
+    if (!_A7105_Shadow_Strobe(&radio, state))
+      return;
+
+    A7105_SPI_Wait();
+
+    _A7105_SPI_Claim();
+    _A7105_Pin<CS_PIN>::Low();
+    A7105_HAL_SPI_Begin_Transaction(radio._SPI_CLOCK);
+    A7105_HAL_SPI_Transfer(state);
+    A7105_HAL_SPI_End_Transaction();
+    _A7105_Pin<CS_PIN>::High();
+    _A7105_SPI_Release();
+  }
+
+  //Everything below just forwards to the A7105_* function of the same name
+  A7105_Status_Code WriteData(byte* buffer, byte len) { return A7105_WriteData(&radio, buffer, len); }
+  A7105_Status_Code ReadData(byte* buffer, byte len) { return A7105_ReadData(&radio, buffer, len); }
+  A7105_Status_Code ReadData(byte* buffer, byte len, struct A7105_RX_Metadata* metadata) { return A7105_ReadData(&radio, buffer, len, metadata); }
+  A7105_Status_Code CheckTXFinished() { return A7105_CheckTXFinished(&radio); }
+  A7105_Status_Code CheckRXWaiting() { return A7105_CheckRXWaiting(&radio); }
+  A7105_Status_Code Easy_Listen_For_Packets(byte length) { return A7105_Easy_Listen_For_Packets(&radio, length); }
+  void ReadBurst(byte addr, byte* buffer, byte len) { A7105_ReadBurst(&radio, addr, buffer, len); }
+  void WriteBurst(byte addr, byte* buffer, byte len) { A7105_WriteBurst(&radio, addr, buffer, len); }
+  void ReadRegBlock(byte start_addr, byte* buffer, byte len) { A7105_ReadRegBlock(&radio, start_addr, buffer, len); }
+  void WriteRegBlock(byte start_addr, byte* buffer, byte len) { A7105_WriteRegBlock(&radio, start_addr, buffer, len); }
+  A7105_Status_Code SetFIFOSegment(byte start, byte len) { return A7105_SetFIFOSegment(&radio, start, len); }
+  A7105_Status_Code WriteData_Extended(byte* buffer, uint16_t len) { return A7105_WriteData_Extended(&radio, buffer, len); }
+  A7105_Status_Code ReadData_Extended(byte* buffer, uint16_t len, unsigned long timeout) { return A7105_ReadData_Extended(&radio, buffer, len, timeout); }
+  A7105_Status_Code SetChannel(byte channel) { return A7105_SetChannel(&radio, channel); }
+  void Clear_Calibration_Cache() { A7105_Clear_Calibration_Cache(&radio); }
+  void SetPower(A7105_TxPower power) { A7105_SetPower(&radio, power); }
+  void Set_RSSI_Threshold(byte threshold) { A7105_Set_RSSI_Threshold(&radio, threshold); }
+  A7105_Status_Code Check_Channel_Clear() { return A7105_Check_Channel_Clear(&radio); }
+  byte Get_Events() { return A7105_Get_Events(&radio); }
+  void Pause() { A7105_Pause(&radio); }
+  void Resume() { A7105_Resume(&radio); }
+  void Reset() { A7105_Reset(&radio); }
+};
+
+#endif
@@ -33,7 +33,6 @@ POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include <stdint.h>
-#include <SPI.h>
 #include "a7105_mesh.h"
 
 
@@ -217,7 +216,7 @@ void A7105_Mesh_Set_Context(struct A7105_Mesh* node,void* context_obj)
   node->client_context_obj = context_obj;
 }
 
-uint16_t _A7105_Mesh_Calculate_Random_Delay(A7105_DataRate data_rate)
+uint16_t _A7105_Mesh_Packet_Time(A7105_DataRate data_rate)
 {
   //calculate the max time (full 64 bit packets) based on the data rate
   //and CRC/FEC options (assume they're on). NOTE: These are from
@@ -247,19 +246,109 @@ uint16_t _A7105_Mesh_Calculate_Random_Delay(A7105_DataRate data_rate)
       packet_transmit_time_ms = 494; 
       break;
   }
+  return packet_transmit_time_ms;
+}
+
+#ifdef A7105_MESH_TIMER1
+//Timer1 overflows (every 65536 ticks) for A7105_Mesh_Micros()
+volatile unsigned long _A7105_MESH_TIMER1_OVERFLOWS = 0;
+
+ISR(TIMER1_OVF_vect)
+{
+  _A7105_MESH_TIMER1_OVERFLOWS++;
+}
+#endif
+
+void _A7105_Mesh_Timer_Begin()
+{
+#ifdef A7105_MESH_TIMER1
+  //Already running (i.e. a second mesh node on this microcontroller)
+  if (TIMSK1 & _BV(TOIE1))
+    return;
+
+  //Normal mode (count up to 0xFFFF and wrap), F_CPU/8 prescaler, overflow interrupt
+  uint8_t oldSREG = SREG;
+  cli();
+  TCCR1A = 0;
+  TCCR1B = _BV(CS11);
+  TCNT1 = 0;
+  TIFR1 = _BV(TOV1);
+  TIMSK1 = _BV(TOIE1);
+  SREG = oldSREG;
+#endif
+}
+
+unsigned long A7105_Mesh_Micros()
+{
+#ifdef A7105_MESH_TIMER1
+  uint8_t oldSREG = SREG;
+  cli();
+  unsigned long overflows = _A7105_MESH_TIMER1_OVERFLOWS;
+  uint16_t ticks = TCNT1;
+
+  //Catch an overflow that happened while interrupts were off (the same trick micros() uses)
+  if ((TIFR1 & _BV(TOV1)) && ticks < 0x8000)
+    overflows++;
+  SREG = oldSREG;
+
+  //NOTE: Each overflow is an exact number of microseconds so this wraps cleanly at 2^32
+  return overflows * (65536UL / A7105_MESH_TIMER1_TICKS_PER_US) + ticks / A7105_MESH_TIMER1_TICKS_PER_US;
+#else
+  return micros();
+#endif
+}
 
+unsigned long _A7105_Mesh_Calculate_Random_Delay(A7105_DataRate data_rate)
+{
+  unsigned long packet_transmit_time_us = _A7105_Mesh_Packet_Time(data_rate) * 1000UL;
 
   //Determine a time between 2 and N packet transmissions
   //where N is the expected number of mesh nodes (max 255).
   //HACK: For now, just set this at 20, since more than that 
   //talking at once would be crazy
+  //NOTE: This is in microseconds so nodes land in different slots even at 250Kbps
   //uint16_t ret = packet_transmit_time_ms * (uint16_t)(random(4,41));
-  uint16_t ret = (uint16_t)(random(2*packet_transmit_time_ms,41*packet_transmit_time_ms));
+  unsigned long ret = (unsigned long)(random(2*packet_transmit_time_us,41*packet_transmit_time_us));
   //Serial.print("Random delay: ");
   //Serial.println(ret,DEC);
   return ret;
 }
 
+/*
+  Internal use only, (re-)arms the radio for first frames (and has the WTR 
+  interrupt forget about any tail it was listening for).
+*/
+static void _A7105_Mesh_Listen(struct A7105_Mesh* node)
+{
+#ifdef A7105_MESH_RX_RING
+  node->rx_ring_tail_len = 0;
+#endif
+#ifdef A7105_MESH_EARLY_REJECT
+  node->rx_ring_reject_tail = false;
+#endif
+  A7105_Easy_Listen_For_Packets(&(node->radio), A7105_MESH_FRAME_SIZE);
+}
+
+//The WTR interrupt reads the handled packet and repeat caches (see _A7105_Mesh_Early_Reject()),
+//so it's held off while we write an entry
+static byte _A7105_Mesh_Lock_Caches()
+{
+#ifdef A7105_MESH_EARLY_REJECT
+  return A7105_HAL_Lock();
+#else
+  return 0;
+#endif
+}
+
+static void _A7105_Mesh_Unlock_Caches(byte lock)
+{
+#ifdef A7105_MESH_EARLY_REJECT
+  A7105_HAL_Unlock(lock);
+#else
+  (void)lock;
+#endif
+}
+
 A7105_Mesh_Status A7105_Mesh_Initialize(struct A7105_Mesh* node, 
                                         int chip_select_pin,
                                         int wtr_pin,
@@ -282,8 +371,35 @@ A7105_Mesh_Status A7105_Mesh_Initialize(struct A7105_Mesh* node,
   //Set up our random generator seed
   randomSeed(A7105_Mesh_Get_Random_Seed(31,unconnected_analog_pin));
 
+  //Start the microsecond clock for backoff/repeat timing
+  _A7105_Mesh_Timer_Begin();
+
   //Init the node state
   node->state = A7105_Mesh_NOT_JOINED;
+  node->tx_pending = 0;
+  node->tx_started = 0;
+  node->tx_segments[0].len = 0;
+  node->tx_value_len = 0;
+  node->tx_frame_done = 0;
+  node->tx_tail_len = 0;
+  node->tx_tail = NULL;
+  node->rx_tail_len = 0;
+#if defined(A7105_MESH_CSMA) && !defined(A7105_MESH_RX_RING)
+  node->rx_backoff_len = 0;
+#endif
+#ifdef A7105_MESH_STATS
+  node->stat_tx_packets = 0;
+  node->stat_tx_frames = 0;
+  node->stat_tx_bytes = 0;
+  node->stat_rx_packets = 0;
+  node->stat_rx_errors = 0;
+  node->stat_tx_backoffs = 0;
+  node->stat_rx_rejects = 0;
+  node->stat_rx_reject_bytes = 0;
+#endif
+#ifdef A7105_MESH_CSMA
+  A7105_Set_RSSI_Threshold(&(node->radio), A7105_MESH_CSMA_RSSI_THOLD);
+#endif
   //DEBUG
   //node->registers = NULL;
   node->unique_id = (uint16_t)(random(0xFFFF) + 1); //1-0xFFFF unique ID. 0 means uninitialized
@@ -301,9 +417,20 @@ A7105_Mesh_Status A7105_Mesh_Initialize(struct A7105_Mesh* node,
   //memset(node->last_request_handled,0,A7105_MESH_PACKET_SIZE);
   //node->last_request_handled_time = 0;
   node->sequence_num = 0;
-  node->last_handled_packet_index = 0;
-  for (int x = 0; x < A7105_MESH_HANDLED_PACKET_CACHE_LENGTH;x++)
-    memset(node->handled_packet_cache[x],0,A7105_MESH_HANDLED_PACKET_HEADER_SIZE);
+  node->v1_peer = 0;
+  node->v1_peer_time = 0;
+  node->handled_clock = 0;
+  memset(node->handled_senders,0,sizeof(node->handled_senders));
+#ifdef A7105_MESH_ROUTING
+  memset(node->routes,0,sizeof(node->routes));
+#endif
+#ifdef A7105_MESH_REVERSE_PATH
+  memset(node->reverse_paths,0,sizeof(node->reverse_paths));
+#endif
+#ifdef A7105_MESH_LOCATE_REGISTERS
+  memset(node->register_locations,0,sizeof(node->register_locations));
+  node->register_location_clock = 0;
+#endif
 
   //Join tracking
   node->join_retransmit_delay = (uint16_t)random(A7105_MESH_MIN_JOIN_RETRANSMIT_DELAY,
@@ -333,6 +460,7 @@ A7105_Mesh_Status A7105_Mesh_Initialize(struct A7105_Mesh* node,
   node->client_context_obj = NULL;
   node->num_registers_cache = 0;
   memset(node->packet_cache,0,A7105_MESH_PACKET_SIZE);
+  memset(&(node->packet_meta),0,sizeof(node->packet_meta));
   node->operation_callback = NULL;
   node->blocking_operation_status = A7105_Mesh_NO_STATUS;
 
@@ -347,8 +475,16 @@ A7105_Mesh_Status A7105_Mesh_Initialize(struct A7105_Mesh* node,
   node->register_value_broadcast_callback = NULL;
   node->broadcast_cache = NULL;
 
-  //Start listening for packets
-  A7105_Easy_Listen_For_Packets(&(node->radio), A7105_MESH_PACKET_SIZE);
+  //Start listening for packets, the WTR interrupt reads them into the RX ring 
+  //(if there's no WTR pin A7105_RX_Ring_Begin() fails and we read the FIFO ourselves)
+  _A7105_Mesh_Listen(node);
+#ifdef A7105_MESH_RX_RING
+  A7105_RX_Ring_Begin(&(node->radio), node->rx_ring, A7105_MESH_RX_RING_SIZE, _A7105_Mesh_RX_Ring_Callback, node);
+#endif
+#ifdef A7105_MESH_EARLY_REJECT
+  node->rx_ring_rejected = false;
+  A7105_RX_Ring_Set_Filter(&(node->radio), _A7105_Mesh_RX_Ring_Filter);
+#endif
 
   switch(ret)
   {
@@ -389,6 +525,7 @@ void _rejoin_finished(struct A7105_Mesh* node,
   node->pending_operation = 0;
 
   //Restore the interrupted packet and set our new node-id
+  _A7105_Mesh_Wait_TX(node);
   memcpy(node->packet_cache,node->pending_request_cache,A7105_MESH_PACKET_SIZE);
   byte original_op = node->packet_cache[A7105_MESH_PACKET_TYPE];
 
@@ -597,8 +734,101 @@ byte _A7105_Mesh_Check_For_Node_ID_Conflicts(struct A7105_Mesh* node)
     
 }
 
+void _A7105_Mesh_Update_TX(struct A7105_Mesh* node)
+{
+  //Nothing in the air
+  if (!node->tx_pending)
+    return;
+
+  //Waiting to send the first frame?
+  if (!node->tx_started)
+  {
+#ifdef A7105_MESH_CSMA
+    //A packet showed up while we were waiting. The packet we're sending may be sitting
+    //in packet_cache, so _A7105_Mesh_Handle_RX() sets it aside until ours is out. If it's
+    //already holding one, drop this and keep listening.
+    //NOTE: With the RX ring it's already safe in the ring (and the radio listening again)
+#ifndef A7105_MESH_RX_RING
+    if (A7105_Get_Events(&(node->radio)) & A7105_EVENT_RX_READY)
+      _A7105_Mesh_Handle_RX(node);
+#endif
+    if (A7105_Get_Events(&(node->radio)) & A7105_EVENT_RX_READY)
+    {
+      node->rx_tail_len = 0;
+      _A7105_Mesh_Listen(node);
+#ifdef A7105_MESH_STATS
+      node->stat_rx_errors++;
+#endif
+    }
+
+    //Still backing off?
+    if (A7105_Mesh_Micros() - node->csma_backoff_start < node->csma_backoff_time)
+      return;
+
+    //Listen before talking, if someone else is on the air wait a random number 
+    //of slots (the window doubles each time) before trying again
+    if (node->csma_backoffs < A7105_MESH_CSMA_MAX_BACKOFFS &&
+        A7105_Check_Channel_Clear(&(node->radio)) != A7105_STATUS_OK)
+    {
+      node->csma_backoffs++;
+      unsigned long slot = _A7105_Mesh_Packet_Time((A7105_DataRate)(node->radio)._DATA_RATE) * 1000UL / 4;
+      node->csma_backoff_time = (unsigned long)random(slot, slot * ((1 << node->csma_backoffs) + 1));
+      node->csma_backoff_start = A7105_Mesh_Micros();
+#ifdef A7105_MESH_STATS
+      node->stat_tx_backoffs++;
+#endif
+      return;
+    }
+#endif
+    _A7105_Mesh_Send_First_Frame(node);
+    return;
+  }
+
+  //Still sending the current frame?
+  if (!node->tx_frame_done)
+  {
+    if (A7105_CheckTXFinished(&(node->radio)) != A7105_STATUS_OK)
+      return;
+    node->tx_frame_done = 1;
+    node->tx_frame_time = millis();
+  }
+
+  //Send the tail of a long packet once receivers have had time to re-arm for it
+  if (node->tx_tail_len > 0)
+  {
+    if (millis() - node->tx_frame_time < A7105_MESH_TAIL_GAP)
+      return;
+
+    A7105_WriteData_Gather(&(node->radio), node->tx_tail, node->tx_tail_len, NULL, NULL);
+#ifdef A7105_MESH_STATS
+    node->stat_tx_frames++;
+    node->stat_tx_bytes += node->tx_tail_len;
+#endif
+    node->tx_tail_len = 0;
+    node->tx_frame_done = 0;
+    return;
+  }
+
+  node->tx_pending = 0;
+
+  //Any long packet we were in the middle of receiving is lost
+  node->rx_tail_len = 0;
+
+  //Tell the radio to go back to listening
+  _A7105_Mesh_Listen(node);
+}
+
+void _A7105_Mesh_Wait_TX(struct A7105_Mesh* node)
+{
+  while (node->tx_pending)
+    _A7105_Mesh_Update_TX(node);
+}
+
 A7105_Mesh_Status A7105_Mesh_Update(struct A7105_Mesh* node)
 {
+  //Re-arm RX if the last packet we pushed has gone out
+  _A7105_Mesh_Update_TX(node);
+
   //Process any incoming packets
   _A7105_Mesh_Handle_RX(node);
 
@@ -978,6 +1208,11 @@ A7105_Mesh_Status A7105_Mesh_GetRegister(struct A7105_Mesh* node,
   //Cache the register name to filter on receipt of the packet
   A7105_Mesh_Register_Copy(&(node->register_cache),reg);
 
+#ifdef A7105_MESH_LOCATE_REGISTERS
+  //Ask the node that has it if we know which one that is
+  _A7105_Mesh_Target_Register_Request(node);
+#endif
+
   //Push the request to the radio
   _A7105_Mesh_Send_Request(node);
     
@@ -1001,6 +1236,10 @@ void _A7105_Mesh_Handle_GetRegister(struct A7105_Mesh* node)
       node->state != A7105_Mesh_JOINING &&
       _A7105_Mesh_Filter_Packet(node,A7105_MESH_PKT_GET_REGISTER,true))
   {
+    //bail if it was sent to another node (see A7105_MESH_PACKET_FLAG_TARGETED)
+    byte target = _A7105_Mesh_Get_Packet_Target(node->packet_cache);
+    if (target != 0 && target != node->node_id)
+      return;
 
     //bail if this isn't a register we service (otherwise, we'll have the index)
     int register_index = -1;
@@ -1017,12 +1256,13 @@ void _A7105_Mesh_Handle_GetRegister(struct A7105_Mesh* node)
       node->registers[register_index].get_callback(&(node->registers[register_index]),
                                                    node->client_context_obj);
 
-    //Put the current register name/value in the response packet   
-    _A7105_Mesh_Util_Register_To_Packet(node->packet_cache,
-                                        &(node->registers[register_index]),
-                                        true);
- 
-    _A7105_Mesh_Send_Response(node);
+    //Send the current register name/value straight from the Register
+    //(no point copying up to 57 bytes into the packet just to push them to the FIFO)
+    if (_A7105_Mesh_Start_Register_Value_TX(node, &(node->registers[register_index])))
+      _A7105_Mesh_Append_Response_Repeat(node, register_index);
+
+    //Update the response repeater timer (same as _A7105_Mesh_Send_Response())
+    node->last_response_repeat_sent_time = A7105_Mesh_Micros();
   }
 }
 
@@ -1054,6 +1294,9 @@ void _A7105_Mesh_Handle_RegisterValue(struct A7105_Mesh* node)
     //Record the responder info
     node->responder_node_id = node->packet_cache[A7105_MESH_PACKET_NODE_ID]; 
     node->responder_unique_id = A7105_Util_Get_Pkt_Unique_Id(node->packet_cache);
+#ifdef A7105_MESH_LOCATE_REGISTERS
+    _A7105_Mesh_Update_Register_Locations(node);
+#endif
 
     //Update our status back to IDLE
     node->state = A7105_Mesh_IDLE;
@@ -1068,6 +1311,17 @@ void _A7105_Mesh_Check_For_Timeout(struct A7105_Mesh* node,
   if (node->state == operation &&
       millis() - node->request_sent_time > (unsigned long)timeout)
   {
+#ifdef A7105_MESH_ROUTING
+    //The target might not be where we thought it was, flood the next request
+    if (node->pending_request_cache[A7105_MESH_PACKET_FLAGS] & A7105_MESH_PACKET_FLAG_ROUTED)
+      _A7105_Mesh_Forget_Route(node, _A7105_Mesh_Get_Packet_Target(node->pending_request_cache));
+#endif
+#ifdef A7105_MESH_LOCATE_REGISTERS
+    //A GET/SET_REGISTER sent to one node gets another go at the whole mesh
+    if (_A7105_Mesh_Retry_Register_Request(node))
+      return;
+#endif
+
     //Update our status back to IDLE and mark the request as a timeout
     node->state = A7105_Mesh_IDLE;
     node->operation_callback(node, A7105_Mesh_TIMEOUT, node->client_context_obj);
@@ -1105,6 +1359,11 @@ A7105_Mesh_Status A7105_Mesh_SetRegister(struct A7105_Mesh* node,
     return A7105_Mesh_INVALID_REGISTER_LENGTH;
   }
 
+#ifdef A7105_MESH_LOCATE_REGISTERS
+  //Ask the node that has it if we know which one that is
+  _A7105_Mesh_Target_Register_Request(node);
+#endif
+
   //Push the request to the radio
   _A7105_Mesh_Send_Request(node);
     
@@ -1122,6 +1381,19 @@ A7105_Mesh_Status A7105_Mesh_SetRegister(struct A7105_Mesh* node,
 
 }
 
+/*
+  Internal use only, copies the error string at 'src' to 'dest' (at most 
+  A7105_MESH_MAX_REGISTER_PART_SIZE - 1 characters) and terminates it.
+*/
+static void _A7105_Mesh_Copy_Error_Message(byte* dest, byte* src)
+{
+  byte len = 0;
+  while (len < A7105_MESH_MAX_REGISTER_PART_SIZE - 1 && src[len] != 0)
+    len++;
+  memcpy(dest, src, len);
+  dest[len] = 0;
+}
+
 void _A7105_Mesh_Handle_SetRegister(struct A7105_Mesh* node)
 {
   //If we're on a mesh and we see a SET_REGISTER request
@@ -1129,6 +1401,10 @@ void _A7105_Mesh_Handle_SetRegister(struct A7105_Mesh* node)
       node->state != A7105_Mesh_JOINING &&
       _A7105_Mesh_Filter_Packet(node,A7105_MESH_PKT_SET_REGISTER,true))
   {
+    //bail if it was sent to another node (see A7105_MESH_PACKET_FLAG_TARGETED)
+    byte target = _A7105_Mesh_Get_Packet_Target(node->packet_cache);
+    if (target != 0 && target != node->node_id)
+      return;
 
     //bail if this isn't a register we service (otherwise, we'll have the index)
     int register_index = -1;
@@ -1193,9 +1469,8 @@ void _A7105_Mesh_Handle_SetRegister(struct A7105_Mesh* node)
     //Copy the error from the register to the returning packet if it was set
     if (error_set)
     {
-      strncpy((char*)&(node->packet_cache[A7105_MESH_PACKET_ERR_MSG_START]),
-              (char*)node->register_cache._data,
-              A7105_MESH_MAX_REGISTER_PART_SIZE - 1);
+      _A7105_Mesh_Copy_Error_Message(&(node->packet_cache[A7105_MESH_PACKET_ERR_MSG_START]),
+                                     node->register_cache._data);
 
        //Re-Init the register cache also (since we potentially used it to store an error message)
        A7105_Mesh_Register_Initialize(&(node->register_cache),NULL,NULL);
@@ -1229,15 +1504,17 @@ void _A7105_Mesh_Handle_SetRegisterAck(struct A7105_Mesh* node)
       //Set the error flag in the register_cache
       node->register_cache._error_set = true;
       //copy the error string from the packet
-      strncpy((char*)node->register_cache._data,
-              (char*)&(node->packet_cache[A7105_MESH_PACKET_ERR_MSG_START]),
-              A7105_MESH_MAX_REGISTER_PART_SIZE - 1);
+      _A7105_Mesh_Copy_Error_Message(node->register_cache._data,
+                                     &(node->packet_cache[A7105_MESH_PACKET_ERR_MSG_START]));
 
     }
 
     //Record the responder info
     node->responder_node_id = node->packet_cache[A7105_MESH_PACKET_NODE_ID]; 
     node->responder_unique_id = A7105_Util_Get_Pkt_Unique_Id(node->packet_cache);
+#ifdef A7105_MESH_LOCATE_REGISTERS
+    _A7105_Mesh_Update_Register_Locations(node);
+#endif
 
     //Update our status back to IDLE
     node->state = A7105_Mesh_IDLE;
@@ -1322,6 +1599,13 @@ A7105_Mesh_Status A7105_Mesh_Broadcast(struct A7105_Mesh* node, struct A7105_Mes
 
 //////////////////////// Utility Functions ///////////////////////
       
+byte A7105_Mesh_Get_Header_Version(struct A7105_Mesh* node)
+{
+  if (node->v1_peer && millis() - node->v1_peer_time > A7105_MESH_V1_PEER_TIMEOUT)
+    node->v1_peer = 0;
+  return node->v1_peer ? A7105_MESH_PACKET_V1 : A7105_MESH_PACKET_V2;
+}
+
 byte A7105_Get_Next_Present_Node(struct A7105_Mesh* node, byte start)
 {
   if (start == 0xFF)
@@ -1358,7 +1642,9 @@ void _A7105_Mesh_Append_Repeat(struct A7105_Mesh* node)
   if (node->repeat_cache_size == A7105_MESH_MAX_REPEAT_CACHE_SIZE)
     return;
 
+  byte lock = _A7105_Mesh_Lock_Caches();
   memcpy(node->repeat_cache[node->repeat_cache_end],node->packet_cache,A7105_MESH_PACKET_SIZE);
+  _A7105_Mesh_Unlock_Caches(lock);
   node->repeat_cache_end += 1;
   node->repeat_cache_end %= A7105_MESH_MAX_REPEAT_CACHE_SIZE;
   node->repeat_cache_size++;
@@ -1379,12 +1665,14 @@ byte* _A7105_Mesh_Pop_Repeat(struct A7105_Mesh* node)
 
 void _A7105_Mesh_Update_Repeats(struct A7105_Mesh* node)
 {
-  //If we're on the mesh, we have packets to repeat,
+  //If we're on the mesh, we're not already sending/receiving, we have packets to repeat,
   //and it's been long enough since our last repeat (device id delay)
-  if (node->state != A7105_Mesh_NOT_JOINED &&
+  if (!node->tx_pending &&
+      node->rx_tail_len == 0 &&
+      node->state != A7105_Mesh_NOT_JOINED &&
       node->state != A7105_Mesh_JOINING &&
       node->repeat_cache_size > 0 &&
-      millis() - node->last_repeat_sent_time > (unsigned long)node->random_delay)
+      A7105_Mesh_Micros() - node->last_repeat_sent_time > node->random_delay)
   {
     /*A7105_Mesh_SerialDump("Last repeat time was: ");
     Serial.println(node->last_repeat_sent_time);
@@ -1402,11 +1690,11 @@ void _A7105_Mesh_Update_Repeats(struct A7105_Mesh* node)
     _A7105_Mesh_Set_Packet_Hop(packet,_A7105_Mesh_Get_Packet_Hop(packet) + 1);
     //Push the packet to the network (don't use the SendRequest since
     //we don't want to cache this anywhere else)
-    A7105_WriteData(&(node->radio), packet, A7105_MESH_PACKET_SIZE);
+    _A7105_Mesh_Start_TX(node, packet);
 
     //Update our "last repeat sent time" so our random delay
     //continues to space is from other packets (hopefully)
-    node->last_repeat_sent_time = millis();
+    node->last_repeat_sent_time = A7105_Mesh_Micros();
 
     //DEBUG (print packet to serial)
     #ifdef A7105_MESH_DEBUG
@@ -1420,20 +1708,8 @@ void _A7105_Mesh_Update_Repeats(struct A7105_Mesh* node)
     A7105_Mesh_SerialDump("...\r\n");
     #endif
 
-    //Wait for the transmission to finish,then start the radio
-    //listening again
-    while (A7105_CheckTXFinished(&(node->radio)) != A7105_STATUS_OK)
-    {
-      //Serial.println(digitalRead((node->radio)._INTERRUPT_PIN));
-      //HACK: Should we just busy wait or keep these delays()...
-      //delay(10);
-    }
-
-    //Tell the radio to go back to listening
-    A7105_Easy_Listen_For_Packets(&(node->radio), A7105_MESH_PACKET_SIZE);
-
-
-
+    //NOTE: We don't wait for the packet to go out, A7105_Mesh_Update() starts the 
+    //      radio listening again when it's done
   }
 
 }
@@ -1469,11 +1745,8 @@ void _A7105_Mesh_Response_Repeat_Cache_Packet_Prep(struct A7105_Mesh* node, int
       _A7105_Mesh_Util_Set_Register_Index(node->packet_cache,reg_index);
       break;
 
+    //Sent straight from the Register (see _A7105_Mesh_Update_Response_Repeats())
     case A7105_MESH_PKT_REGISTER_VALUE:
-      reg_index = node->response_repeat_cache[index][A7105_MESH_RESPONSE_REPEAT_DATA];
-      _A7105_Mesh_Util_Register_To_Packet(node->packet_cache,
-          &(node->registers[reg_index]),
-          true); //include value = true
        break;
     case A7105_MESH_PKT_SET_REGISTER_ACK:
       return_target = node->response_repeat_cache[index][A7105_MESH_RESPONSE_REPEAT_DATA];
@@ -1486,12 +1759,14 @@ void _A7105_Mesh_Response_Repeat_Cache_Packet_Prep(struct A7105_Mesh* node, int
 
 void _A7105_Mesh_Update_Response_Repeats(struct A7105_Mesh* node)
 {
-  //If we're on the mesh, we have packets to repeat,
+  //If we're on the mesh, we're not already sending/receiving, we have packets to repeat,
   //and it's been long enough since our last repeat (device id delay)
-  if (node->state != A7105_Mesh_NOT_JOINED &&
+  if (!node->tx_pending &&
+      node->rx_tail_len == 0 &&
+      node->state != A7105_Mesh_NOT_JOINED &&
       //node->state != A7105_Mesh_JOINING &&
       node->response_repeat_cache_size > 0 &&
-      millis() - node->last_response_repeat_sent_time > (unsigned long)node->random_delay)
+      A7105_Mesh_Micros() - node->last_response_repeat_sent_time > node->random_delay)
   {
 
    //Re-calculate random delay
@@ -1513,16 +1788,27 @@ void _A7105_Mesh_Update_Response_Repeats(struct A7105_Mesh* node)
 
     //Prepare the packet cache from the selected response repeater
     _A7105_Mesh_Response_Repeat_Cache_Packet_Prep(node, cache_element_to_repeat);
+#ifdef A7105_MESH_ROUTING
+    _A7105_Mesh_Route_Packet(node, node->packet_cache);
+#endif
 
     //Update our last sent time for delays between sends
-    node->last_response_repeat_sent_time = millis();
+    node->last_response_repeat_sent_time = A7105_Mesh_Micros();
 
     //Increment the repeat count for the response we're repeating
     node->response_repeat_cache[cache_element_to_repeat][A7105_MESH_RESPONSE_REPEAT_REP_COUNT] += 1;
 
     //Push the packet to the network (don't use the SendRequest since
     //we don't want to cache this anywhere else)
-    A7105_WriteData(&(node->radio), node->packet_cache, A7105_MESH_PACKET_SIZE);
+    if (node->packet_cache[A7105_MESH_PACKET_TYPE] == A7105_MESH_PKT_REGISTER_VALUE)
+    {
+      int reg_index = node->response_repeat_cache[cache_element_to_repeat][A7105_MESH_RESPONSE_REPEAT_DATA];
+      _A7105_Mesh_Start_Register_Value_TX(node, &(node->registers[reg_index]));
+    }
+    else
+    {
+      _A7105_Mesh_Start_TX(node, node->packet_cache);
+    }
 
     //DEBUG (print packet to serial)
 #ifdef A7105_MESH_DEBUG
@@ -1536,47 +1822,39 @@ void _A7105_Mesh_Update_Response_Repeats(struct A7105_Mesh* node)
     A7105_Mesh_SerialDump("...\r\n");
 #endif
 
-    //Wait for the transmission to finish,then start the radio
-    //listening again
-    while (A7105_CheckTXFinished(&(node->radio)) != A7105_STATUS_OK)
-    {
-      //Serial.println(digitalRead((node->radio)._INTERRUPT_PIN));
-      //HACK: Should we just busy wait or keep these delays()...
-      //delay(10);
-    }
-
+    //NOTE: We don't wait for the packet to go out, A7105_Mesh_Update() starts the 
+    //      radio listening again when it's done
 
     //Can we pop the first element in the cache to make room?
     if (node->response_repeat_cache[node->response_repeat_cache_start][A7105_MESH_RESPONSE_REPEAT_REP_COUNT] >= A7105_MESH_RESPONSE_MAX_REPEAT)
       _A7105_Mesh_Pop_Response_Repeat(node);
-
-    //Tell the radio to go back to listening
-    A7105_Easy_Listen_For_Packets(&(node->radio), A7105_MESH_PACKET_SIZE);
   }
 }
 
 void _A7105_Mesh_Update_Request_Repeats(struct A7105_Mesh* node)
 {
-  //If we're on the mesh, we have packets to repeat,
+  //If we're on the mesh, we're not already sending/receiving, we have packets to repeat,
   //and it's been long enough since our last repeat (device id delay)
-  if (node->state != A7105_Mesh_NOT_JOINED &&
+  if (!node->tx_pending &&
+      node->rx_tail_len == 0 &&
+      node->state != A7105_Mesh_NOT_JOINED &&
       node->state != A7105_Mesh_JOINING &&
       node->state != A7105_Mesh_IDLE &&
       node->request_repeat_count < A7105_MESH_REQUEST_MAX_REPEAT &&
-      millis() - node->last_request_repeat_sent_time > (unsigned long)node->random_delay)
+      A7105_Mesh_Micros() - node->last_request_repeat_sent_time > node->random_delay)
   {
     //Re-calculate random delay
     node->random_delay = _A7105_Mesh_Calculate_Random_Delay((A7105_DataRate)(node->radio)._DATA_RATE);
 
     //Update our last sent time for delays between sends
-    node->last_request_repeat_sent_time = millis();
+    node->last_request_repeat_sent_time = A7105_Mesh_Micros();
 
     //Increment the repeat count for the response we're repeating
     node->request_repeat_count += 1;
 
     //Push the packet to the network (don't use the SendRequest since
     //we don't want to cache this anywhere else)
-    A7105_WriteData(&(node->radio), node->pending_request_cache, A7105_MESH_PACKET_SIZE);
+    _A7105_Mesh_Start_TX(node, node->pending_request_cache);
 
     //DEBUG (print packet to serial)
 #ifdef A7105_MESH_DEBUG
@@ -1590,17 +1868,8 @@ void _A7105_Mesh_Update_Request_Repeats(struct A7105_Mesh* node)
     A7105_Mesh_SerialDump("...\r\n");
 #endif
 
-    //Wait for the transmission to finish,then start the radio
-    //listening again
-    while (A7105_CheckTXFinished(&(node->radio)) != A7105_STATUS_OK)
-    {
-      //Serial.println(digitalRead((node->radio)._INTERRUPT_PIN));
-      //HACK: Should we just busy wait or keep these delays()...
-      //delay(10);
-    }
-
-    //Tell the radio to go back to listening
-    A7105_Easy_Listen_For_Packets(&(node->radio), A7105_MESH_PACKET_SIZE);
+    //NOTE: We don't wait for the packet to go out, A7105_Mesh_Update() starts the 
+    //      radio listening again when it's done
   }
 }
 void _A7105_Mesh_Cache_Packet_For_Repeat(struct A7105_Mesh* node)
@@ -1615,11 +1884,8 @@ void _A7105_Mesh_Cache_Packet_For_Repeat(struct A7105_Mesh* node)
       A7105_Util_Get_Pkt_Unique_Id(node->packet_cache) == node->unique_id)
     return;
 
-  //Don't repeat if this was a request addressed to us
-  if ((node->packet_cache[A7105_MESH_PACKET_TYPE] == A7105_MESH_PKT_GET_NUM_REGISTERS ||
-      node->packet_cache[A7105_MESH_PACKET_TYPE] == A7105_MESH_PKT_SET_REGISTER_ACK ||
-      node->packet_cache[A7105_MESH_PACKET_TYPE] == A7105_MESH_PKT_GET_REGISTER_NAME) &&
-      node->packet_cache[A7105_MESH_PACKET_TARGET_ID] == node->node_id)
+  //Don't repeat if this was a request (or SET_REGISTER_ACK) addressed to us
+  if (_A7105_Mesh_Get_Packet_Target(node->packet_cache) == node->node_id)
     return;
 
   //Don't repeat if this packet is a response for our latest *directed* request
@@ -1676,16 +1942,32 @@ void _A7105_Mesh_Cache_Packet_For_Repeat(struct A7105_Mesh* node)
 
   }
   //Don't repeat of the packet has been repeated too many times
-  if (_A7105_Mesh_Get_Packet_Hop(node->packet_cache) >= A7105_MESH_MAX_HOP_COUNT)
+  if (_A7105_Mesh_Get_Packet_Hop(node->packet_cache) >= _A7105_Mesh_Get_Packet_TTL(node->packet_cache))
+    return;
+
+#ifdef A7105_MESH_ROUTING
+  //Don't repeat routed packets we're too far from the target for
+  if (!_A7105_Mesh_Route_Allows_Repeat(node, node->packet_cache))
+    return;
+#endif
+
+#ifdef A7105_MESH_REVERSE_PATH
+  //Don't repeat responses to requests we didn't repeat
+  if (!_A7105_Mesh_Reverse_Path_Allows_Repeat(node, node->packet_cache))
     return;
+#endif
 
   //If we make it here, the packet is suitable to be repeated
   _A7105_Mesh_Append_Repeat(node); 
+#ifdef A7105_MESH_REVERSE_PATH
+  //(and if it's a request, its response comes back through us, even if it beats our repeat out)
+  _A7105_Mesh_Remember_Reverse_Path(node, node->packet_cache);
+#endif
 }
 
 //Push a packet from the packet_cache to the end of the response
 //repeat cache
-void _A7105_Mesh_Append_Response_Repeat(struct A7105_Mesh* node)
+void _A7105_Mesh_Append_Response_Repeat(struct A7105_Mesh* node, int register_index)
 {
   //TODO: Overwrite the oldest entry instead of bailing
   if (node->response_repeat_cache_size == A7105_MESH_MAX_REPEAT_CACHE_SIZE)
@@ -1709,7 +1991,9 @@ void _A7105_Mesh_Append_Response_Repeat(struct A7105_Mesh* node)
       break;
     case A7105_MESH_PKT_REGISTER_NAME:
     case A7105_MESH_PKT_REGISTER_VALUE:
-      index = (byte)_A7105_Mesh_Filter_RegisterName(node);
+      if (register_index == -1)
+        register_index = _A7105_Mesh_Filter_RegisterName(node);
+      index = (byte)register_index;
       node->response_repeat_cache[node->response_repeat_cache_end][A7105_MESH_RESPONSE_REPEAT_DATA] = index;
       break;
     case A7105_MESH_PKT_SET_REGISTER_ACK:
@@ -1745,26 +2029,255 @@ byte* _A7105_Mesh_Pop_Response_Repeat(struct A7105_Mesh* node)
 byte _A7105_Mesh_Util_Is_Same_Packet_Sans_Hop(byte* a, byte* b)
 {
 
-  //Filter sequence here so we can ignore the whole hop/seq byte in the loop below
+  //Filter sequence first, it's the byte most likely to differ
   if (_A7105_Mesh_Get_Packet_Seq(a) != _A7105_Mesh_Get_Packet_Seq(b))  
       return false; 
 
+  //(a packet can come around both routed and flooded, see _A7105_Mesh_Route_Packet())
   for (int x = 0;x<A7105_MESH_PACKET_SIZE;x++)
-    if (a[x] != b[x] && x != A7105_MESH_PACKET_HOP_SEQ)
+    if (a[x] != b[x] && x != A7105_MESH_PACKET_HOP_TTL &&
+        (x != A7105_MESH_PACKET_FLAGS || (a[x] ^ b[x]) != A7105_MESH_PACKET_FLAG_ROUTED))
       return false;
   return true;
 }
 
+byte _A7105_Mesh_Calculate_Packet_Length(struct A7105_TX_Segment* segments)
+{
+#ifdef A7105_MESH_FIXED_PACKET_SIZE
+  return A7105_MESH_PACKET_SIZE;
+#else
+  //Packets are zero padded (see _A7105_Mesh_Prep_Packet_Header()), so 
+  //find the last byte in use
+  byte used = 0;
+  byte position = 0;
+  for (struct A7105_TX_Segment* segment = segments;
+       segment->len > 0 && position < A7105_MESH_PACKET_SIZE;
+       segment++)
+  {
+    for (byte x = 0; x < segment->len && position < A7105_MESH_PACKET_SIZE; x++)
+    {
+      position++;
+      if (segment->data != NULL && segment->data[x] != 0)
+        used = position;
+    }
+  }
+
+  if (used <= 16)
+    return 16;
+  if (used <= 32)
+    return 32;
+  return 64;
+#endif
+}
+
+byte _A7105_Mesh_Get_Packet_Length(byte* frame)
+{
+#ifdef A7105_MESH_FIXED_PACKET_SIZE
+  return A7105_MESH_PACKET_SIZE;
+#else
+  switch (frame[A7105_MESH_PACKET_TYPE] & A7105_MESH_PACKET_LEN_MASK)
+  {
+    case A7105_MESH_PACKET_LEN_32:
+      return 32;
+    case A7105_MESH_PACKET_LEN_64:
+      return 64;
+    default:
+      return 16;
+  }
+#endif
+}
+
+//Queues node->tx_segments for sending (see _A7105_Mesh_Start_TX())
+static void _A7105_Mesh_Start_TX_Segments(struct A7105_Mesh* node)
+{
+  //v1 packets go out with a v1 header in front of the rest of the packet
+  //(the first segment always has the whole header)
+  byte* header = node->tx_segments[0].data;
+  if (_A7105_Mesh_Get_Packet_Version(header) == A7105_MESH_PACKET_V1)
+  {
+    node->tx_v1_header[A7105_MESH_PACKET_TYPE] = header[A7105_MESH_PACKET_TYPE];
+    node->tx_v1_header[A7105_MESH_PACKET_HOP_TTL] = 
+        ((_A7105_Mesh_Get_Packet_Seq(header) << 4) & A7105_MESH_PACKET_V1_SEQ_MASK) |
+        _A7105_Mesh_Get_Packet_Hop(header);
+    memcpy(node->tx_v1_header + A7105_MESH_PACKET_NODE_ID, header + A7105_MESH_PACKET_NODE_ID, 3);
+
+    byte end = 1;
+    while (node->tx_segments[end].len > 0)
+      end++;
+    for (byte x = end; x > 0; x--)
+      node->tx_segments[x + 1] = node->tx_segments[x];
+    node->tx_segments[1].data = header + A7105_MESH_PACKET_HEADER_SIZE;
+    node->tx_segments[1].len = node->tx_segments[0].len - A7105_MESH_PACKET_HEADER_SIZE;
+    node->tx_segments[0].data = node->tx_v1_header;
+    node->tx_segments[0].len = A7105_MESH_PACKET_V1_HEADER_SIZE;
+  }
+
+  //_A7105_Mesh_Update_TX() takes it from here (and sends it right away if the channel is clear)
+  node->tx_pending = 1;
+  node->tx_started = 0;
+#ifdef A7105_MESH_CSMA
+  node->csma_backoffs = 0;
+  node->csma_backoff_time = 0;
+#endif
+
+#ifdef A7105_MESH_STATS
+  node->stat_tx_packets++;
+#endif
+
+  _A7105_Mesh_Update_TX(node);
+}
+
+void _A7105_Mesh_Start_TX(struct A7105_Mesh* node, byte* packet)
+{
+  node->tx_segments[0].data = packet;
+  node->tx_segments[0].len = A7105_MESH_PACKET_SIZE;
+  node->tx_segments[1].len = 0;
+  _A7105_Mesh_Start_TX_Segments(node);
+}
+
+byte _A7105_Mesh_Start_Register_Value_TX(struct A7105_Mesh* node,
+                                         struct A7105_Mesh_Register* reg)
+{
+  //Same sanity check as _A7105_Mesh_Util_Register_To_Packet()
+  int total_size = (int)reg->_name_len + (int)reg->_data_len;
+  if (total_size < 2 || total_size > A7105_MESH_MAX_REGISTER_ARRAY_SIZE)
+    return false;
+
+  //Header (with the name length) from the packet cache, then the same layout 
+  //_A7105_Mesh_Util_Register_To_Packet() builds: name, value length, value
+  node->packet_cache[A7105_MESH_PACKET_DATA_START] = reg->_name_len;
+  node->tx_value_len = reg->_data_len;
+
+  struct A7105_TX_Segment* segment = node->tx_segments;
+  segment->data = node->packet_cache;
+  segment->len = A7105_MESH_PACKET_DATA_START + 1;
+  segment++;
+  if (reg->_name_len > 0) //(a zero length segment would end the list)
+  {
+    segment->data = reg->_data;
+    segment->len = reg->_name_len;
+    segment++;
+  }
+  segment->data = &(node->tx_value_len);
+  segment->len = 1;
+  segment++;
+  if (reg->_data_len > 0)
+  {
+    segment->data = &(reg->_data[reg->_name_len]);
+    segment->len = reg->_data_len;
+    segment++;
+  }
+  segment->len = 0;
+
+  _A7105_Mesh_Start_TX_Segments(node);
+  return true;
+}
+
+void _A7105_Mesh_Send_First_Frame(struct A7105_Mesh* node)
+{
+  byte* header = node->tx_segments[0].data;
+
+#ifndef A7105_MESH_FIXED_PACKET_SIZE
+  byte length = _A7105_Mesh_Calculate_Packet_Length(node->tx_segments);
+
+  //Tag the first frame with the packet length so receivers know if a tail follows
+  if (length == 64)
+    header[A7105_MESH_PACKET_TYPE] |= A7105_MESH_PACKET_LEN_64;
+  else if (length == 32)
+    header[A7105_MESH_PACKET_TYPE] |= A7105_MESH_PACKET_LEN_32;
+#endif
+  //(and with the header version, v1 headers are sent from tx_v1_header)
+  if (header != node->tx_v1_header)
+    header[A7105_MESH_PACKET_TYPE] |= A7105_MESH_PACKET_TYPE_V2;
+
+  A7105_WriteData_Gather(&(node->radio), node->tx_segments, A7105_MESH_FRAME_SIZE, NULL, NULL);
+
+  //Let the first frame finish loading into the FIFO, then un-tag the packet (after 
+  //keeping the start of the frame, as it went out, to tag the tail with)
+  A7105_SPI_Wait();
+#ifndef A7105_MESH_FIXED_PACKET_SIZE
+  if (length > A7105_MESH_FRAME_SIZE)
+  {
+    struct A7105_TX_Segment* segment = node->tx_segments;
+    byte offset = 0;
+    for (byte x = 0; x < A7105_MESH_TAIL_TAG_SIZE; x++)
+    {
+      while (offset >= segment->len)
+      {
+        segment++;
+        offset = 0;
+      }
+      node->tx_tail_tag[x] = (segment->data != NULL) ? segment->data[offset] : 0;
+      offset++;
+    }
+  }
+#endif
+  header[A7105_MESH_PACKET_TYPE] &= A7105_MESH_PACKET_TYPE_MASK;
+
+  //The tail picks up where the first frame left off (trim the segments 
+  //in place, nothing needs the first frame again)
+  struct A7105_TX_Segment* tail = node->tx_segments;
+  byte skip = A7105_MESH_FRAME_SIZE;
+  while (tail->len > 0 && skip >= tail->len)
+  {
+    skip -= tail->len;
+    tail++;
+  }
+  if (tail->len > 0)
+  {
+    if (tail->data != NULL)
+      tail->data += skip;
+    tail->len -= skip;
+  }
+
+  node->tx_started = 1;
+  node->tx_frame_done = 0;
+  node->tx_tail = tail;
+  node->tx_tail_len = 0;
+#ifndef A7105_MESH_FIXED_PACKET_SIZE
+  if (length > A7105_MESH_FRAME_SIZE)
+  {
+    //The tail goes out behind the tag (see A7105_MESH_TAIL_TAG_SIZE)
+    struct A7105_TX_Segment* end = tail;
+    while (end->len > 0)
+      end++;
+    for (; end != tail; end--)
+      end[1] = end[0];
+    tail[1] = tail[0];
+    tail->data = node->tx_tail_tag;
+    tail->len = A7105_MESH_TAIL_TAG_SIZE;
+    node->tx_tail_len = length - A7105_MESH_FRAME_SIZE + A7105_MESH_TAIL_TAG_SIZE;
+  }
+#endif
+
+#ifdef A7105_MESH_STATS
+  node->stat_tx_frames++;
+  node->stat_tx_bytes += A7105_MESH_FRAME_SIZE;
+#endif
+}
+
 void _A7105_Mesh_Prep_Packet_Header(struct A7105_Mesh* node,
                                     byte packet_type)
 {
+  //Don't clobber a packet that's still going out
+  _A7105_Mesh_Wait_TX(node);
+
   //HACK: zero out the packet so our packet comparison function is easy to write and any strings written as payload get automatically zero delimited
   memset(node->packet_cache,0,A7105_MESH_PACKET_SIZE);
 
 
   node->packet_cache[A7105_MESH_PACKET_TYPE] = packet_type;
   _A7105_Mesh_Set_Packet_Hop(node->packet_cache,0);
-  _A7105_Mesh_Set_Packet_Seq(node->packet_cache,node->sequence_num);
+  _A7105_Mesh_Set_Packet_TTL(node->packet_cache,A7105_MESH_MAX_HOP_COUNT);
+  byte version = A7105_Mesh_Get_Header_Version(node);
+  node->packet_cache[A7105_MESH_PACKET_FLAGS] = version << 4;
+  if (version == A7105_MESH_PACKET_V1)
+  {
+    //We only send odd v1 sequence numbers, so v1 nodes can tell us apart (see A7105_MESH_V1_PEER_TIMEOUT)
+    _A7105_Mesh_Set_Packet_Seq(node->packet_cache,((node->sequence_num << 1) | 0x01) & 0x0F);
+  }
+  else
+    _A7105_Mesh_Set_Packet_Seq(node->packet_cache,node->sequence_num);
   node->packet_cache[A7105_MESH_PACKET_NODE_ID] = node->node_id;
   node->packet_cache[A7105_MESH_PACKET_UNIQUE_ID] = (node->unique_id)>>8;
   node->packet_cache[A7105_MESH_PACKET_UNIQUE_ID+1] = (node->unique_id) & 0xFF;
@@ -1789,11 +2302,19 @@ void _A7105_Mesh_Send_Response(struct A7105_Mesh* node)
       packet_type == A7105_MESH_PKT_REGISTER_VALUE ||
       packet_type == A7105_MESH_PKT_SET_REGISTER_ACK)
   { 
-    _A7105_Mesh_Append_Response_Repeat(node); 
+    _A7105_Mesh_Append_Response_Repeat(node, -1);
   }
 
+  //Only one packet in the air at a time
+  _A7105_Mesh_Wait_TX(node);
+
+#ifdef A7105_MESH_ROUTING
+  //Cut directed packets down to the route to their target
+  _A7105_Mesh_Route_Packet(node, node->packet_cache);
+#endif
+
   //Push the packet to the radio
-  A7105_WriteData(&(node->radio), node->packet_cache, A7105_MESH_PACKET_SIZE);
+  _A7105_Mesh_Start_TX(node, node->packet_cache);
 
   //DEBUG (print packet to serial)
   #ifdef A7105_MESH_DEBUG
@@ -1807,20 +2328,11 @@ void _A7105_Mesh_Send_Response(struct A7105_Mesh* node)
   A7105_Mesh_SerialDump("...\r\n");
   #endif
 
-  //Wait for the transmission to finish,then start the radio
-  //listening again
-  while (A7105_CheckTXFinished(&(node->radio)) != A7105_STATUS_OK)
-  {
-    //HACK: Should we just busy wait or keep these delays()...
-    //delay(10);
-  }
+  //NOTE: We don't wait for the packet to go out, A7105_Mesh_Update() starts the 
+  //      radio listening again when it's done
 
   //Update the response repeater timer (so we don't send another right away)
-  node->last_response_repeat_sent_time = millis();
-
-  //Tell the radio to go back to listening
-  A7105_Easy_Listen_For_Packets(&(node->radio), A7105_MESH_PACKET_SIZE);
-
+  node->last_response_repeat_sent_time = A7105_Mesh_Micros();
 }
 
 void _A7105_Mesh_Send_Request(struct A7105_Mesh* node)
@@ -1829,14 +2341,17 @@ void _A7105_Mesh_Send_Request(struct A7105_Mesh* node)
   node->request_sent_time = millis();
 
   //Bump the sequence number
-  node->sequence_num = (node->sequence_num + 1) % 16;
+  node->sequence_num++;
 
   //Reset the request repeater state
   node->request_repeat_count=0;
-  node->last_request_repeat_sent_time=node->request_sent_time;
+  node->last_request_repeat_sent_time=A7105_Mesh_Micros();
   
 
+  _A7105_Mesh_Send_Response(node);
+
   //If the packet isn't a join, save a copy in case we're interrupted
+  //(after sending it, so the copy is routed the same way)
   byte packet_type = node->packet_cache[A7105_MESH_PACKET_TYPE];
   if (packet_type != A7105_MESH_PKT_JOIN)
   {
@@ -1845,8 +2360,6 @@ void _A7105_Mesh_Send_Request(struct A7105_Mesh* node)
     memcpy(node->pending_request_cache,node->packet_cache,A7105_MESH_PACKET_SIZE);
   } 
 
-  _A7105_Mesh_Send_Response(node);
-
 }
                             
 void _A7105_Mesh_Send_Broadcast(struct A7105_Mesh* node)
@@ -1861,7 +2374,7 @@ void _A7105_Mesh_Send_Broadcast(struct A7105_Mesh* node)
   */
 
   //Bump the sequence number
-  node->sequence_num = (node->sequence_num + 1) % 16;
+  node->sequence_num++;
   _A7105_Mesh_Send_Response(node);
 }
 
@@ -1963,6 +2476,33 @@ byte _A7105_Mesh_Util_Set_Register_Index(byte* packet, byte index)
   packet[offset+1] = index;
   return 1;
 }
+
+uint16_t _A7105_Mesh_Util_Packet_Name_Hash(byte* packet)
+{
+  byte len = packet[A7105_MESH_PACKET_DATA_START];
+  if (len > A7105_MESH_PACKET_SIZE - A7105_MESH_PACKET_NAME_START)
+    len = A7105_MESH_PACKET_SIZE - A7105_MESH_PACKET_NAME_START;
+  uint16_t hash = len;
+  for (byte x = 0; x < len; x++)
+    hash = ((hash << 5) + hash) ^ packet[A7105_MESH_PACKET_NAME_START + x];
+  return hash;
+}
+
+int _A7105_Mesh_Util_Register_Target_Index(byte* packet, byte len)
+{
+  //Past the name (and value for SET_REGISTER), reading each length as we get to it
+  int index = A7105_MESH_PACKET_DATA_START;
+  if (index >= len)
+    return index;
+  index += packet[index] + 1;
+  if ((packet[A7105_MESH_PACKET_TYPE] & A7105_MESH_PACKET_TYPE_MASK) == A7105_MESH_PKT_SET_REGISTER)
+  {
+    if (index >= len)
+      return index;
+    index += packet[index] + 1;
+  }
+  return index;
+}
                  
 byte _A7105_Mesh_Util_Packet_To_Register(byte* packet,                  
                                          struct A7105_Mesh_Register* reg,
@@ -2046,62 +2586,901 @@ byte _A7105_Mesh_Cmp_Packet_Register(byte* packet,
   return false;
 }
 
-void _A7105_Mesh_Handling_Request(struct A7105_Mesh* node,
-                                  byte* packet)
+/*
+  Internal use only, the first slot of the handled request table to look at for 'unique_id'
+  (the next A7105_MESH_HANDLED_PROBES - 1 slots after it are the other places it can be).
+*/
+static inline byte _A7105_Mesh_Handled_Slot(uint16_t unique_id)
 {
-  //Save the header info for our handled packet index
-  node->handled_packet_cache[node->last_handled_packet_index][A7105_MESH_HANDLED_PACKET_OP] = node->packet_cache[A7105_MESH_PACKET_TYPE];
-  node->handled_packet_cache[node->last_handled_packet_index][A7105_MESH_HANDLED_PACKET_SEQ] = _A7105_Mesh_Get_Packet_Seq(node->packet_cache);
-  node->handled_packet_cache[node->last_handled_packet_index][A7105_MESH_HANDLED_PACKET_UNIQUE_ID] = node->packet_cache[A7105_MESH_PACKET_UNIQUE_ID]; 
-  node->handled_packet_cache[node->last_handled_packet_index][A7105_MESH_HANDLED_PACKET_UNIQUE_ID+1] = node->packet_cache[A7105_MESH_PACKET_UNIQUE_ID+1]; 
-  
-  //increment the index to store the next request
-  node->last_handled_packet_index = (node->last_handled_packet_index + 1) % A7105_MESH_HANDLED_PACKET_CACHE_LENGTH;
-
+  return (byte)(unique_id ^ (unique_id >> 8)) & (A7105_MESH_HANDLED_SENDERS - 1);
 }
 
-void _A7105_Mesh_Update_Handled_Packet_Cache(struct A7105_Mesh* node)
+/*
+  Internal use only, finds the sender of 'packet' in the handled request table.
+  Returns NULL if we don't have a window for it (or nothing in it). A sender 
+  that switches header versions gets a new window (its sequence numbers restart).
+*/
+static struct A7105_Mesh_Handled_Sender* _A7105_Mesh_Find_Handled_Sender(struct A7105_Mesh* node, byte* packet)
 {
-  //Get the sequence number of the current packet
-  byte seq = _A7105_Mesh_Get_Packet_Seq(node->packet_cache);
-
-  //Iterate the handled packet cache
-  for (int x = 0;x<A7105_MESH_HANDLED_PACKET_CACHE_LENGTH;x++)
+  uint16_t unique_id = A7105_Util_Get_Pkt_Unique_Id(packet);
+  byte version = _A7105_Mesh_Get_Packet_Version(packet);
+  byte slot = _A7105_Mesh_Handled_Slot(unique_id);
+  for (byte x = 0; x < A7105_MESH_HANDLED_PROBES; x++)
   {
-
-    //If this is a packet from the same UNIQUE ID as the one in the cache
-      if (node->handled_packet_cache[x][A7105_MESH_HANDLED_PACKET_UNIQUE_ID] == node->packet_cache[A7105_MESH_PACKET_UNIQUE_ID] && 
-          node->handled_packet_cache[x][A7105_MESH_HANDLED_PACKET_UNIQUE_ID+1] == node->packet_cache[A7105_MESH_PACKET_UNIQUE_ID+1])
-      //If this node is now  at a sequence number approaching the one in the cache
-      for (int y=1;y<=A7105_MESH_HANDLED_PACKET_CACHE_SEQ_EXPIRE;y++)
-        if (((seq + (byte)y)%16) == node->handled_packet_cache[x][A7105_MESH_HANDLED_PACKET_SEQ])
-        {
-          //Zero out the cache item so it isn't considered any more
-          memset(node->handled_packet_cache[x],0,A7105_MESH_HANDLED_PACKET_HEADER_SIZE);
-          break;
-        }
+    struct A7105_Mesh_Handled_Sender* sender = &(node->handled_senders[(slot + x) & (A7105_MESH_HANDLED_SENDERS - 1)]);
+    if (sender->seq_mask != 0 && sender->unique_id == unique_id && sender->version == version)
+      return sender;
   }
+  return NULL;
+}
 
+/*
+  Internal use only, how far ahead of (or behind) the newest sequence number 'sender' 
+  has sent 'seq' is. Anything up to half way around (8 for v1's 4 bit sequence numbers, 
+  128 for v2) ahead is new, the rest is behind it.
+*/
+static inline byte _A7105_Mesh_Handled_Seq_Ahead(struct A7105_Mesh_Handled_Sender* sender, byte seq)
+{
+  byte ahead = seq - sender->newest_seq;
+  if (sender->version == A7105_MESH_PACKET_V1)
+    ahead &= 0x0F;
+  return ahead;
 }
 
-void _A7105_Mesh_Prep_Finishing_Callback(struct A7105_Mesh* node,
-                                             void (*user_finished_callback)(struct A7105_Mesh*,A7105_Mesh_Status,void*),
-                                             void (*blocking_finished_callback)(struct A7105_Mesh*,A7105_Mesh_Status,void*))
+static inline byte _A7105_Mesh_Handled_Seq_Behind(struct A7105_Mesh_Handled_Sender* sender, byte seq)
 {
-  //Set blocking state vars
-  node->blocking_operation_status = A7105_Mesh_NO_STATUS;
-  if (user_finished_callback == NULL)
-    node->operation_callback = blocking_finished_callback;
+  byte behind = sender->newest_seq - seq;
+  if (sender->version == A7105_MESH_PACKET_V1)
+    behind &= 0x0F;
+  return behind;
+}
+
+static inline byte _A7105_Mesh_Handled_Seq_Is_New(struct A7105_Mesh_Handled_Sender* sender, byte ahead)
+{
+  return ahead != 0 && ahead <= ((sender->version == A7105_MESH_PACKET_V1) ? 8 : 128);
+}
+
+byte _A7105_Mesh_Is_Handled_Request(struct A7105_Mesh* node, byte* packet)
+{
+  struct A7105_Mesh_Handled_Sender* sender = _A7105_Mesh_Find_Handled_Sender(node, packet);
+  if (sender == NULL)
+    return false;
+
+  //Anything ahead of the newest sequence number we've seen is new (see
+  //_A7105_Mesh_Update_Handled_Packet_Cache()), so is anything too far behind 
+  //it for the window
+  byte seq = _A7105_Mesh_Get_Packet_Seq(packet);
+  byte ahead = _A7105_Mesh_Handled_Seq_Ahead(sender, seq);
+  if (_A7105_Mesh_Handled_Seq_Is_New(sender, ahead))
+    return false;
+  //NOTE: Requesters bump the sequence number for every request, so the 
+  //      sequence number alone tells requests apart
+  byte behind = _A7105_Mesh_Handled_Seq_Behind(sender, seq);
+  if (behind >= 16)
+    return false;
+  return (sender->seq_mask & (1 << behind)) != 0;
+}
+
+void _A7105_Mesh_Handling_Request(struct A7105_Mesh* node,
+                                  byte* packet)
+{
+  uint16_t unique_id = A7105_Util_Get_Pkt_Unique_Id(packet);
+  byte seq = _A7105_Mesh_Get_Packet_Seq(packet);
+  node->handled_clock++;
+
+  byte lock = _A7105_Mesh_Lock_Caches();
+  struct A7105_Mesh_Handled_Sender* sender = _A7105_Mesh_Find_Handled_Sender(node, packet);
+  if (sender == NULL)
+  {
+    //Take an empty slot, or forget whoever we handled a request for longest ago
+    byte slot = _A7105_Mesh_Handled_Slot(unique_id);
+    for (byte x = 0; x < A7105_MESH_HANDLED_PROBES; x++)
+    {
+      struct A7105_Mesh_Handled_Sender* probe = &(node->handled_senders[(slot + x) & (A7105_MESH_HANDLED_SENDERS - 1)]);
+      if (probe->seq_mask == 0)
+      {
+        sender = probe;
+        break;
+      }
+      if (sender == NULL ||
+          (byte)(node->handled_clock - probe->last_used) > (byte)(node->handled_clock - sender->last_used))
+        sender = probe;
+    }
+    sender->unique_id = unique_id;
+    sender->version = _A7105_Mesh_Get_Packet_Version(packet);
+    sender->seq_mask = 0;
+    sender->newest_seq = seq;
+  }
+
+  //Requests too far behind the window start it over (the sender probably restarted)
+  byte behind = _A7105_Mesh_Handled_Seq_Behind(sender, seq);
+  if (behind >= 16)
+  {
+    sender->seq_mask = 0;
+    sender->newest_seq = seq;
+    behind = 0;
+  }
+
+  sender->seq_mask |= (1 << behind);
+  sender->last_used = node->handled_clock;
+  _A7105_Mesh_Unlock_Caches(lock);
+}
+
+void _A7105_Mesh_Update_Handled_Packet_Cache(struct A7105_Mesh* node)
+{
+  struct A7105_Mesh_Handled_Sender* sender = _A7105_Mesh_Find_Handled_Sender(node, node->packet_cache);
+  if (sender == NULL)
+    return;
+
+  //Only packets less than half way around ahead of the newest one move the window, 
+  //the rest are late repeats
+  byte ahead = _A7105_Mesh_Handled_Seq_Ahead(sender, _A7105_Mesh_Get_Packet_Seq(node->packet_cache));
+  if (!_A7105_Mesh_Handled_Seq_Is_New(sender, ahead))
+    return;
+
+  //Everything we handled slides back by however far the sender moved (falling
+  //out of the window after 16, long before the sequence number gets back around)
+  byte lock = _A7105_Mesh_Lock_Caches();
+  sender->newest_seq = _A7105_Mesh_Get_Packet_Seq(node->packet_cache);
+  sender->seq_mask = (ahead < 16) ? (uint16_t)(sender->seq_mask << ahead) : 0;
+  _A7105_Mesh_Unlock_Caches(lock);
+}
+
+#ifdef A7105_MESH_ROUTING
+/*
+  Internal use only, the route table entry for 'node_id' (NULL if we don't have 
+  one or it's expired).
+*/
+static struct A7105_Mesh_Route* _A7105_Mesh_Find_Route(struct A7105_Mesh* node, byte node_id)
+{
+  if (node_id == 0)
+    return NULL;
+  for (byte x = 0; x < A7105_MESH_ROUTES; x++)
+  {
+    struct A7105_Mesh_Route* route = &(node->routes[x]);
+    if (route->node_id == node_id)
+      return (millis() - route->heard_time < A7105_MESH_ROUTE_TIMEOUT) ? route : NULL;
+  }
+  return NULL;
+}
+
+void _A7105_Mesh_Update_Routes(struct A7105_Mesh* node)
+{
+  byte node_id = node->packet_cache[A7105_MESH_PACKET_NODE_ID];
+  if (node_id == 0 || node_id == node->node_id)
+    return;
+  byte hops = _A7105_Mesh_Get_Packet_Hop(node->packet_cache) + 1;
+  unsigned long now = millis();
+
+  //The node's entry, or else a free one, or else the one we heard longest ago
+  struct A7105_Mesh_Route* route = node->routes;
+  for (byte x = 0; x < A7105_MESH_ROUTES; x++)
+  {
+    struct A7105_Mesh_Route* entry = &(node->routes[x]);
+    if (entry->node_id == node_id)
+    {
+      route = entry;
+      break;
+    }
+    if (route->node_id != 0 &&
+        (entry->node_id == 0 || now - entry->heard_time > now - route->heard_time))
+      route = entry;
+  }
+
+  //Later copies of a packet come the long way around, they only count once
+  //what we heard before has expired
+  if (route->node_id == node_id &&
+      now - route->heard_time < A7105_MESH_ROUTE_TIMEOUT &&
+      hops > route->hops)
+    return;
+
+  byte lock = _A7105_Mesh_Lock_Caches();
+  route->node_id = node_id;
+  route->hops = hops;
+  route->heard_time = now;
+  _A7105_Mesh_Unlock_Caches(lock);
+}
+
+void _A7105_Mesh_Route_Packet(struct A7105_Mesh* node, byte* packet)
+{
+  //(v1 headers don't have the flags)
+  if (_A7105_Mesh_Get_Packet_Version(packet) != A7105_MESH_PACKET_V2)
+    return;
+  struct A7105_Mesh_Route* route = _A7105_Mesh_Find_Route(node, _A7105_Mesh_Get_Packet_Target(packet));
+  if (route == NULL)
+    return;
+
+  //The target hears the packet after hops - 1 repeats
+  byte ttl = route->hops - 1 + A7105_MESH_ROUTE_SLACK;
+  if (ttl >= A7105_MESH_MAX_HOP_COUNT)
+    return;
+  packet[A7105_MESH_PACKET_FLAGS] |= A7105_MESH_PACKET_FLAG_ROUTED;
+  _A7105_Mesh_Set_Packet_TTL(packet, ttl);
+}
+
+byte _A7105_Mesh_Route_Allows_Repeat(struct A7105_Mesh* node, byte* packet)
+{
+  if (!(packet[A7105_MESH_PACKET_FLAGS] & A7105_MESH_PACKET_FLAG_ROUTED))
+    return true;
+
+  //Our repeat goes out with hop + 1 and takes route->hops - 1 more repeats to 
+  //get to the target, all of which have to fit in the TTL
+  struct A7105_Mesh_Route* route = _A7105_Mesh_Find_Route(node, _A7105_Mesh_Get_Packet_Target(packet));
+  return (route == NULL ||
+          route->hops + _A7105_Mesh_Get_Packet_Hop(packet) <= _A7105_Mesh_Get_Packet_TTL(packet));
+}
+
+void _A7105_Mesh_Forget_Route(struct A7105_Mesh* node, byte node_id)
+{
+  struct A7105_Mesh_Route* route = _A7105_Mesh_Find_Route(node, node_id);
+  if (route == NULL)
+    return;
+  byte lock = _A7105_Mesh_Lock_Caches();
+  route->node_id = 0;
+  _A7105_Mesh_Unlock_Caches(lock);
+}
+#endif
+
+#ifdef A7105_MESH_REVERSE_PATH
+/*
+  Internal use only, the packet type of the response to 'packet' if it's a request 
+  we can pick the response to out (request types are one less than their response's),
+  0 otherwise.
+*/
+static byte _A7105_Mesh_Reverse_Path_Response_Type(byte* packet)
+{
+  byte type = packet[A7105_MESH_PACKET_TYPE] & A7105_MESH_PACKET_TYPE_MASK;
+  switch (type)
+  {
+    case A7105_MESH_PKT_GET_NUM_REGISTERS:
+    case A7105_MESH_PKT_GET_REGISTER_NAME:
+    case A7105_MESH_PKT_GET_REGISTER:
+    case A7105_MESH_PKT_SET_REGISTER:
+      return type + 1;
+  }
+  return 0;
+}
+
+/*
+  Internal use only, the byte a request and its response have in common (besides the
+  requester, which responses don't carry): the target for directed requests (the
+  responder's node ID), a hash of the register name for GET_REGISTER and the requester's
+  node ID for SET_REGISTER (SET_REGISTER_ACKs are sent to it).
+*/
+static byte _A7105_Mesh_Reverse_Path_Key(byte* packet)
+{
+  switch (packet[A7105_MESH_PACKET_TYPE] & A7105_MESH_PACKET_TYPE_MASK)
+  {
+    case A7105_MESH_PKT_GET_NUM_REGISTERS:
+    case A7105_MESH_PKT_GET_REGISTER_NAME:
+    case A7105_MESH_PKT_SET_REGISTER_ACK:
+      return packet[A7105_MESH_PACKET_TARGET_ID];
+    case A7105_MESH_PKT_NUM_REGISTERS:
+    case A7105_MESH_PKT_REGISTER_NAME:
+    case A7105_MESH_PKT_SET_REGISTER:
+      return packet[A7105_MESH_PACKET_NODE_ID];
+  }
+
+  //GET_REGISTER and REGISTER_VALUE (both start with the register name)
+  uint16_t hash = _A7105_Mesh_Util_Packet_Name_Hash(packet);
+  return (byte)(hash ^ (hash >> 8));
+}
+
+void _A7105_Mesh_Remember_Reverse_Path(struct A7105_Mesh* node, byte* packet)
+{
+  byte type = _A7105_Mesh_Reverse_Path_Response_Type(packet);
+  if (type == 0)
+    return;
+  uint16_t unique_id = A7105_Util_Get_Pkt_Unique_Id(packet);
+  byte seq = _A7105_Mesh_Get_Packet_Seq(packet);
+  unsigned long now = millis();
+
+  //The request's entry (we repeat a request once, but the requester sends it a
+  //few times), or else the one we made longest ago
+  struct A7105_Mesh_Reverse_Path* path = node->reverse_paths;
+  for (byte x = 0; x < A7105_MESH_REVERSE_PATHS; x++)
+  {
+    struct A7105_Mesh_Reverse_Path* entry = &(node->reverse_paths[x]);
+    if (entry->type == type && entry->unique_id == unique_id && entry->seq == seq)
+    {
+      path = entry;
+      break;
+    }
+    if (path->type != 0 &&
+        (entry->type == 0 || now - entry->time > now - path->time))
+      path = entry;
+  }
+
+  byte lock = _A7105_Mesh_Lock_Caches();
+  path->unique_id = unique_id;
+  path->seq = seq;
+  path->type = type;
+  path->key = _A7105_Mesh_Reverse_Path_Key(packet);
+  path->time = now;
+  _A7105_Mesh_Unlock_Caches(lock);
+}
+
+byte _A7105_Mesh_Reverse_Path_Allows_Repeat(struct A7105_Mesh* node, byte* packet)
+{
+  //PONGs and value broadcasts (node ID 0) still go everywhere
+  byte type = packet[A7105_MESH_PACKET_TYPE] & A7105_MESH_PACKET_TYPE_MASK;
+  if ((type != A7105_MESH_PKT_NUM_REGISTERS &&
+       type != A7105_MESH_PKT_REGISTER_NAME &&
+       type != A7105_MESH_PKT_REGISTER_VALUE &&
+       type != A7105_MESH_PKT_SET_REGISTER_ACK) ||
+      packet[A7105_MESH_PACKET_NODE_ID] == 0)
+    return true;
+
+  byte key = _A7105_Mesh_Reverse_Path_Key(packet);
+  for (byte x = 0; x < A7105_MESH_REVERSE_PATHS; x++)
+  {
+    struct A7105_Mesh_Reverse_Path* path = &(node->reverse_paths[x]);
+    if (path->type == type && path->key == key &&
+        millis() - path->time < A7105_MESH_REVERSE_PATH_TIMEOUT)
+      return true;
+  }
+  return false;
+}
+#endif
+
+#ifdef A7105_MESH_LOCATE_REGISTERS
+/*
+  Internal use only, the register location entry for the register name with 'name_hash'
+  (NULL if we don't know where it is).
+*/
+static struct A7105_Mesh_Register_Location* _A7105_Mesh_Find_Register_Location(struct A7105_Mesh* node, uint16_t name_hash)
+{
+  for (byte x = 0; x < A7105_MESH_REGISTER_LOCATIONS; x++)
+  {
+    struct A7105_Mesh_Register_Location* location = &(node->register_locations[x]);
+    if (location->node_id != 0 && location->name_hash == name_hash)
+      return location;
+  }
+  return NULL;
+}
+
+void _A7105_Mesh_Target_Register_Request(struct A7105_Mesh* node)
+{
+  node->register_location_clock++;
+
+  //(v1 headers don't have the flags)
+  if (_A7105_Mesh_Get_Packet_Version(node->packet_cache) != A7105_MESH_PACKET_V2)
+    return;
+  struct A7105_Mesh_Register_Location* location = 
+      _A7105_Mesh_Find_Register_Location(node, _A7105_Mesh_Util_Packet_Name_Hash(node->packet_cache));
+  if (location == NULL)
+    return;
+  int index = _A7105_Mesh_Util_Register_Target_Index(node->packet_cache, A7105_MESH_PACKET_SIZE);
+  if (index >= A7105_MESH_PACKET_SIZE)
+    return;
+
+  node->packet_cache[index] = location->node_id;
+  node->packet_cache[A7105_MESH_PACKET_FLAGS] |= A7105_MESH_PACKET_FLAG_TARGETED;
+  location->last_used = node->register_location_clock;
+
+  //Only far enough to get there (_A7105_Mesh_Route_Packet() routes it too if it knows the way)
+  byte ttl = location->hops - 1 + A7105_MESH_ROUTE_SLACK;
+  if (ttl < A7105_MESH_MAX_HOP_COUNT)
+    _A7105_Mesh_Set_Packet_TTL(node->packet_cache, ttl);
+
+  //Only that node's answer counts
+  node->target_node_id = location->node_id;
+  node->target_unique_id = location->unique_id;
+}
+
+void _A7105_Mesh_Update_Register_Locations(struct A7105_Mesh* node)
+{
+  //(REGISTER_VALUE broadcasts don't say who sent them)
+  byte node_id = node->packet_cache[A7105_MESH_PACKET_NODE_ID];
+  if (node_id == 0)
+    return;
+
+  //The register's entry, or else a free one, or else the one we asked for least recently
+  uint16_t name_hash = _A7105_Mesh_Util_Packet_Name_Hash(node->pending_request_cache);
+  byte clock = node->register_location_clock;
+  struct A7105_Mesh_Register_Location* location = node->register_locations;
+  for (byte x = 0; x < A7105_MESH_REGISTER_LOCATIONS; x++)
+  {
+    struct A7105_Mesh_Register_Location* entry = &(node->register_locations[x]);
+    if (entry->node_id != 0 && entry->name_hash == name_hash)
+    {
+      location = entry;
+      break;
+    }
+    if (location->node_id != 0 &&
+        (entry->node_id == 0 || 
+         (byte)(clock - entry->last_used) > (byte)(clock - location->last_used)))
+      location = entry;
+  }
+
+  location->name_hash = name_hash;
+  location->node_id = node_id;
+  location->unique_id = A7105_Util_Get_Pkt_Unique_Id(node->packet_cache);
+  location->hops = _A7105_Mesh_Get_Packet_Hop(node->packet_cache) + 1;
+  location->last_used = clock;
+}
+
+byte _A7105_Mesh_Retry_Register_Request(struct A7105_Mesh* node)
+{
+  byte* request = node->pending_request_cache;
+  byte type = request[A7105_MESH_PACKET_TYPE];
+  if ((type != A7105_MESH_PKT_GET_REGISTER && type != A7105_MESH_PKT_SET_REGISTER) ||
+      !(request[A7105_MESH_PACKET_FLAGS] & A7105_MESH_PACKET_FLAG_TARGETED))
+    return false;
+
+  //The register isn't where we thought (or its node is gone)
+  struct A7105_Mesh_Register_Location* location = 
+      _A7105_Mesh_Find_Register_Location(node, _A7105_Mesh_Util_Packet_Name_Hash(request));
+  if (location != NULL)
+    location->node_id = 0;
+
+  //Same register (and value), new header without the target
+  _A7105_Mesh_Prep_Packet_Header(node, type);
+  memcpy(node->packet_cache + A7105_MESH_PACKET_HEADER_SIZE,
+         request + A7105_MESH_PACKET_HEADER_SIZE,
+         A7105_MESH_PACKET_SIZE - A7105_MESH_PACKET_HEADER_SIZE);
+  node->packet_cache[_A7105_Mesh_Util_Register_Target_Index(node->packet_cache, A7105_MESH_PACKET_SIZE)] = 0;
+  node->target_node_id = 0;
+  node->target_unique_id = 0;
+
+  _A7105_Mesh_Send_Request(node);
+  return true;
+}
+#endif
+
+void _A7105_Mesh_Prep_Finishing_Callback(struct A7105_Mesh* node,
+                                             void (*user_finished_callback)(struct A7105_Mesh*,A7105_Mesh_Status,void*),
+                                             void (*blocking_finished_callback)(struct A7105_Mesh*,A7105_Mesh_Status,void*))
+{
+  //Set blocking state vars
+  node->blocking_operation_status = A7105_Mesh_NO_STATUS;
+  if (user_finished_callback == NULL)
+    node->operation_callback = blocking_finished_callback;
   else
     node->operation_callback = user_finished_callback;
 }
 
+/*
+  Internal use only, turns the first 'len' bytes of the v1 packet in 'packet' into
+  the v2 layout the rest of the library uses (moving everything after the header
+  back, 'packet' needs room for the extra bytes). v1 packets get the most hops we'd
+  give our own.
+*/
+static void _A7105_Mesh_Expand_V1_Packet(byte* packet, byte len)
+{
+  byte hop_seq = packet[A7105_MESH_PACKET_HOP_TTL];
+  memmove(packet + A7105_MESH_PACKET_HEADER_SIZE, 
+          packet + A7105_MESH_PACKET_V1_HEADER_SIZE, 
+          len - A7105_MESH_PACKET_V1_HEADER_SIZE);
+  packet[A7105_MESH_PACKET_HOP_TTL] = hop_seq & A7105_MESH_PACKET_HOP_MASK;
+  _A7105_Mesh_Set_Packet_TTL(packet, A7105_MESH_MAX_HOP_COUNT);
+  _A7105_Mesh_Set_Packet_Seq(packet, (hop_seq & A7105_MESH_PACKET_V1_SEQ_MASK) >> 4);
+  packet[A7105_MESH_PACKET_FLAGS] = A7105_MESH_PACKET_V1 << 4;
+}
+
+#ifdef A7105_MESH_RX_RING
+byte _A7105_Mesh_RX_Ring_Callback(struct A7105* radio, struct A7105_RX_Frame* frame, void* context)
+{
+  (void)radio;
+#ifndef A7105_MESH_FIXED_PACKET_SIZE
+  struct A7105_Mesh* node = (struct A7105_Mesh*)context;
+
+  if (node->rx_ring_tail_len > 0)
+  {
+    //Anything that finished before the tail could have (the sender waits 
+    //A7105_MESH_TAIL_GAP) is somebody else's, keep listening for the tail
+    if (frame->meta.timestamp - node->rx_ring_head_time < (A7105_MESH_TAIL_GAP - 1) * 1000UL)
+    {
+      frame->tag = A7105_MESH_RX_GAP;
+      return node->rx_ring_tail_len;
+    }
+
+    //This is the tail we were waiting on, back to first frames
+    node->rx_ring_tail_len = 0;
+    frame->tag = A7105_MESH_RX_TAIL;
+    return A7105_MESH_FRAME_SIZE;
+  }
+
+  //First frame of a long packet, the tail shows up A7105_MESH_TAIL_GAP later
+  if (frame->meta.status == A7105_STATUS_OK)
+  {
+    byte length = _A7105_Mesh_Get_Packet_Length(frame->data);
+    if (length > A7105_MESH_FRAME_SIZE)
+    {
+      node->rx_ring_tail_len = length - A7105_MESH_FRAME_SIZE + A7105_MESH_TAIL_TAG_SIZE;
+      node->rx_ring_head_time = frame->meta.timestamp;
+      return node->rx_ring_tail_len;
+    }
+  }
+#else
+  (void)frame;
+  (void)context;
+#endif
+  return A7105_MESH_FRAME_SIZE;
+}
+
+#ifdef A7105_MESH_EARLY_REJECT
+byte _A7105_Mesh_RX_Ring_Filter(struct A7105* radio, struct A7105_RX_Frame* frame, void* context)
+{
+  (void)radio;
+  struct A7105_Mesh* node = (struct A7105_Mesh*)context;
+  byte verdict;
+
+  //The tail of a long packet goes wherever its first frame went
+  if (node->rx_ring_tail_len > 0)
+  {
+    verdict = node->rx_ring_reject_tail ? A7105_RX_RING_DROP : A7105_RX_RING_KEEP;
+  }
+  else
+  {
+    verdict = _A7105_Mesh_Early_Reject(node, frame->data, frame->len);
+    node->rx_ring_reject_tail = (verdict == A7105_RX_RING_DROP);
+  }
+
+  if (verdict == A7105_RX_RING_DROP)
+  {
+    node->rx_ring_rejected = true;
+#ifdef A7105_MESH_STATS
+    byte frame_len = (node->rx_ring_tail_len > 0) ? node->rx_ring_tail_len : A7105_MESH_FRAME_SIZE;
+    node->stat_rx_rejects++;
+    node->stat_rx_reject_bytes += frame_len - frame->len;
+#endif
+  }
+  return verdict;
+}
+
+/*
+  Internal use only, checks the first 'len' bytes of 'packet' against the repeat 
+  cache sans hop count (like _A7105_Mesh_Cache_Packet_For_Repeat() does with the 
+  whole packet). If they're the 'whole' packet the rest of the cached one has
+  to be padding.
+*/
+static byte _A7105_Mesh_Is_Cached_For_Repeat(struct A7105_Mesh* node, byte* packet, byte len, byte whole)
+{
+  //A v1 packet can grow past the end of the cache with the v2 header, what doesn't 
+  //fit has to be padding (see _A7105_Mesh_Process_Packet())
+  for (int y = A7105_MESH_PACKET_SIZE; y < len; y++)
+    if (packet[y] != 0)
+      return false;
+  if (len > A7105_MESH_PACKET_SIZE)
+    len = A7105_MESH_PACKET_SIZE;
+
+  byte type = packet[A7105_MESH_PACKET_TYPE] & A7105_MESH_PACKET_TYPE_MASK;
+  for (int x = 0;x<A7105_MESH_MAX_REPEAT_CACHE_SIZE;x++)
+  {
+    byte* cached = node->repeat_cache[x];
+    if (cached[A7105_MESH_PACKET_TYPE] != type ||
+        _A7105_Mesh_Get_Packet_Seq(cached) != _A7105_Mesh_Get_Packet_Seq(packet))
+      continue;
+
+    int y = A7105_MESH_PACKET_NODE_ID;
+    while (y < len && (cached[y] == packet[y] ||
+                       (y == A7105_MESH_PACKET_FLAGS && (cached[y] ^ packet[y]) == A7105_MESH_PACKET_FLAG_ROUTED)))
+      y++;
+    while (whole && y < A7105_MESH_PACKET_SIZE && cached[y] == 0)
+      y++;
+    if (y == (whole ? A7105_MESH_PACKET_SIZE : len))
+      return true;
+  }
+  return false;
+}
+
+/*
+  Internal use only, how many bytes of 'packet' it takes to read its target node ID 
+  (see _A7105_Mesh_Get_Packet_Target()) when we have the first 'len'.
+*/
+static int _A7105_Mesh_Packet_Target_End(byte* packet, byte len)
+{
+  byte type = packet[A7105_MESH_PACKET_TYPE] & A7105_MESH_PACKET_TYPE_MASK;
+  if ((type == A7105_MESH_PKT_GET_REGISTER || type == A7105_MESH_PKT_SET_REGISTER) &&
+      (packet[A7105_MESH_PACKET_FLAGS] & A7105_MESH_PACKET_FLAG_TARGETED))
+    return _A7105_Mesh_Util_Register_Target_Index(packet, len) + 1;
+  return A7105_MESH_PACKET_TARGET_ID + 1;
+}
+
+/*
+  Internal use only, _A7105_Mesh_Early_Reject() for a packet with a v2 header, 'grown'
+  is how many bytes longer the header is than the one on the air (so we ask for the 
+  right number of bytes).
+*/
+static byte _A7105_Mesh_Early_Reject_V2(struct A7105_Mesh* node, byte* packet, byte len, byte grown)
+{
+  //Everything below needs the header (up to the target ID)
+  if (len < A7105_MESH_PACKET_TARGET_ID)
+    return A7105_MESH_PACKET_TARGET_ID - grown;
+
+  //Joins, ID conflicts and our own packets coming back are left to the handlers
+  if (node->state == A7105_Mesh_NOT_JOINED ||
+      node->state == A7105_Mesh_JOINING ||
+      packet[A7105_MESH_PACKET_NODE_ID] == node->node_id)
+    return A7105_RX_RING_KEEP;
+
+  byte type = packet[A7105_MESH_PACKET_TYPE] & A7105_MESH_PACKET_TYPE_MASK;
+  byte repeat = _A7105_Mesh_Get_Packet_Hop(packet) < _A7105_Mesh_Get_Packet_TTL(packet);
+#ifdef A7105_MESH_ROUTING
+  //(routed packets are all directed, the target ID is right after the header 
+  //or after the register for targeted GET/SET_REGISTERs)
+  if (repeat && (packet[A7105_MESH_PACKET_FLAGS] & A7105_MESH_PACKET_FLAG_ROUTED))
+  {
+    int end = _A7105_Mesh_Packet_Target_End(packet, len);
+    if (end > len)
+      return (end - grown <= A7105_MESH_FRAME_SIZE) ? end - grown : A7105_RX_RING_KEEP;
+    repeat = _A7105_Mesh_Route_Allows_Repeat(node, packet);
+  }
+#endif
+  byte handle = false;
+  byte whole = false; //only the whole packet tells if we've already got it for repeating
+  byte state = A7105_Mesh_NOT_JOINED; //the operation a response answers
+  switch (type)
+  {
+    case A7105_MESH_PKT_PING:
+    case A7105_MESH_PKT_GET_NUM_REGISTERS:
+    case A7105_MESH_PKT_GET_REGISTER_NAME:
+    case A7105_MESH_PKT_GET_REGISTER:
+    case A7105_MESH_PKT_SET_REGISTER:
+      if (_A7105_Mesh_Is_Handled_Request(node, packet))
+      {
+        //We only handle directed requests addressed to us and GET/SET_REGISTERs for 
+        //our registers, we don't repeat those
+        if (type != A7105_MESH_PKT_PING)
+          repeat = false;
+      }
+      else if (type == A7105_MESH_PKT_GET_NUM_REGISTERS ||
+               type == A7105_MESH_PKT_GET_REGISTER_NAME ||
+               (type != A7105_MESH_PKT_PING && (packet[A7105_MESH_PACKET_FLAGS] & A7105_MESH_PACKET_FLAG_TARGETED)))
+      {
+        //Directed requests are only ours if they're addressed to us
+        int end = _A7105_Mesh_Packet_Target_End(packet, len);
+        if (end > len)
+          return (end - grown <= A7105_MESH_FRAME_SIZE) ? end - grown : A7105_RX_RING_KEEP;
+        handle = (packet[end - 1] == node->node_id);
+      }
+      else
+        handle = true;
+
+      //Requesters bump the sequence number for every request, so the header 
+      //is enough to tell if we've already got it for repeating (v1 sequence 
+      //numbers wrap every 16 requests though, those take the whole packet)
+      if (!handle && repeat)
+      {
+        if (grown == 0)
+          repeat = !_A7105_Mesh_Is_Cached_For_Repeat(node, packet, A7105_MESH_PACKET_TARGET_ID, false);
+        else
+          whole = true;
+      }
+      break;
+
+    case A7105_MESH_PKT_PONG:
+      state = A7105_Mesh_PING;
+      break;
+    case A7105_MESH_PKT_NUM_REGISTERS:
+      state = A7105_Mesh_GET_NUM_REGISTERS;
+      break;
+    case A7105_MESH_PKT_REGISTER_NAME:
+      state = A7105_Mesh_GET_REGISTER_NAME;
+      break;
+    case A7105_MESH_PKT_REGISTER_VALUE:
+      state = A7105_Mesh_GET_REGISTER;
+
+      //Broadcasts are for anybody with a broadcast callback
+      if (packet[A7105_MESH_PACKET_NODE_ID] == 0 && node->register_value_broadcast_callback != NULL)
+        return A7105_RX_RING_KEEP;
+      break;
+    case A7105_MESH_PKT_SET_REGISTER_ACK:
+      state = A7105_Mesh_SET_REGISTER;
+      break;
+
+    default:
+      return A7105_RX_RING_KEEP;
+  }
+
+  //Responses are only ours if we're running the operation they answer and they're 
+  //from the node we asked (see _A7105_Mesh_Filter_Packet())
+  if (state != A7105_Mesh_NOT_JOINED)
+  {
+    handle = (node->state == state &&
+              (node->target_node_id == 0 || packet[A7105_MESH_PACKET_NODE_ID] == node->target_node_id));
+
+#ifdef A7105_MESH_REVERSE_PATH
+    //Responses only go back the way their request came (REGISTER_VALUEs 
+    //need the register name read first)
+    if (!handle && repeat)
+    {
+      byte key_end = A7105_MESH_PACKET_TARGET_ID + 1;
+      if (type == A7105_MESH_PKT_REGISTER_VALUE && len > A7105_MESH_PACKET_DATA_START)
+        key_end = A7105_MESH_PACKET_NAME_START + packet[A7105_MESH_PACKET_DATA_START];
+      if (key_end - grown <= A7105_MESH_FRAME_SIZE)
+      {
+        if (len < key_end)
+          return key_end - grown;
+        repeat = _A7105_Mesh_Reverse_Path_Allows_Repeat(node, packet);
+      }
+    }
+#endif
+
+    //Responders don't bump the sequence number
+    whole = true;
+  }
+
+  //Only read the rest if the header matches one we've already got
+  if (whole && !handle && repeat)
+  {
+    byte length = _A7105_Mesh_Get_Packet_Length(packet);
+    if (length > A7105_MESH_FRAME_SIZE ||
+        !_A7105_Mesh_Is_Cached_For_Repeat(node, packet, A7105_MESH_PACKET_TARGET_ID, false))
+      return A7105_RX_RING_KEEP;
+    if (len < length + grown)
+      return length;
+    repeat = !_A7105_Mesh_Is_Cached_For_Repeat(node, packet, length + grown, true);
+  }
+
+  return (handle || repeat) ? A7105_RX_RING_KEEP : A7105_RX_RING_DROP;
+}
+
+byte _A7105_Mesh_Early_Reject(struct A7105_Mesh* node, byte* packet, byte len)
+{
+  //Both header versions start with the type byte and are at least this long
+  if (len < A7105_MESH_PACKET_V1_HEADER_SIZE)
+    return A7105_MESH_PACKET_V1_HEADER_SIZE;
+
+  if (packet[A7105_MESH_PACKET_TYPE] & A7105_MESH_PACKET_TYPE_V2)
+    return _A7105_Mesh_Early_Reject_V2(node, packet, len, 0);
+
+  //v1 packets get looked at with the v2 header they'll have in the packet cache
+  byte expanded[A7105_MESH_FRAME_SIZE + A7105_MESH_PACKET_HEADER_SIZE - A7105_MESH_PACKET_V1_HEADER_SIZE];
+  memcpy(expanded, packet, len);
+  _A7105_Mesh_Expand_V1_Packet(expanded, len);
+  return _A7105_Mesh_Early_Reject_V2(node, expanded, len + A7105_MESH_PACKET_HEADER_SIZE - A7105_MESH_PACKET_V1_HEADER_SIZE,
+                                     A7105_MESH_PACKET_HEADER_SIZE - A7105_MESH_PACKET_V1_HEADER_SIZE);
+}
+#endif
+
+/*
+  Internal use only, takes frames out of the RX ring until node->packet_cache
+  holds a whole packet. Returns its length (0 if we ran out of frames first).
+*/
+static byte _A7105_Mesh_Read_RX_Ring(struct A7105_Mesh* node)
+{
+  struct A7105_RX_Frame* frame;
+  while ((frame = A7105_RX_Ring_Peek(&(node->radio))) != NULL)
+  {
+#ifndef A7105_MESH_FIXED_PACKET_SIZE
+    //Another node's frame in the gap before a tail, we're still waiting on the tail
+    if (frame->tag == A7105_MESH_RX_GAP)
+    {
+      A7105_RX_Ring_Pop(&(node->radio));
+#ifdef A7105_MESH_STATS
+      node->stat_rx_errors++;
+#endif
+      continue;
+    }
+#endif
+
+    byte length = 0;
+    byte tail_len = node->rx_tail_len;
+    (void)tail_len; //(only read for long packets and the stats)
+    node->rx_tail_len = 0;
+
+    if (frame->meta.status != A7105_STATUS_OK)
+    {
+      #ifdef A7105_MESH_DEBUG
+      A7105_Mesh_SerialDump("Error reading packet data (probably a collision)\r\n");
+      #endif
+    }
+#ifndef A7105_MESH_FIXED_PACKET_SIZE
+    else if (frame->tag == A7105_MESH_RX_TAIL)
+    {
+      //Tail frame, put the first frame back in front of it (if we have it and 
+      //the tail's tag says it's the same packet)
+      if (tail_len > 0 && frame->len == tail_len + A7105_MESH_TAIL_TAG_SIZE &&
+          memcmp(frame->data, node->rx_head, A7105_MESH_TAIL_TAG_SIZE) == 0)
+      {
+        memcpy(node->packet_cache, node->rx_head, A7105_MESH_FRAME_SIZE);
+        memcpy(node->packet_cache + A7105_MESH_FRAME_SIZE, frame->data + A7105_MESH_TAIL_TAG_SIZE, tail_len);
+        length = A7105_MESH_FRAME_SIZE + tail_len;
+        tail_len = 0;
+      }
+    }
+#endif
+    else
+    {
+      memcpy(node->packet_cache, frame->data, A7105_MESH_FRAME_SIZE);
+      node->packet_meta = frame->meta;
+      length = _A7105_Mesh_Get_Packet_Length(node->packet_cache);
+#ifndef A7105_MESH_FIXED_PACKET_SIZE
+      //First frame of a long packet, hang on to it until the tail comes out of the ring
+      if (length > A7105_MESH_FRAME_SIZE)
+      {
+        memcpy(node->rx_head, node->packet_cache, A7105_MESH_FRAME_SIZE);
+        node->rx_tail_len = length - A7105_MESH_FRAME_SIZE;
+        node->rx_frame_time = millis();
+        length = 0;
+      }
+#endif
+    }
+    A7105_RX_Ring_Pop(&(node->radio));
+
+#ifdef A7105_MESH_STATS
+    //Bad frames, stray tails and first frames that never got their tail
+    if ((length == 0 && node->rx_tail_len == 0) || tail_len > 0)
+      node->stat_rx_errors++;
+#endif
+
+    if (length > 0)
+      return length;
+  }
+  return 0;
+}
+#endif
+
 void _A7105_Mesh_Handle_RX(struct A7105_Mesh* node)
 {
+#ifdef A7105_MESH_EARLY_REJECT
+  //Packets the WTR interrupt dropped were still traffic (see the repeat timer
+  //HACK in _A7105_Mesh_Process_Packet())
+  if (node->rx_ring_rejected)
+  {
+    node->rx_ring_rejected = false;
+    node->last_repeat_sent_time = A7105_Mesh_Micros();
+  }
+#endif
+
   //TODO: Determine if we need to be more 
   //      careful and bail if we send a packet
   //      (i.e. pollute node->packet_cache with our response)
   
+  //The radio isn't listening while we're still sending
+  //NOTE: With the RX ring, anything that came in before we started sending 
+  //      waits in the ring until we're done. Without it, frames that come in while 
+  //      our packet waits out a CSMA backoff are read into rx_backoff_packet.
+  byte* buffer = node->packet_cache;
+  if (node->tx_pending)
+  {
+#if defined(A7105_MESH_CSMA) && !defined(A7105_MESH_RX_RING)
+    if (node->tx_started || node->rx_backoff_len > 0)
+      return;
+    buffer = node->rx_backoff_packet;
+#else
+    return;
+#endif
+  }
+#if defined(A7105_MESH_CSMA) && !defined(A7105_MESH_RX_RING)
+  //Ours is out, take the packet we set aside (its metadata is already in packet_meta)
+  else if (node->rx_backoff_len > 0)
+  {
+    byte length = node->rx_backoff_len;
+    node->rx_backoff_len = 0;
+    memcpy(node->packet_cache, node->rx_backoff_packet, length);
+    _A7105_Mesh_Process_Packet(node, length);
+    return;
+  }
+#endif
+
+  //Give up on the tail of a long packet if it never showed (it'd be in the ring by now if it had)
+  if (node->rx_tail_len > 0 &&
+      A7105_RX_Ring_Peek(&(node->radio)) == NULL &&
+      millis() - node->rx_frame_time > (unsigned long)(A7105_MESH_TAIL_GAP + 
+                                                       _A7105_Mesh_Packet_Time((A7105_DataRate)(node->radio)._DATA_RATE)))
+  {
+    node->rx_tail_len = 0;
+    _A7105_Mesh_Listen(node);
+#ifdef A7105_MESH_STATS
+    node->stat_rx_errors++;
+#endif
+  }
+
+#ifdef A7105_MESH_RX_RING
+  //The WTR interrupt has been reading frames for us (and the radio is already
+  //listening for the next), work through them until one makes us send
+  if (node->radio._RX_RING != NULL)
+  {
+    byte length;
+    while (!node->tx_pending && (length = _A7105_Mesh_Read_RX_Ring(node)) > 0)
+      _A7105_Mesh_Process_Packet(node, length);
+    return;
+  }
+#endif
+
   A7105_Status_Code rx_status = A7105_CheckRXWaiting(&(node->radio));
   //Bail if there is no packet waiting at the radio
   //HACK: Read below anyway if there are CRC/FEC Data integrity 
@@ -2109,27 +3488,116 @@ void _A7105_Mesh_Handle_RX(struct A7105_Mesh* node)
   if (rx_status == A7105_NO_DATA)
     return; 
 
-  //Fill our packet cache
+  //Fill our packet cache (the tail of a long packet goes after its first frame,
+  //with its tag just in front of that)
   //TODO: Maybe we can pass radio errors back to the calling
   //code at some point?
   byte bogus_read = 0;
-  if ((rx_status = A7105_ReadData(&(node->radio), node->packet_cache,A7105_MESH_PACKET_SIZE)) != A7105_STATUS_OK)
+  byte tail_len = node->rx_tail_len;
+  if ((rx_status = A7105_ReadData(&(node->radio), 
+                                  buffer + (tail_len ? A7105_MESH_FRAME_SIZE - A7105_MESH_TAIL_TAG_SIZE : 0),
+                                  tail_len ? tail_len + A7105_MESH_TAIL_TAG_SIZE : A7105_MESH_FRAME_SIZE,
+                                  tail_len ? NULL : &(node->packet_meta))) != A7105_STATUS_OK)
   {
     #ifdef A7105_MESH_DEBUG
     A7105_Mesh_SerialDump("Error reading packet data (probably a collision)\r\n");
     //Serial.println(rx_status);
     #endif
     bogus_read = 1;
+#ifdef A7105_MESH_STATS
+    node->stat_rx_errors++;
+#endif
+  }
+  node->rx_tail_len = 0;
+
+  byte length = A7105_MESH_FRAME_SIZE + tail_len;
+#ifndef A7105_MESH_FIXED_PACKET_SIZE
+  if (!bogus_read && tail_len == 0)
+  {
+    //First frame, if there's more to this packet, hang on to what we have 
+    //and listen for the tail
+    length = _A7105_Mesh_Get_Packet_Length(buffer);
+    if (length > A7105_MESH_FRAME_SIZE)
+    {
+      memcpy(node->rx_head, buffer, A7105_MESH_FRAME_SIZE);
+      node->rx_tail_len = length - A7105_MESH_FRAME_SIZE;
+      node->rx_frame_time = millis();
+      A7105_Easy_Listen_For_Packets(&(node->radio), node->rx_tail_len + A7105_MESH_TAIL_TAG_SIZE);
+      return;
+    }
+  }
+  else if (!bogus_read)
+  {
+    //Tail frame, put the first frame back in front of it if the tag says it's 
+    //the same packet (otherwise the tail is another node's and we've lost both)
+    if (memcmp(buffer + A7105_MESH_FRAME_SIZE - A7105_MESH_TAIL_TAG_SIZE, 
+               node->rx_head, A7105_MESH_TAIL_TAG_SIZE) != 0)
+    {
+      bogus_read = 1;
+#ifdef A7105_MESH_STATS
+      node->stat_rx_errors++;
+#endif
+    }
+    else
+      memcpy(buffer, node->rx_head, A7105_MESH_FRAME_SIZE);
   }
+#endif
 
   //Strobe the radio back to the RX state (it auto-jumps back to standby)
-  A7105_Easy_Listen_For_Packets(&(node->radio), A7105_MESH_PACKET_SIZE);
+  _A7105_Mesh_Listen(node);
   
   //If we had a read error above (during A7105_ReadData()), bail here now that
   //we're listening again
   if (bogus_read)
     return;
 
+#if defined(A7105_MESH_CSMA) && !defined(A7105_MESH_RX_RING)
+  //Still waiting to send ours, take it once that's out
+  if (buffer != node->packet_cache)
+  {
+    node->rx_backoff_len = length;
+    return;
+  }
+#endif
+
+  _A7105_Mesh_Process_Packet(node, length);
+}
+
+void _A7105_Mesh_Process_Packet(struct A7105_Mesh* node, byte length)
+{
+  //Strip the length/version tags and zero pad the packet like we do for the ones we send
+  byte v1 = !(node->packet_cache[A7105_MESH_PACKET_TYPE] & A7105_MESH_PACKET_TYPE_V2);
+  node->packet_cache[A7105_MESH_PACKET_TYPE] &= A7105_MESH_PACKET_TYPE_MASK;
+  memset(node->packet_cache + length, 0, A7105_MESH_PACKET_SIZE - length);
+#ifdef A7105_MESH_STATS
+  node->stat_rx_packets++;
+#endif
+
+  if (v1)
+  {
+    //v1 packets get the v2 header, unless it'd push their payload off the end (a 
+    //register bigger than A7105_MESH_MAX_REGISTER_ARRAY_SIZE, we couldn't take it anyway)
+    byte grown = A7105_MESH_PACKET_HEADER_SIZE - A7105_MESH_PACKET_V1_HEADER_SIZE;
+    for (byte x = A7105_MESH_PACKET_SIZE - grown; x < A7105_MESH_PACKET_SIZE; x++)
+      if (node->packet_cache[x] != 0)
+        return;
+    _A7105_Mesh_Expand_V1_Packet(node->packet_cache, A7105_MESH_PACKET_SIZE - grown);
+
+#ifdef A7105_MESH_FIXED_PACKET_SIZE
+    //v2 nodes sending v1 headers only use odd sequence numbers, so this one might 
+    //be a v1 node (which needs us to send v1 headers for a while), as long as it's
+    //a packet type v1 nodes send.
+    //NOTE: Real v1 nodes send 64 byte frames, so only single frame builds hear them
+    byte type = node->packet_cache[A7105_MESH_PACKET_TYPE];
+    if (type >= A7105_MESH_PKT_CONFLICT_NAME && type <= A7105_MESH_PKT_SET_REGISTER_ACK &&
+        !(_A7105_Mesh_Get_Packet_Seq(node->packet_cache) & 0x01))
+    {
+      node->v1_peer = 1;
+      node->v1_peer_time = millis();
+    }
+#endif
+  }
+
   #ifdef A7105_MESH_DEBUG
   //DEBUG
   DebugHeader(node);
@@ -2145,7 +3613,7 @@ void _A7105_Mesh_Handle_RX(struct A7105_Mesh* node)
   //HACK: Update the last repeat timers to "now" so we don't 
   //      just spam the mesh with repeats right after we get 
   //      a packet since we haven't "repeated" in a while
-  node->last_repeat_sent_time = millis();
+  node->last_repeat_sent_time = A7105_Mesh_Micros();
 
   //Check for packets bogusly pushed by duplicate node-id's
   if (_A7105_Mesh_Check_For_Node_ID_Conflicts(node))
@@ -2155,6 +3623,11 @@ void _A7105_Mesh_Handle_RX(struct A7105_Mesh* node)
   //relevant any more in light of the received packet)
   _A7105_Mesh_Update_Handled_Packet_Cache(node);
 
+#ifdef A7105_MESH_ROUTING
+  //Note how far away the sender is
+  _A7105_Mesh_Update_Routes(node);
+#endif
+
   //Check for node ID conflicts (all states where we're joined)
   _A7105_Mesh_Handle_Conflict_Name(node);
   
@@ -2223,21 +3696,7 @@ byte _A7105_Mesh_Filter_Packet(struct A7105_Mesh* node,
 
     //If we've seen this packet type from this unique_id with this
     //sequence number, ignore it
-    for (int x = 0;x<A7105_MESH_HANDLED_PACKET_CACHE_LENGTH;x++)
-    {
-      if (node->packet_cache[A7105_MESH_PACKET_TYPE] == node->handled_packet_cache[x][A7105_MESH_HANDLED_PACKET_OP] &&
-          _A7105_Mesh_Get_Packet_Seq(node->packet_cache) == node->handled_packet_cache[x][A7105_MESH_HANDLED_PACKET_SEQ] &&
-           node->handled_packet_cache[x][A7105_MESH_HANDLED_PACKET_UNIQUE_ID] == node->packet_cache[A7105_MESH_PACKET_UNIQUE_ID] && 
-  node->handled_packet_cache[x][A7105_MESH_HANDLED_PACKET_UNIQUE_ID+1] == node->packet_cache[A7105_MESH_PACKET_UNIQUE_ID+1])
-      {
-        return false;
-      }
-
-    }
-    return true;
-
-
-
+    return !_A7105_Mesh_Is_Handled_Request(node, node->packet_cache);
   }
 
   //Filter response packets using the target node/unique id filters
@@ -2260,29 +3719,64 @@ void A7105_Mesh_Set_Node_Registers(struct A7105_Mesh* node,
 
 byte _A7105_Mesh_Get_Packet_Seq(byte* packet)
 {
-  return (packet[A7105_MESH_PACKET_HOP_SEQ] & A7105_MESH_PACKET_SEQ_MASK) >> 4; 
+  return packet[A7105_MESH_PACKET_SEQ]; 
 }
 
 void _A7105_Mesh_Set_Packet_Seq(byte* packet, byte sequence)
 {
-  packet[A7105_MESH_PACKET_HOP_SEQ] = 
-      (packet[A7105_MESH_PACKET_HOP_SEQ] & A7105_MESH_PACKET_HOP_MASK) |
-      ((sequence << 4) & A7105_MESH_PACKET_SEQ_MASK);
-
+  packet[A7105_MESH_PACKET_SEQ] = sequence;
 }
 
 byte _A7105_Mesh_Get_Packet_Hop(byte* packet)
 {
-  return (packet[A7105_MESH_PACKET_HOP_SEQ] & A7105_MESH_PACKET_HOP_MASK); 
+  return (packet[A7105_MESH_PACKET_HOP_TTL] & A7105_MESH_PACKET_HOP_MASK); 
 }
 
 void _A7105_Mesh_Set_Packet_Hop(byte* packet, byte hop)
 {
-  packet[A7105_MESH_PACKET_HOP_SEQ] = 
-      (packet[A7105_MESH_PACKET_HOP_SEQ] & A7105_MESH_PACKET_SEQ_MASK) |
+  packet[A7105_MESH_PACKET_HOP_TTL] = 
+      (packet[A7105_MESH_PACKET_HOP_TTL] & A7105_MESH_PACKET_TTL_MASK) |
       (hop & A7105_MESH_PACKET_HOP_MASK);
 }
 
+byte _A7105_Mesh_Get_Packet_TTL(byte* packet)
+{
+  return (packet[A7105_MESH_PACKET_HOP_TTL] & A7105_MESH_PACKET_TTL_MASK) >> 4; 
+}
+
+void _A7105_Mesh_Set_Packet_TTL(byte* packet, byte ttl)
+{
+  packet[A7105_MESH_PACKET_HOP_TTL] = 
+      (packet[A7105_MESH_PACKET_HOP_TTL] & A7105_MESH_PACKET_HOP_MASK) |
+      ((ttl << 4) & A7105_MESH_PACKET_TTL_MASK);
+}
+
+byte _A7105_Mesh_Get_Packet_Version(byte* packet)
+{
+  return (packet[A7105_MESH_PACKET_FLAGS] & A7105_MESH_PACKET_VERSION_MASK) >> 4; 
+}
+
+byte _A7105_Mesh_Get_Packet_Target(byte* packet)
+{
+  switch (packet[A7105_MESH_PACKET_TYPE] & A7105_MESH_PACKET_TYPE_MASK)
+  {
+    case A7105_MESH_PKT_GET_NUM_REGISTERS:
+    case A7105_MESH_PKT_GET_REGISTER_NAME:
+    case A7105_MESH_PKT_SET_REGISTER_ACK:
+      return packet[A7105_MESH_PACKET_TARGET_ID];
+    case A7105_MESH_PKT_GET_REGISTER:
+    case A7105_MESH_PKT_SET_REGISTER:
+      if (packet[A7105_MESH_PACKET_FLAGS] & A7105_MESH_PACKET_FLAG_TARGETED)
+      {
+        int index = _A7105_Mesh_Util_Register_Target_Index(packet, A7105_MESH_PACKET_SIZE);
+        if (index < A7105_MESH_PACKET_SIZE)
+          return packet[index];
+      }
+      break;
+  }
+  return 0;
+}
+
 
 
 byte _A7105_Bit_out(int analogPin)
@@ -41,29 +41,171 @@ POSSIBILITY OF SUCH DAMAGE.
 //NOTE: This must be a multiple of 8 and at least 16 bytes (so 16, 32 or 64)
 #define A7105_MESH_PACKET_SIZE 64
 
+//The radio's FIFO only holds one frame, so frames used to be lost whenever they showed up
+//faster than A7105_Mesh_Update() was called. With an RX ring (see A7105_RX_Ring_Begin()) 
+//the WTR interrupt copies each frame out and re-arms RX right away, A7105_Mesh_Update() 
+//works through the ring. Each slot costs A7105_RX_RING_FRAME_SIZE + 9 bytes of RAM.
+//Uncomment to read the FIFO from A7105_Mesh_Update() like older versions of this library
+//(this also sets A7105_MESH_FIXED_PACKET_SIZE, below).
+//#define A7105_MESH_DISABLE_RX_RING
+#ifndef A7105_MESH_DISABLE_RX_RING
+#define A7105_MESH_RX_RING
+#endif
+#define A7105_MESH_RX_RING_SIZE 3
+#define A7105_MESH_RX_TAIL 1 //RX ring tag for the tail frame of a long packet
+#define A7105_MESH_RX_GAP 2 //RX ring tag for another node's frame that showed up before the tail could have
+
+//Uncomment to send every packet as a single A7105_MESH_PACKET_SIZE frame (the original
+//packet format). Every node on a mesh has to use the same format: this is needed to talk
+//to nodes running older versions of this library, and to nodes without the RX ring.
+//#define A7105_MESH_FIXED_PACKET_SIZE
+
+//Without the RX ring a receiver only gets the tail of a long packet if its 
+//A7105_Mesh_Update() reads the first frame within A7105_MESH_TAIL_GAP, so those 
+//builds always send single frames
+#if !defined(A7105_MESH_RX_RING) && !defined(A7105_MESH_FIXED_PACKET_SIZE)
+#define A7105_MESH_FIXED_PACKET_SIZE
+#endif
+
+//Packets are sent as a 16 byte first frame (all the control packets fit in this) followed,
+//if the packet needs more room, by a tail frame of 16 or 48 bytes. The length is carried
+//in the packet type byte of the first frame so receivers can re-arm for the tail.
+#ifdef A7105_MESH_FIXED_PACKET_SIZE
+#define A7105_MESH_FRAME_SIZE A7105_MESH_PACKET_SIZE
+#else
+#define A7105_MESH_FRAME_SIZE 16
+#endif
+
+//Most pieces a packet gets sent from (see _A7105_Mesh_Start_Register_Value_TX()), plus 
+//one for a v1 header, one for the tail tag and the end marker
+#define A7105_MESH_TX_SEGMENTS 7
+
+//Time (milliseconds) between the first frame and the tail of a long packet so receivers
+//can re-arm for it (the RX ring does that from the WTR interrupt)
+#define A7105_MESH_TAIL_GAP 5
+
+//The tail frame starts with a copy of the first this many bytes of its first frame, so a
+//receiver doesn't join a tail onto the first frame of another node's packet (FIFO lengths
+//go in steps of 8, see A7105_Easy_Listen_For_Packets()).
+#define A7105_MESH_TAIL_TAG_SIZE 8
+
+//With the RX ring, the WTR interrupt screens each frame from its header before reading the 
+//rest of the FIFO (CRC flag, then type/hop/seq/sender, then the target ID of directed requests).
+//Requests we've already handled and forwarded (handled packet cache/repeat cache) and responses 
+//we aren't waiting on and won't forward are dropped there, so they never cost the rest of the 
+//SPI read, a ring slot or a trip through the packet handlers. Uncomment to handle every frame.
+//#define A7105_MESH_DISABLE_EARLY_REJECT
+#if defined(A7105_MESH_RX_RING) && !defined(A7105_MESH_DISABLE_EARLY_REJECT)
+#define A7105_MESH_EARLY_REJECT
+#endif
+
+//Uncomment to keep airtime/collision counters in struct A7105_Mesh (see the stat_* members)
+//#define A7105_MESH_STATS
+
+//Carrier sense (listen-before-talk): before each packet we check the channel with 
+//A7105_Check_Channel_Clear() and, if someone else is talking, back off a random time
+//of 1 to 2^n slots (one 16 byte frame time each), doubling the window each time. After 
+//A7105_MESH_CSMA_MAX_BACKOFFS tries we send anyway (the repeaters cover the rest).
+//Uncomment to send blindly like older versions of this library.
+//#define A7105_MESH_DISABLE_CSMA
+#ifndef A7105_MESH_DISABLE_CSMA
+#define A7105_MESH_CSMA
+#endif
+#define A7105_MESH_CSMA_MAX_BACKOFFS 4
+
+//Backoff and repeat timing runs off a microsecond clock (see A7105_Mesh_Micros()) so random 
+//delays land in far more distinct slots than whole milliseconds give us (a 64 byte packet
+//is only 4ms at 250Kbps). On AVRs this is Timer1 (0.5us ticks at 16MHz) which means
+//analogWrite() on the Timer1 pins (9 and 10 on a 328P) won't work. Uncomment to use 
+//micros() (4us resolution) instead if your sketch needs Timer1 (i.e. the Servo library).
+//#define A7105_MESH_DISABLE_TIMER1
+#if defined(__AVR__) && defined(TCCR1A) && !defined(A7105_MESH_DISABLE_TIMER1) && (F_CPU % 8000000UL) == 0
+#define A7105_MESH_TIMER1
+#define A7105_MESH_TIMER1_TICKS_PER_US (F_CPU / 8000000UL) //Timer1 runs at F_CPU/8
+#endif
+#define A7105_MESH_CSMA_RSSI_THOLD A7105_DEFAULT_RSSI_THOLD //see A7105_Set_RSSI_Threshold()
+
 //Total available length for register name + value in a packet 
-#define A7105_MESH_MAX_REGISTER_ARRAY_SIZE A7105_MESH_PACKET_SIZE - 7 //64 bytes - 7 needed for headers and sizes
+#define A7105_MESH_MAX_REGISTER_ARRAY_SIZE A7105_MESH_PACKET_SIZE - 9 //64 bytes - 9 needed for headers and sizes
 #define A7105_MESH_MAX_REGISTER_PART_SIZE  A7105_MESH_MAX_REGISTER_ARRAY_SIZE - 2 //minimum size is max - 2 (one content byte and one length)
 
 //Maximum number of packets to cache for repeating 
 //(kept small to prevent using too much RAM)
 #define A7105_MESH_MAX_REPEAT_CACHE_SIZE 2
 
-//Maximum number of packet header/sequence/unique sets 
-//to keep for avoiding reacting to previously seen (and reacted-to) packets
-//IMPORTANT: if this ever goes above 16, make the sequence number a whole byte!
-
-#define A7105_MESH_HANDLED_PACKET_CACHE_LENGTH 8 
-
-//if we see a packet with a sequence number 3 or less below the 
-//one in the cache, we can "expire" that cache item so we don't 
-//ignore legitimate packets that have occurred since the sequence 
-//number rolled over
-#define A7105_MESH_HANDLED_PACKET_CACHE_SEQ_EXPIRE 3 
+//Number of senders (by unique ID) the handled request table tracks for avoiding reacting 
+//to previously seen (and reacted-to) requests. Each sender gets a window over its last 16 
+//sequence numbers, so this should be about the number of nodes sending requests while the
+//repeats of one are still coming back (32 covers repeats 12 requests late from any number
+//of nodes in emulator/handled_bench). Senders are found by hashing their unique ID (at most 
+//A7105_MESH_HANDLED_PROBES slots are looked at), past this many the one we handled a request 
+//for longest ago is forgotten. Must be a power of 2 (7 bytes of RAM each).
+#ifndef A7105_MESH_HANDLED_SENDERS
+#define A7105_MESH_HANDLED_SENDERS 32
+#endif
+#define A7105_MESH_HANDLED_PROBES 8
 
-//Maximum number of times a packet can be repeated on the mesh
+//Maximum number of times a packet can be repeated on the mesh (the TTL we send with,
+//and the one v1 packets get)
 #define A7105_MESH_MAX_HOP_COUNT 6
 
+//We send v2 headers (8 bit sequence numbers, see a7105_mesh_packet.h) unless we've heard 
+//a v1 node in this long (milliseconds), then we send v1 headers so it understands us.
+//v2 nodes sending v1 headers only use odd sequence numbers, so a v1 packet with an even 
+//one is from a real v1 node. NOTE: Only builds with A7105_MESH_FIXED_PACKET_SIZE can hear
+//v1 nodes (they send 64 byte frames), other builds always send v2 headers. A v1 node's
+//packets with odd sequence numbers aren't noticed, so we can start sending v1 headers a
+//request late, and a v1 node that only ever answers requests after sending an odd number
+//of its own won't be noticed at all.
+#define A7105_MESH_V1_PEER_TIMEOUT 600000UL
+
+//Directed packets (GET_NUM_REGISTERS/GET_REGISTER_NAME requests and SET_REGISTER_ACKs) to a node 
+//we know the distance to are sent with a TTL that just reaches it and flagged as routed, and 
+//repeaters only pass them on if they're no farther from the target than the packet has hops left. 
+//Repeaters send packets on as they got them, so rather than a next hop every packet we hear tells 
+//us how far its sender is (its hop count + 1). We keep the closest we've heard for this many
+//nodes (6 bytes of RAM each), forgetting one after A7105_MESH_ROUTE_TIMEOUT (milliseconds) 
+//without hearing it that close or when a request routed to it times out (so the next one floods). 
+//A7105_MESH_ROUTE_SLACK extra hops let a packet take a slightly longer way around. Nodes that 
+//don't know the target repeat routed packets like any other. Uncomment to flood everything.
+//#define A7105_MESH_DISABLE_ROUTING
+#ifndef A7105_MESH_DISABLE_ROUTING
+#define A7105_MESH_ROUTING
+#endif
+#ifndef A7105_MESH_ROUTES
+#define A7105_MESH_ROUTES 8
+#endif
+#define A7105_MESH_ROUTE_TIMEOUT 30000UL
+#define A7105_MESH_ROUTE_SLACK 0
+
+//Responses to the requests we know the responder for (NUM_REGISTERS, REGISTER_NAME, REGISTER_VALUE
+//and SET_REGISTER_ACK, not PONGs or value broadcasts) are only repeated by nodes that repeated the
+//request they answer, so they go back the way the request came instead of flooding the mesh. 
+//Each node remembers the last this many requests it repeated (9 bytes of RAM each) for 
+//A7105_MESH_REVERSE_PATH_TIMEOUT (milliseconds). Uncomment to repeat every response.
+//#define A7105_MESH_DISABLE_REVERSE_PATH
+#ifndef A7105_MESH_DISABLE_REVERSE_PATH
+#define A7105_MESH_REVERSE_PATH
+#endif
+#ifndef A7105_MESH_REVERSE_PATHS
+#define A7105_MESH_REVERSE_PATHS 4
+#endif
+#define A7105_MESH_REVERSE_PATH_TIMEOUT A7105_MESH_REQUEST_TIMEOUT
+
+//GET_REGISTER/SET_REGISTER for a register that's answered us before are sent to the node that
+//has it (its node ID goes after the register in the packet) with a TTL that just reaches it,
+//instead of asking the whole mesh. Only that node looks at the register name or answers and it 
+//doesn't repeat them. If one times out we forget where the register is and ask the whole mesh 
+//before giving up. This many registers are remembered (by a hash of the name, 7 bytes of RAM
+//each), the one we asked for least recently is forgotten. Uncomment to always ask the whole mesh.
+//#define A7105_MESH_DISABLE_LOCATE_REGISTERS
+#ifndef A7105_MESH_DISABLE_LOCATE_REGISTERS
+#define A7105_MESH_LOCATE_REGISTERS
+#endif
+#ifndef A7105_MESH_REGISTER_LOCATIONS
+#define A7105_MESH_REGISTER_LOCATIONS 4
+#endif
+
 /////////Join process constants (milliseconds)///////////
 
 #define A7105_MESH_JOIN_ACCEPT_DELAY 5000 //Time from sending the first JOIN packet to believing we're OK to join
@@ -237,21 +379,115 @@ int A7105_Mesh_Util_RegisterNameCmp(struct A7105_Mesh_Register* a, struct A7105_
 
 void A7105_Mesh_Register_Copy(struct A7105_Mesh_Register* dest, struct A7105_Mesh_Register* src);
 
+/*
+  One sender's window in the handled request table (see A7105_MESH_HANDLED_SENDERS)
+*/
+struct A7105_Mesh_Handled_Sender
+{
+  uint16_t unique_id;
+  uint16_t seq_mask; //bit n is set if we handled the request with sequence number newest_seq - n
+  byte newest_seq; //most recent sequence number we've seen from this sender
+  byte version; //header version of the sender's packets (4 bit sequence numbers in v1, 8 bit in v2)
+  byte last_used; //handled_clock when we last handled a request from this sender
+};
+
+/*
+  How far away a node is (see A7105_MESH_ROUTES)
+*/
+struct A7105_Mesh_Route
+{
+  byte node_id; //0 if the entry is free
+  byte hops; //fewest hops we've heard the node's packets take to get to us (1 = in range)
+  unsigned long heard_time; //millis() when we last heard it that close
+};
+
+/*
+  A request we repeated, so we repeat its response (see A7105_MESH_REVERSE_PATHS)
+*/
+struct A7105_Mesh_Reverse_Path
+{
+  uint16_t unique_id; //the requester's
+  byte seq; //the request's sequence number
+  byte type; //packet type of the response (0 if the entry is free)
+  byte key; //picks out the response (see _A7105_Mesh_Reverse_Path_Key())
+  unsigned long time; //millis() when we repeated the request
+};
+
+/*
+  Where a register we've asked for lives (see A7105_MESH_REGISTER_LOCATIONS)
+*/
+struct A7105_Mesh_Register_Location
+{
+  uint16_t name_hash; //of the register name (see _A7105_Mesh_Util_Packet_Name_Hash())
+  uint16_t unique_id; //of the node that answered for it
+  byte node_id; //0 if the entry is free
+  byte hops; //how far away it answered from
+  byte last_used; //register_location_clock when we last asked for it
+};
+
 struct A7105_Mesh
 {
   struct A7105 radio;
   A7105_Mesh_State state; //track what we're doing  
+  byte tx_pending; //1 while a packet we pushed is still going out over the air (RX is re-armed once it's done)
+  byte tx_started; //0 while the packet is waiting on a clear channel (carrier sense), 1 once it's on the radio
+  struct A7105_TX_Segment tx_segments[A7105_MESH_TX_SEGMENTS]; //the pieces of the packet we're sending
+  byte tx_value_len; //register value length byte for a REGISTER_VALUE sent straight from the Register
+  byte tx_v1_header[A7105_MESH_PACKET_V1_HEADER_SIZE]; //header a v1 packet goes out with (see _A7105_Mesh_Start_TX())
+#ifdef A7105_MESH_CSMA
+  byte csma_backoffs; //times we've backed off for the current packet
+  unsigned long csma_backoff_time; //microseconds to wait (from csma_backoff_start) before checking the channel again
+  unsigned long csma_backoff_start; //A7105_Mesh_Micros() when we backed off
+#endif
+  byte tx_frame_done; //1 once the current frame is out (we're waiting A7105_MESH_TAIL_GAP to send the tail)
+  byte tx_tail_len; //bytes left to send in the tail frame of a long packet (0 if none)
+  struct A7105_TX_Segment* tx_tail; //where the tail comes from (the rest of tx_segments)
+#ifndef A7105_MESH_FIXED_PACKET_SIZE
+  byte tx_tail_tag[A7105_MESH_TAIL_TAG_SIZE]; //start of the first frame, sent again in front of the tail
+#endif
+  unsigned long tx_frame_time; //when the first frame of a long packet finished sending
+  byte rx_tail_len; //length of the tail frame we're listening for (0 if we're listening for first frames)
+  unsigned long rx_frame_time; //when we got the first frame of that packet
+#ifndef A7105_MESH_FIXED_PACKET_SIZE
+  byte rx_head[A7105_MESH_FRAME_SIZE]; //first frame of a long packet while we wait on its tail
+#endif
+#if defined(A7105_MESH_CSMA) && !defined(A7105_MESH_RX_RING)
+  byte rx_backoff_packet[A7105_MESH_PACKET_SIZE]; //packet that came in while ours waited out a backoff (packet_cache holds ours)
+  byte rx_backoff_len; //its length (0 if none)
+#endif
+#ifdef A7105_MESH_RX_RING
+  struct A7105_RX_Frame rx_ring[A7105_MESH_RX_RING_SIZE]; //frames the WTR interrupt has read for us
+  volatile byte rx_ring_tail_len; //tail frame length (tag included) the WTR interrupt has the radio listening for (0 for first frames)
+  volatile unsigned long rx_ring_head_time; //when the first frame of that packet arrived (see struct A7105_RX_Metadata)
+#endif
+#ifdef A7105_MESH_EARLY_REJECT
+  volatile byte rx_ring_reject_tail; //the WTR interrupt dropped the first frame of the packet whose tail is coming
+  volatile byte rx_ring_rejected; //the WTR interrupt dropped a packet since the last A7105_Mesh_Update()
+#endif
+
+#ifdef A7105_MESH_STATS
+  uint16_t stat_tx_packets; //packets we've sent
+  uint16_t stat_tx_frames; //frames those took (each costs a preamble, ID and CRC on the air)
+  uint32_t stat_tx_bytes; //frame payload bytes we've sent
+  uint16_t stat_rx_packets; //whole packets we've received
+  uint16_t stat_rx_errors; //frames that failed CRC/FEC or tails that never showed up (mostly collisions)
+  uint16_t stat_tx_backoffs; //times carrier sense found the channel busy and deferred a packet
+  uint16_t stat_rx_rejects; //frames dropped from their header (see A7105_MESH_EARLY_REJECT)
+  uint32_t stat_rx_reject_bytes; //FIFO bytes those frames didn't need read
+#endif
 
   uint16_t unique_id; //unique id salt for this node (generated at init-time)
   byte node_id;
   
-  uint16_t random_delay; //used for repeating operations
+  unsigned long random_delay; //used for repeating operations (microseconds)
   
   struct A7105_Mesh_Register* registers; //registers we serve
   byte num_registers; //number of registers
 
   //////// Request Tracking //////////
   byte packet_cache[A7105_MESH_PACKET_SIZE];
+  struct A7105_RX_Metadata packet_meta; //RSSI, arrival time and CRC/FEC status of the last packet received 
+                                        //into packet_cache (for long packets, of its first frame)
   unsigned long request_sent_time;
   byte target_node_id;
   uint16_t target_unique_id;
@@ -260,9 +496,11 @@ struct A7105_Mesh
   //////// Response Tracking /////////
   //byte last_request_handled[A7105_MESH_PACKET_SIZE];
   //unsigned long last_request_handled_time;
-  byte handled_packet_cache[A7105_MESH_HANDLED_PACKET_CACHE_LENGTH][A7105_MESH_HANDLED_PACKET_HEADER_SIZE];
-  byte last_handled_packet_index;
+  struct A7105_Mesh_Handled_Sender handled_senders[A7105_MESH_HANDLED_SENDERS]; //handled request table
+  byte handled_clock; //ticks for every request handled (for picking a sender to forget)
   byte sequence_num; //Send by requestors to identify their packets
+  byte v1_peer; //1 if we've heard a v1 node (at v1_peer_time) and are sending v1 headers for it
+  unsigned long v1_peer_time;
 
   //////// Join State Tracking ////////
   unsigned long join_first_tx_time;
@@ -271,12 +509,20 @@ struct A7105_Mesh
   /////// Presence Table /////////
   byte presence_table[32]; //bit mask for mesh node-id state
 
+  /////// Route Table /////////
+#ifdef A7105_MESH_ROUTING
+  struct A7105_Mesh_Route routes[A7105_MESH_ROUTES]; //how far away the nodes we've heard are
+#endif
+
   ////// Repeater State Tracking ///////
   byte repeat_cache[A7105_MESH_MAX_REPEAT_CACHE_SIZE][A7105_MESH_PACKET_SIZE];  
   byte repeat_cache_start;
   byte repeat_cache_end;
   byte repeat_cache_size;
-  unsigned long last_repeat_sent_time;
+  unsigned long last_repeat_sent_time; //A7105_Mesh_Micros() timestamp
+#ifdef A7105_MESH_REVERSE_PATH
+  struct A7105_Mesh_Reverse_Path reverse_paths[A7105_MESH_REVERSE_PATHS]; //requests we repeated
+#endif
 
   ///// Client Data Storage Cache //////
   void* client_context_obj; 
@@ -284,6 +530,10 @@ struct A7105_Mesh
   A7105_Mesh_Register register_cache; //HACK: used as cache for GET_REGISTER/SET_REGISTER requests
   byte responder_node_id; 
   uint16_t responder_unique_id; 
+#ifdef A7105_MESH_LOCATE_REGISTERS
+  struct A7105_Mesh_Register_Location register_locations[A7105_MESH_REGISTER_LOCATIONS]; //who answered for registers
+  byte register_location_clock; //ticks for every GET/SET_REGISTER (for picking a register to forget)
+#endif
   void (*operation_callback)(struct A7105_Mesh*,A7105_Mesh_Status,void*);
   A7105_Mesh_Status blocking_operation_status; //Used to store the return status during blocking interface usage
 
@@ -310,7 +560,7 @@ struct A7105_Mesh
 
 
   ///// Request Repeating State ///// (repeats request packets a few times to overcome packet collision/loss)
-  unsigned long last_request_repeat_sent_time;
+  unsigned long last_request_repeat_sent_time; //A7105_Mesh_Micros() timestamp
   byte request_repeat_count;
 
   ///// Response Repeating State ///// (repeats responses directed to us a few times to overcome packet collision/loss)
@@ -328,7 +578,7 @@ struct A7105_Mesh
   byte response_repeat_cache_start;
   byte response_repeat_cache_end;
   byte response_repeat_cache_size;
-  unsigned long last_response_repeat_sent_time;
+  unsigned long last_response_repeat_sent_time; //A7105_Mesh_Micros() timestamp
  };
 
 
@@ -658,6 +908,16 @@ A7105_Mesh_Status A7105_Mesh_Broadcast(struct A7105_Mesh* node, struct A7105_Mes
 */
 byte A7105_Get_Next_Present_Node(struct A7105_Mesh* node, byte start);
 
+/*
+  A7105_Mesh_Get_Header_Version:
+    * node: An initialized struct A7105_Mesh node
+
+    Returns: The packet header version 'node' is sending, A7105_MESH_PACKET_V2 or 
+             A7105_MESH_PACKET_V1 while there are v1 nodes about (see A7105_MESH_V1_PEER_TIMEOUT,
+             always A7105_MESH_PACKET_V2 without A7105_MESH_FIXED_PACKET_SIZE).
+*/
+byte A7105_Mesh_Get_Header_Version(struct A7105_Mesh* node);
+
 /*
   _A7105_Mesh_Is_Node_Idle:
     * node: a node structure (intiailized)
@@ -669,6 +929,28 @@ byte A7105_Get_Next_Present_Node(struct A7105_Mesh* node, byte start);
 */
 A7105_Mesh_Status _A7105_Mesh_Is_Node_Idle(struct A7105_Mesh* node);
 
+/*
+  void _A7105_Mesh_Update_TX:
+    * node: An initialized struct A7105_Mesh node
+
+    This internal function checks on a packet that was pushed to the 
+    radio (node->tx_pending). It sends the first frame once the channel
+    is clear (A7105_MESH_CSMA), the tail (if any) after that and, once
+    the radio is done sending it, clears tx_pending and strobes the radio 
+    back to RX. It doesn't block, so it's called at the top of every 
+    A7105_Mesh_Update().
+*/
+void _A7105_Mesh_Update_TX(struct A7105_Mesh* node);
+
+/*
+  void _A7105_Mesh_Wait_TX:
+    * node: An initialized struct A7105_Mesh node
+
+    This internal function blocks until any packet in the air has finished
+    sending (used before pushing another packet to the radio).
+*/
+void _A7105_Mesh_Wait_TX(struct A7105_Mesh* node);
+
 /*
   void _A7105_Mesh_Update_Repeats:
     * node: An initialized struct A7105_Mesh node
@@ -713,7 +995,8 @@ void _A7105_Mesh_Update_Request_Repeats(struct A7105_Mesh* node);
 void _A7105_Mesh_Cache_Packet_For_Repeat(struct A7105_Mesh* node);
 
 //Appends node->packet_cache details into the response repeater cache
-void _A7105_Mesh_Append_Response_Repeat(struct A7105_Mesh* node);
+//(register_index is the register for REGISTER_NAME/VALUE packets, -1 to look it up from the packet)
+void _A7105_Mesh_Append_Response_Repeat(struct A7105_Mesh* node, int register_index);
 
 //Removes the first (oldest) response repeater cache item 
 byte* _A7105_Mesh_Pop_Response_Repeat(struct A7105_Mesh* node);
@@ -723,13 +1006,91 @@ byte* _A7105_Mesh_Pop_Response_Repeat(struct A7105_Mesh* node);
 //but ignores the hop-count
 byte _A7105_Mesh_Util_Is_Same_Packet_Sans_Hop(byte* a, byte* b);
 
+/*
+  void _A7105_Mesh_Start_TX:
+    * node: An initialized struct A7105_Mesh node
+    * packet: The (zero padded) A7105_MESH_PACKET_SIZE packet to send
+
+    This internal function queues 'packet' for sending and sets node->tx_pending.
+    If the channel is clear (or A7105_MESH_CSMA is off) the first frame (tagged 
+    with its length) is pushed to the radio right away, otherwise 
+    _A7105_Mesh_Update_TX() backs off and sends it later. _A7105_Mesh_Update_TX()
+    also sends the tail frame (if any) and puts the radio back in RX when it's done.
+
+    Side-Effects/Notes:
+      * The tail is sent straight from 'packet', so it must not change until
+        tx_pending clears (_A7105_Mesh_Prep_Packet_Header() waits for this).
+*/
+void _A7105_Mesh_Start_TX(struct A7105_Mesh* node, byte* packet);
+
+/*
+  byte _A7105_Mesh_Start_Register_Value_TX:
+    * node: An initialized struct A7105_Mesh node
+    * reg: The Register to send
+
+    Same as _A7105_Mesh_Start_TX() for a REGISTER_VALUE packet, but only the 
+    header is taken from node->packet_cache (see _A7105_Mesh_Prep_Packet_Header()).
+    The name and value are streamed into the radio FIFO straight from 'reg' 
+    (see A7105_WriteData_Gather()) instead of being copied into the packet first.
+
+    Side-Effects/Notes:
+      * 'reg' must not change until tx_pending clears.
+      * node->packet_cache only holds the header (and name length) afterwards.
+
+    Returns: false (and sends nothing) if 'reg' has bogus lengths, true otherwise
+*/
+byte _A7105_Mesh_Start_Register_Value_TX(struct A7105_Mesh* node,
+                                         struct A7105_Mesh_Register* reg);
+
+//Pushes the first frame of node->tx_segments to the radio (tagged with its length)
+//and sets up the tail (see _A7105_Mesh_Start_TX())
+void _A7105_Mesh_Send_First_Frame(struct A7105_Mesh* node);
+
+/*
+  byte _A7105_Mesh_Calculate_Packet_Length:
+    * segments: The pieces of the packet (see struct A7105_TX_Segment), anything
+                past A7105_MESH_PACKET_SIZE is ignored
+
+    Returns the smallest legal packet length (16, 32 or 64) that holds 
+    everything (other than trailing zeros) in 'segments' (A7105_MESH_PACKET_SIZE 
+    with A7105_MESH_FIXED_PACKET_SIZE).
+*/
+byte _A7105_Mesh_Calculate_Packet_Length(struct A7105_TX_Segment* segments);
+
+/*
+  byte _A7105_Mesh_Get_Packet_Length:
+    * frame: The first frame of a packet as it came off the air
+
+    Returns the packet length carried in the packet type byte.
+*/
+byte _A7105_Mesh_Get_Packet_Length(byte* frame);
+
+//Returns the time (milliseconds) it takes to send a full 64 byte packet at 'data_rate'
+uint16_t _A7105_Mesh_Packet_Time(A7105_DataRate data_rate);
+
+//Returns a random delay (microseconds) of 2-41 packet times at 'data_rate' used to 
+//space out repeats from different nodes
+unsigned long _A7105_Mesh_Calculate_Random_Delay(A7105_DataRate data_rate);
+
+/*
+  unsigned long A7105_Mesh_Micros:
+    Returns the microseconds since the first A7105_Mesh_Initialize() from the mesh's
+    backoff/repeat clock (Timer1 if A7105_MESH_TIMER1 is set, otherwise micros()).
+    Like micros(), it wraps around after ~71 minutes so only compare differences.
+*/
+unsigned long A7105_Mesh_Micros();
+
+//Starts the Timer1 clock behind A7105_Mesh_Micros() (called by A7105_Mesh_Initialize())
+void _A7105_Mesh_Timer_Begin();
+
 /*
   void _A7105_Mesh_Prep_Packet_Header:
     * node: An initialized struct A7105_Mesh node
     * packet_type: The packet type to populate
 
     This internal function is used to prep a node's packet-cache 
-    with identifying information.
+    with identifying information. If we're still sending a packet, this
+    blocks until it's out (so we don't clobber its tail).
 */
 void _A7105_Mesh_Prep_Packet_Header(struct A7105_Mesh* node,
                                     byte packet_type);
@@ -747,8 +1108,10 @@ void _A7105_Mesh_Prep_Packet_Header(struct A7105_Mesh* node,
       * All the pending_* members are populated for this request (as 
         long as it isn't a JOIN, since that's the only interrupting
         operation).
-      * The function blocks until the data is done writing at the radio
-        and sends the STROBE command to listen again.
+      * If a previous packet is still going out over the air, this blocks
+        until it's done. Otherwise it only waits for the packet to be loaded
+        into the radio FIFO; A7105_Mesh_Update() puts the radio back in RX
+        once the TX finishes (see _A7105_Mesh_Update_TX()).
       * The sequence number for the node is incremented for the call
         to aid receivers in filtering seen packets
 */
@@ -788,6 +1151,15 @@ byte _A7105_Mesh_Util_Get_Register_Index(byte* packet);
 //Sets the register index of a REGISTER_NAME packet
 byte _A7105_Mesh_Util_Set_Register_Index(byte* packet, byte index);
 
+//Hash of the register name in a GET_REGISTER, SET_REGISTER or REGISTER_VALUE packet
+uint16_t _A7105_Mesh_Util_Packet_Name_Hash(byte* packet);
+
+//Index of the target node ID in a GET_REGISTER/SET_REGISTER packet (right after the 
+//register, see A7105_MESH_PACKET_FLAG_TARGETED). If the first 'len' bytes don't go that
+//far, returns the index of the length byte that needs reading first (at least 'len').
+//A7105_MESH_PACKET_SIZE or more if it's past the end of the packet.
+int _A7105_Mesh_Util_Register_Target_Index(byte* packet, byte len);
+
 //NOTE: if include_value = true, include name is assumed true also
 //Returns true on success, false for bogus values.
 byte _A7105_Mesh_Util_Packet_To_Register(byte* packet,
@@ -821,14 +1193,123 @@ void _A7105_Mesh_Handling_Request(struct A7105_Mesh* node,
   _A7105_Mesh_Update_Handled_Packet_Cache(struct A7105_Mesh* node):
     * node: An initialized struct A7105_Mesh node
 
-    This internal function updatse the node state to expire any packets
-    in the handled packet cache that have a sequence number that has been
-    determined to be likely seen again soon (so we don't accidentially filter
-    packets that are legitimate new requests with the same sequence number as
-    old ones).
+    This internal function updatse the node state to slide the sender's window
+    in the handled request table forward to the packet's sequence number (so
+    requests we handled before fall out of it before the sequence number gets 
+    back around to them). Only a packet that moves its sender's sequence number 
+    forward moves the window, late repeats of older packets don't.
 */
 void _A7105_Mesh_Update_Handled_Packet_Cache(struct A7105_Mesh* node);
 
+#ifdef A7105_MESH_ROUTING
+/*
+  _A7105_Mesh_Update_Routes:
+    * node: An initialized struct A7105_Mesh node
+
+    This internal function updates the route table with how far away the
+    sender of the packet in the packet cache is (its hop count + 1), if that's 
+    no farther than we've heard it before (or what we had for it has expired).
+*/
+void _A7105_Mesh_Update_Routes(struct A7105_Mesh* node);
+
+/*
+  _A7105_Mesh_Route_Packet:
+    * node: An initialized struct A7105_Mesh node
+    * packet: A packet we're about to send (with a v2 header)
+
+    This internal function flags a directed packet as routed and cuts its TTL 
+    down to what it takes to get to the target, if we know how far away that is.
+*/
+void _A7105_Mesh_Route_Packet(struct A7105_Mesh* node, byte* packet);
+
+/*
+  _A7105_Mesh_Route_Allows_Repeat:
+    * node: An initialized struct A7105_Mesh node
+    * packet: A received packet we'd otherwise repeat
+
+    Returns: False if the packet is routed and we're too far from its target 
+             for a repeat from us to get there within its TTL. True otherwise.
+*/
+byte _A7105_Mesh_Route_Allows_Repeat(struct A7105_Mesh* node, byte* packet);
+
+/*
+  _A7105_Mesh_Forget_Route:
+    * node: An initialized struct A7105_Mesh node
+    * node_id: The node to forget the distance to
+
+    This internal function drops the route table entry for 'node_id' (if there
+    is one) so packets to it are flooded until we hear from it again.
+*/
+void _A7105_Mesh_Forget_Route(struct A7105_Mesh* node, byte node_id);
+#endif
+
+#ifdef A7105_MESH_LOCATE_REGISTERS
+/*
+  _A7105_Mesh_Target_Register_Request:
+    * node: An initialized struct A7105_Mesh node
+
+    This internal function sends the GET_REGISTER/SET_REGISTER in the packet cache
+    to the node that has the register (and sets the target filters for it), if we
+    know where it is and there's room for the target node ID.
+*/
+void _A7105_Mesh_Target_Register_Request(struct A7105_Mesh* node);
+
+/*
+  _A7105_Mesh_Update_Register_Locations:
+    * node: An initialized struct A7105_Mesh node
+
+    This internal function remembers the sender of the REGISTER_VALUE/SET_REGISTER_ACK
+    in the packet cache as the node that has the register we asked for (the one in 
+    the pending request cache).
+*/
+void _A7105_Mesh_Update_Register_Locations(struct A7105_Mesh* node);
+
+/*
+  _A7105_Mesh_Retry_Register_Request:
+    * node: An initialized struct A7105_Mesh node
+
+    This internal function forgets where the register in a timed out targeted 
+    GET_REGISTER/SET_REGISTER (the pending request cache) is and sends it again 
+    to the whole mesh.
+
+    Returns: True if it sent the request again, false if the request wasn't targeted.
+*/
+byte _A7105_Mesh_Retry_Register_Request(struct A7105_Mesh* node);
+#endif
+
+#ifdef A7105_MESH_REVERSE_PATH
+/*
+  _A7105_Mesh_Remember_Reverse_Path:
+    * node: An initialized struct A7105_Mesh node
+    * packet: A request we're repeating
+
+    This internal function remembers that we repeated 'packet' (if it's a request
+    with a response we can pick out) so we repeat the response to it too.
+*/
+void _A7105_Mesh_Remember_Reverse_Path(struct A7105_Mesh* node, byte* packet);
+
+/*
+  _A7105_Mesh_Reverse_Path_Allows_Repeat:
+    * node: An initialized struct A7105_Mesh node
+    * packet: A received packet we'd otherwise repeat
+
+    Returns: False if the packet is a response to a request we didn't repeat 
+             (in the last A7105_MESH_REVERSE_PATH_TIMEOUT). True otherwise.
+*/
+byte _A7105_Mesh_Reverse_Path_Allows_Repeat(struct A7105_Mesh* node, byte* packet);
+#endif
+
+/*
+  _A7105_Mesh_Is_Handled_Request:
+    * node: An initialized struct A7105_Mesh node
+    * packet: The packet to check (the header is enough)
+
+    Returns true if we've already handled the request in 'packet' (same sender
+    unique ID, header version and sequence number), false otherwise. This is a hash
+    lookup so it's safe from the RX ring filter (interrupt context).
+*/
+byte _A7105_Mesh_Is_Handled_Request(struct A7105_Mesh* node, byte* packet);
+
 
 /*
   _A7105_Mesh_Prep_Finishing_Callback:
@@ -849,12 +1330,76 @@ void _A7105_Mesh_Prep_Finishing_Callback(struct A7105_Mesh* node,
   _A7105_Mesh_Handle_RX:
     * node: An initialized struct A7105_Mesh node
 
-  This internal function checks for and processes received packets.
+  This internal function checks for and processes received packets
+  (everything waiting in the RX ring, unless one of them makes us send).
+  Without the ring, a packet that comes in while ours waits out a CSMA
+  backoff is set aside and processed once ours is out.
   It is the central hub for calling all the packet-specific handler
-  functions.
+  functions (see _A7105_Mesh_Process_Packet()).
 */
 void _A7105_Mesh_Handle_RX(struct A7105_Mesh* node);
 
+/*
+  _A7105_Mesh_Process_Packet:
+    * node: An initialized struct A7105_Mesh node
+    * length: Bytes received into node->packet_cache
+
+  This internal function runs a whole received packet (in node->packet_cache)
+  through the packet-specific handler functions.
+*/
+void _A7105_Mesh_Process_Packet(struct A7105_Mesh* node, byte length);
+
+/*
+  byte _A7105_Mesh_RX_Ring_Callback:
+    * radio, frame: See A7105_RX_Ring_Begin()
+    * context: The struct A7105_Mesh that owns 'radio'
+
+  This internal function runs in the WTR interrupt for each frame the RX ring
+  takes. It tags tail frames (A7105_MESH_RX_TAIL) and, after the first frame 
+  of a long packet, has the radio listen for the tail (through any frames that 
+  show up before it could have, A7105_MESH_RX_GAP).
+*/
+#ifdef A7105_MESH_RX_RING
+byte _A7105_Mesh_RX_Ring_Callback(struct A7105* radio, struct A7105_RX_Frame* frame, void* context);
+#endif
+
+/*
+  byte _A7105_Mesh_RX_Ring_Filter:
+    * radio, frame: See A7105_RX_Ring_Set_Filter()
+    * context: The struct A7105_Mesh that owns 'radio'
+
+  This internal function runs in the WTR interrupt for each intact frame before
+  the rest of it is read (see A7105_MESH_EARLY_REJECT). The tail of a long packet
+  goes the way of its first frame, first frames are screened with 
+  _A7105_Mesh_Early_Reject().
+*/
+#ifdef A7105_MESH_EARLY_REJECT
+byte _A7105_Mesh_RX_Ring_Filter(struct A7105* radio, struct A7105_RX_Frame* frame, void* context);
+
+/*
+  byte _A7105_Mesh_Early_Reject:
+    * node: An initialized struct A7105_Mesh node
+    * packet: The start of a received packet (length bits still in the type byte)
+    * len: Bytes of 'packet' read so far
+
+  This internal function decides if a packet is worth reading the rest of from 
+  as little of it as it can. It only drops packets that the full trip through 
+  _A7105_Mesh_Process_Packet() would do nothing with: requests already in the handled 
+  packet cache (or directed at another node) that won't be repeated and responses
+  for an operation we aren't running (or from a node we didn't ask) that won't be
+  repeated. Anything that claims our node ID (ID conflicts, joins) is always kept.
+
+  Side-Effects/Notes:
+    This runs in the WTR interrupt and only reads the node. Cache entries are 
+    written with interrupts off so it never sees half of one.
+
+  Returns:
+    A7105_RX_RING_DROP, A7105_RX_RING_KEEP or the number of bytes of the packet it 
+    needs to decide.
+*/
+byte _A7105_Mesh_Early_Reject(struct A7105_Mesh* node, byte* packet, byte len);
+#endif
+
 void _A7105_Mesh_Check_For_Node_ID_Conflict(struct A7105_Mesh* node);
 
 /*
@@ -914,6 +1459,15 @@ byte _A7105_Mesh_Get_Packet_Hop(byte* packet);
 
 void _A7105_Mesh_Set_Packet_Hop(byte* packet, byte hop);
 
+byte _A7105_Mesh_Get_Packet_TTL(byte* packet);
+
+void _A7105_Mesh_Set_Packet_TTL(byte* packet, byte ttl);
+
+byte _A7105_Mesh_Get_Packet_Version(byte* packet);
+
+//Returns the node ID a directed packet is for (0 for packets that aren't directed)
+byte _A7105_Mesh_Get_Packet_Target(byte* packet);
+
 
 byte _A7105_Bit_out(int analogPin); 
 
@@ -48,27 +48,55 @@ POSSIBILITY OF SUCH DAMAGE.
 #define A7105_MESH_PKT_SET_REGISTER        0x0C
 #define A7105_MESH_PKT_SET_REGISTER_ACK    0x0D
 
+//Packet header (v2, see A7105_MESH_PACKET_V2). Packets are always in this 
+//layout inside the library, v1 packets are converted on the way in and out.
 #define A7105_MESH_PACKET_TYPE       0
-#define A7105_MESH_PACKET_HOP_SEQ    1
+#define A7105_MESH_PACKET_HOP_TTL    1
 #define A7105_MESH_PACKET_NODE_ID    2
 #define A7105_MESH_PACKET_UNIQUE_ID  3 //16 bit
-#define A7105_MESH_PACKET_TARGET_ID  5 //Not present in all packets
-#define A7105_MESH_PACKET_DATA_START 5 //byte that starts the register name/value area
-#define A7105_MESH_PACKET_REG_INDEX  6 //byte that has register index for GET_REGISTER_NAME requests
-#define A7105_MESH_PACKET_NAME_START  6 //start index of the name data for GET_REGISTER/SET_REGISTER/REGISTER_NAME packets
-#define A7105_MESH_PACKET_ERR_MSG_START  6 //start index of the error message for SET_REGISTER_ACK packets
+#define A7105_MESH_PACKET_SEQ        5 //8 bit sequence number (used for packet repeat filtering)
+#define A7105_MESH_PACKET_FLAGS      6 //header version and flags
+#define A7105_MESH_PACKET_TARGET_ID  7 //Not present in all packets
+#define A7105_MESH_PACKET_DATA_START 7 //byte that starts the register name/value area
+#define A7105_MESH_PACKET_REG_INDEX  8 //byte that has register index for GET_REGISTER_NAME requests
+#define A7105_MESH_PACKET_NAME_START  8 //start index of the name data for GET_REGISTER/SET_REGISTER/REGISTER_NAME packets
+#define A7105_MESH_PACKET_ERR_MSG_START  8 //start index of the error message for SET_REGISTER_ACK packets
+#define A7105_MESH_PACKET_HEADER_SIZE 7
 
-//The different nibbles in the HOP/SEQ byte of the packet
-//header for the HOP count and Sequence number (used for
-//packet repeat filtering)
+//The different nibbles in the HOP/TTL byte of the packet header for the hop 
+//count (bumped by every repeater) and the TTL (repeaters stop once the hop 
+//count gets to it). The hop count is where v1 has it, so v1 nodes keep 
+//repeating v2 packets properly.
 #define A7105_MESH_PACKET_HOP_MASK 0x0F
-#define A7105_MESH_PACKET_SEQ_MASK 0xF0
+#define A7105_MESH_PACKET_TTL_MASK 0xF0
 
-//Bytes stored for each entry in the handled packet cache
-#define A7105_MESH_HANDLED_PACKET_HEADER_SIZE 4 
-#define A7105_MESH_HANDLED_PACKET_OP 0
-#define A7105_MESH_HANDLED_PACKET_SEQ 1
-#define A7105_MESH_HANDLED_PACKET_UNIQUE_ID 2
+//The different nibbles in the FLAGS byte (header version, flags)
+#define A7105_MESH_PACKET_VERSION_MASK 0xF0
+#define A7105_MESH_PACKET_FLAG_MASK    0x0F
 
+//Flags
+#define A7105_MESH_PACKET_FLAG_ROUTED 0x01 //TTL is cut to the target's distance (see A7105_MESH_ROUTING)
+#define A7105_MESH_PACKET_FLAG_TARGETED 0x02 //GET/SET_REGISTER with the target node ID after the register (see A7105_MESH_LOCATE_REGISTERS)
+
+//Header versions
+//v1: TYPE | HOP/SEQ | NODE_ID | UNIQUE_ID with a 4 bit sequence number in the upper
+//    nibble of HOP/SEQ (see A7105_MESH_V1_PEER_TIMEOUT for when we still send it)
+//v2: the header above, flagged with A7105_MESH_PACKET_V2 in the type byte on the air
+#define A7105_MESH_PACKET_V1 1
+#define A7105_MESH_PACKET_V2 2
+#define A7105_MESH_PACKET_V1_HEADER_SIZE 5
+#define A7105_MESH_PACKET_V1_SEQ_MASK 0xF0
+
+//The top bits of the packet type byte carry the length of the packet
+//(so receivers know if a tail frame follows the first one) and whether
+//it has a v2 header (v1 nodes take these for a packet type they don't know 
+//and leave them alone, other than repeating them). These are only set on the 
+//air; the rest of the library sees plain packet types.
+#define A7105_MESH_PACKET_TYPE_MASK 0x1F
+#define A7105_MESH_PACKET_TYPE_V2   0x20
+#define A7105_MESH_PACKET_LEN_MASK  0xC0
+#define A7105_MESH_PACKET_LEN_16    0x00
+#define A7105_MESH_PACKET_LEN_32    0x40
+#define A7105_MESH_PACKET_LEN_64    0x80
 
 #endif
@@ -0,0 +1,12 @@
+#!/bin/bash
+# Builds the a7105/a7105_mesh libraries on the Linux userspace HAL backend
+# (spidev + GPIO character device, see a7105_hal.h) and the mesh_scan tool.
+# Extra arguments are passed to the compiler.
+cd "$(dirname "$0")"
+mkdir -p build
+${CXX:-g++} -std=gnu++98 -O2 -Wall -DA7105_HAL_LINUX "$@" \
+  -I../libraries/a7105 -I../libraries/a7105_mesh \
+  mesh_scan.cpp \
+  ../libraries/a7105/a7105.cpp ../libraries/a7105/a7105_hal_linux.cpp ../libraries/a7105/a7105_hal_host.cpp \
+  ../libraries/a7105_mesh/a7105_mesh.cpp \
+  -lpthread -o build/mesh_scan
@@ -0,0 +1,98 @@
+/*
+Copyright (C) 2015 Matthew Meno
+
+This file is part of ATmega A7105.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+(1) Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer. 
+
+(2) Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in
+the documentation and/or other materials provided with the
+distribution.  
+
+(3)The name of the author may not be used to
+endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <a7105.h>
+#include <a7105_mesh.h>
+
+/*
+  Runs a mesh node on a Linux box (Raspberry Pi or similar) with the A7105 on a
+  spidev port and its chip select/WTR on GPIO lines (see A7105_HAL_LINUX in
+  a7105_hal.h). It joins the mesh, PINGs it and asks every node that answered
+  how many registers it has.
+
+  Usage: mesh_scan [spidev] [gpiochip] [cs_line] [wtr_line]
+    defaults: /dev/spidev0.0 /dev/gpiochip0 8 25
+
+  Output is one comma delimited line per result: NAME,VALUE (NODE_<id>,<registers>)
+*/
+
+#define RADIO_IDS 0xdb042679 //The ID filter for the current mesh
+
+int main(int argc, char** argv)
+{
+  const char* spidev = (argc > 1) ? argv[1] : A7105_HAL_LINUX_SPIDEV;
+  const char* gpiochip = (argc > 2) ? argv[2] : A7105_HAL_LINUX_GPIOCHIP;
+  int cs_line = (argc > 3) ? atoi(argv[3]) : 8;
+  int wtr_line = (argc > 4) ? atoi(argv[4]) : 25;
+
+  if (!A7105_HAL_Linux_Begin(spidev, gpiochip))
+    return 1;
+
+  struct A7105_Mesh node;
+  A7105_Mesh_Status status = A7105_Mesh_Initialize(&node,
+                                                   cs_line,
+                                                   wtr_line,
+                                                   RADIO_IDS,
+                                                   A7105_DATA_RATE_125Kbps,
+                                                   0,
+                                                   A7105_TXPOWER_150mW,
+                                                   A0);
+  printf("INIT,%d\n", status == A7105_Mesh_STATUS_OK);
+  if (status != A7105_Mesh_STATUS_OK)
+    return 1;
+
+  //Blocking calls (NULL callbacks) are fine here, we have the CPU to ourselves
+  status = A7105_Mesh_Join(&node, NULL);
+  printf("JOIN,%d\n", status == A7105_Mesh_STATUS_OK);
+  printf("NODE_ID,%d\n", node.node_id);
+
+  status = A7105_Mesh_Ping(&node, NULL);
+  printf("PING,%d\n", status == A7105_Mesh_STATUS_OK);
+
+  for (int x = 1; x < 256; x++)
+  {
+    if (x == node.node_id || !(node.presence_table[x/8] & (byte)(1<<(x%8))))
+      continue;
+
+    if (A7105_Mesh_GetNumRegisters(&node, (byte)x, NULL) == A7105_Mesh_STATUS_OK)
+      printf("NODE_%d,%d\n", x, node.num_registers_cache);
+    else
+      printf("NODE_%d,-1\n", x);
+  }
+
+  return 0;
+}